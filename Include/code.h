@@ -66,6 +66,11 @@ typedef struct {
     _PyOpcache *co_opcache;
     int co_opcache_flag;  // used to determine when create a cache.
     unsigned char co_opcache_size;  // length of co_opcache.
+
+    /* The bytecode executed by the interpreter: NULL until the first
+       execution, then either co_code or a copy of co_code with
+       superinstructions. It has the same instruction offsets as co_code. */
+    _Py_CODEUNIT *co_quickened;
 } PyCodeObject;
 
 /* Masks for co_flags above */
@@ -77,7 +77,35 @@ PyAPI_FUNC(int) _PyDict_DelItemId(PyObject *mp, struct _Py_Identifier *key);
 PyAPI_FUNC(void) _PyDict_DebugMallocStats(FILE *out);
 
 int _PyObjectDict_SetItem(PyTypeObject *tp, PyObject **dictptr, PyObject *name, PyObject *value);
+
+/* The __dict__ slot of an instance of a type with Py_TPFLAGS_INLINE_VALUES
+   may hold the attribute values instead of a dict, see Objects/dictobject.c.
+   Such slot values are tagged with the lowest bit. */
+#define _PyDict_IS_INLINE_VALUES(op) (((uintptr_t)(op) & 1) != 0)
+/* Replace the inline values in the slot by a dict. Return a borrowed
+   reference to the dict. */
+PyAPI_FUNC(PyObject *) _PyObject_MaterializeDict(PyObject **dictptr);
+PyAPI_FUNC(Py_ssize_t) _PyInlineValues_GetItemHint(PyObject *, PyObject *,
+                                                   Py_ssize_t, PyObject **);
+PyAPI_FUNC(Py_ssize_t) _PyInlineValues_Size(PyObject *);
+PyAPI_FUNC(PyObject *) _PyInlineValues_AsDict(PyObject *);
+PyAPI_FUNC(int) _PyInlineValues_Traverse(PyObject *, visitproc, void *);
+PyAPI_FUNC(void) _PyInlineValues_Free(PyObject *);
 PyObject *_PyDict_LoadGlobal(PyDictObject *, PyDictObject *, PyObject *);
+PyAPI_FUNC(Py_ssize_t) _PyDict_GetItemHint(PyDictObject *, PyObject *,
+                                           Py_ssize_t, PyObject **);
+
+/* FrozenDict: an immutable, hashable mapping with the layout of a dict.
+   PyDict_Next() and the dict views accept it, the other PyDict functions
+   don't. */
+
+PyAPI_DATA(PyTypeObject) PyFrozenDict_Type;
+
+#define PyFrozenDict_Check(op) PyObject_TypeCheck(op, &PyFrozenDict_Type)
+#define PyFrozenDict_CheckExact(op) (Py_TYPE(op) == &PyFrozenDict_Type)
+
+/* Return a new FrozenDict with the items of mapping, which may be NULL */
+PyAPI_FUNC(PyObject *) PyFrozenDict_New(PyObject *mapping);
 
 /* _PyDictView */
 
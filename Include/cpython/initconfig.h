@@ -117,6 +117,10 @@ typedef struct {
     /* Memory allocator: PYTHONMALLOC env var.
        See PyMemAllocatorName for valid values. */
     int allocator;
+
+    /* Size of the pymalloc arenas in bytes, 0 means the default size:
+       PYTHONMALLOC_ARENA_SIZE env var and "-X arena_size" option. */
+    int arena_size;
 } PyPreConfig;
 
 PyAPI_FUNC(void) PyPreConfig_InitPythonConfig(PyPreConfig *config);
@@ -70,8 +70,17 @@ typedef struct {
 #define _PyGC_PREV_MASK_FINALIZED  (1)
 /* Bit 1 is set when the object is in generation which is GCed currently. */
 #define _PyGC_PREV_MASK_COLLECTING (2)
+#if SIZEOF_VOID_P > 4
+/* Bit 2 marks objects of the oldest generation, which the incremental
+   collector already examined in the current round. It requires 8 byte
+   aligned GC heads and is therefore only available on 64 bit platforms. */
+#define _PyGC_PREV_MASK_VISITED    (4)
+/* The (N-3) most significant bits contain the real address. */
+#define _PyGC_PREV_SHIFT           (3)
+#else
 /* The (N-2) most significant bits contain the real address. */
 #define _PyGC_PREV_SHIFT           (2)
+#endif
 #define _PyGC_PREV_MASK            (((uintptr_t) -1) << _PyGC_PREV_SHIFT)
 
 // Lowest bit of _gc_next is used for flags only in GC.
@@ -79,7 +88,7 @@ typedef struct {
 #define _PyGCHead_NEXT(g)        ((PyGC_Head*)(g)->_gc_next)
 #define _PyGCHead_SET_NEXT(g, p) ((g)->_gc_next = (uintptr_t)(p))
 
-// Lowest two bits of _gc_prev is used for _PyGC_PREV_MASK_* flags.
+// Lowest bits of _gc_prev are used for _PyGC_PREV_MASK_* flags.
 #define _PyGCHead_PREV(g) ((PyGC_Head*)((g)->_gc_prev & _PyGC_PREV_MASK))
 #define _PyGCHead_SET_PREV(g, p) do { \
     assert(((uintptr_t)p & ~_PyGC_PREV_MASK) == 0); \
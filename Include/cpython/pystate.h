@@ -138,6 +138,12 @@ struct _ts {
     /* Unique thread state id. */
     uint64_t id;
 
+    /* The opcode counts of this thread, see sys._opcode_profile() */
+    struct _opcode_profile *opcode_profile;
+
+    /* The pymalloc thread pool cache, see Objects/obmalloc.c */
+    void *obmalloc_pools;
+
     /* XXX signal handlers should also be here */
 
 #ifdef STACKLESS
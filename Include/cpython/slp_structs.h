@@ -137,6 +137,11 @@ typedef struct _slp_tasklet {
     PyObject *profileobj;
     PyObject *traceobj;
     int tracing;
+    /* The number of the first full garbage collection, that found the
+     * tasklet blocked, or 0. Reset to 0, when the tasklet gets unblocked.
+     * Used to park long time blocked tasklets, see Modules/gcmodule.c.
+     */
+    Py_ssize_t gc_blocked_since;
 } PyTaskletObject;
 
 
@@ -27,6 +27,15 @@ typedef struct _sts {
     intptr_t *cstack_base;
     /* stack overflow check and init flag */
     intptr_t *cstack_root;
+    /* adaptive stack spilling, see slp_cstack_save_now() */
+    struct {
+        Py_ssize_t watermark;                   /* current watermark in words, 0: default */
+        Py_ssize_t fixed;                       /* set by stackless.set_stack_gap(), 0: adaptive */
+        Py_ssize_t average;                     /* moving average of saved stack sizes, words * 16 */
+        Py_ssize_t saves;                       /* number of saved C-stacks */
+        Py_ssize_t spills;                      /* number of stack spills */
+        PY_LONG_LONG saved;                     /* total number of saved words */
+    } cstack_gap;
     /* main tasklet */
     struct _slp_tasklet *main;
     /* runnable tasklets */
@@ -78,6 +87,7 @@ typedef struct _sts {
     tstate->st.serial_last_jump = 0; \
     tstate->st.cstack_base = NULL; \
     tstate->st.cstack_root = NULL; \
+    memset(&tstate->st.cstack_gap, 0, sizeof(tstate->st.cstack_gap)); \
     tstate->st.main = NULL; \
     tstate->st.current = NULL; \
     tstate->st.tick_counter = 0; \
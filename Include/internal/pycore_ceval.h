@@ -31,6 +31,14 @@ PyAPI_FUNC(void) _PyEval_ReInitThreads(
 /* Private function */
 void _PyEval_Fini(void);
 
+/* The opcode profiler */
+PyAPI_FUNC(void) _PyEval_CountOpcode(
+    PyThreadState *tstate,
+    PyCodeObject *co,
+    int opcode);
+PyAPI_FUNC(void) _PyEval_ClearOpcodeProfile(PyThreadState *tstate);
+PyAPI_FUNC(PyObject *) _PyEval_OpcodeProfile(PyObject *enable);
+
 #ifdef __cplusplus
 }
 #endif
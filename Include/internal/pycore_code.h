@@ -10,15 +10,33 @@ typedef struct {
     uint64_t builtins_ver; /* ma_version of builtin dict */
 } _PyOpcache_LoadGlobal;
 
+typedef struct {
+    PyTypeObject *type;  /* Cached type (borrowed reference) */
+    Py_ssize_t hint;  /* >= 0: index in the instance dict,
+                         < -1: inverted offset of a slot */
+    unsigned int tp_version_tag;  /* tp_version_tag of type */
+} _PyOpcache_LoadAttr;
+
+typedef struct {
+    PyTypeObject *type;  /* Cached type (borrowed reference) */
+    PyObject *meth;  /* Cached unbound method (borrowed reference) */
+    unsigned int tp_version_tag;  /* tp_version_tag of type */
+} _PyOpcache_LoadMethod;
+
 struct _PyOpcache {
     union {
         _PyOpcache_LoadGlobal lg;
+        _PyOpcache_LoadAttr la;
+        _PyOpcache_LoadMethod lm;
     } u;
     char optimized;
 };
 
 /* Private API */
 int _PyCode_InitOpcache(PyCodeObject *co);
+void _PyCode_Quicken(PyCodeObject *co);
+Py_ssize_t _PyCode_FuseSuperinstructions(_Py_CODEUNIT *codestr,
+                                         Py_ssize_t codelen);
 
 
 #ifdef __cplusplus
@@ -23,6 +23,9 @@ struct _pycontextvarobject {
     PyObject *var_cached;
     uint64_t var_cached_tsid;
     uint64_t var_cached_tsver;
+#ifdef STACKLESS
+    uint64_t var_cached_hamtver;
+#endif
     Py_hash_t var_hash;
 };
 
@@ -23,6 +23,9 @@ typedef struct {
     PyHamtNode *h_root;
     PyObject *h_weakreflist;
     Py_ssize_t h_count;
+#ifdef STACKLESS
+    uint64_t h_ver;  /* unique for each HAMT, see PyContextVar_Get() */
+#endif
 } PyHamtObject;
 
 
@@ -109,8 +109,49 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* total time spent collecting this generation */
+    _PyTime_t duration;
+    /* total number of tuples and dicts untracked before the collections */
+    Py_ssize_t untracked;
+    /* total number of tuples and dicts examined, which stayed tracked */
+    Py_ssize_t kept;
 };
 
+/* Number of buckets of the slice pause histogram. The bounds of the buckets
+   are defined in Modules/gcmodule.c */
+#define GC_SLICE_PAUSE_BUCKETS 11
+
+/* Running stats of the incremental collection of the oldest generation.
+   See the comment on collect_increment() in Modules/gcmodule.c */
+struct gc_incremental_stats {
+    /* total number of slices */
+    Py_ssize_t slices;
+    /* number of slices, which reached the size limit of the increment */
+    Py_ssize_t truncated;
+    /* number of completed rounds over the oldest generation */
+    Py_ssize_t rounds;
+    /* number of full collections done instead of a slice */
+    Py_ssize_t fallbacks;
+    /* total number of objects collected by slices */
+    Py_ssize_t collected;
+    /* histogram of the slice pauses */
+    Py_ssize_t pauses[GC_SLICE_PAUSE_BUCKETS];
+};
+
+#ifdef STACKLESS
+/* Running stats of the parked generation. See the comment on
+   park_blocked_tasklets() in Modules/gcmodule.c */
+struct gc_parked_stats {
+    /* total number of tasklets moved into the parked generation */
+    Py_ssize_t tasklets;
+    /* total number of frames moved into the parked generation */
+    Py_ssize_t frames;
+    /* number of times the parked generation was merged back into the
+       oldest generation */
+    Py_ssize_t merges;
+};
+#endif
+
 struct _gc_runtime_state {
     /* List of objects that still need to be cleaned up, singly linked
      * via their gc headers' gc_prev pointers.  */
@@ -126,6 +167,42 @@ struct _gc_runtime_state {
     /* a permanent generation which won't be collected */
     struct gc_generation permanent_generation;
     struct gc_generation_stats generation_stats[NUM_GENERATIONS];
+#ifdef STACKLESS
+    /* a generation for long time blocked tasklets and their frames, which
+       is only collected on request or if it grows beyond park_limit */
+    struct gc_generation parked_generation;
+    struct gc_parked_stats parked_stats;
+    /* number of full collections a tasklet must stay blocked, before it
+       gets parked. 0 disables parking. */
+    int park_threshold;
+    /* upper limit for parked_pending. 0 means no limit. */
+    Py_ssize_t park_limit;
+    /* number of objects parked since the parked generation was merged
+       back into the oldest generation */
+    Py_ssize_t parked_pending;
+#endif
+    /* time budget of a slice of the incremental collection of the oldest
+       generation. 0 disables incremental collection. */
+    _PyTime_t incremental_budget;
+    /* estimated time per object of a slice, used to size the increments */
+    _PyTime_t incremental_ns_per_object;
+    /* value of the _PyGC_PREV_MASK_VISITED bit of visited objects. It gets
+       flipped at the end of each round. */
+    int visited_space;
+    /* true while collect() examines an increment */
+    int incremental_slice;
+    /* true if an increment of the current round reached its size limit */
+    int incremental_truncated;
+    /* true if the next slice is replaced by a full collection */
+    int incremental_fallback;
+    /* number of objects, which survived the slices of the current round */
+    Py_ssize_t incremental_survivors;
+    /* number of objects moved into the oldest generation since the last
+       slice */
+    Py_ssize_t incremental_promoted;
+    /* holds the rest of the oldest generation during a slice */
+    PyGC_Head incremental_rest;
+    struct gc_incremental_stats incremental_stats;
     /* true if we are currently running the collector */
     int collecting;
     /* list of uncollectable objects */
@@ -188,6 +265,25 @@ PyAPI_FUNC(int) _PyMem_GetAllocatorName(
    PYMEM_ALLOCATOR_NOT_SET does nothing. */
 PyAPI_FUNC(int) _PyMem_SetupAllocators(PyMemAllocatorName allocator);
 
+/* Set the size of the pymalloc arenas in bytes, 0 selects the default size.
+   The size must be a power of two between 256 KiB and 32 MiB and can only
+   be changed while no arena is allocated.  Return 0 on success, -1 if
+   the size is invalid or -2 if arenas of another size are allocated. */
+PyAPI_FUNC(int) _PyObject_SetArenaSize(size_t size);
+
+/* Thread pool caches of pymalloc, see Objects/obmalloc.c.
+   All functions must be called with the GIL held.  '*cache_p' is the
+   cache of a thread state, it is created on demand. */
+
+/* Make the cache of the current thread the one used for allocations. */
+PyAPI_FUNC(void) _PyObject_SwitchThreadPools(void **cache_p);
+
+/* Return the pools of a cache to the shared lists and free the cache. */
+PyAPI_FUNC(void) _PyObject_ClearThreadPools(void **cache_p);
+
+/* Return the pools of the caches of all other threads to the shared lists. */
+PyAPI_FUNC(void) _PyObject_ReturnIdleThreadPools(void);
+
 #ifdef __cplusplus
 }
 #endif
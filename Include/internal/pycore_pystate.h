@@ -61,6 +61,16 @@ struct _ceval_runtime_state {
     /* Request for checking signals. */
     _Py_atomic_int signals_pending;
     struct _gil_runtime_state gil;
+    /* Non-zero, if the opcode profiler is on. A running profiler holds
+       one count of tracing_possible. */
+    int opcode_profile;
+    /* The opcode counts of threads, that terminated while profiling */
+    struct _opcode_profile *opcode_profile_exited;
+#ifdef STACKLESS
+    /* Request for a sample of the Stackless profiler.
+       Set by the profiler signal handler. */
+    _Py_atomic_int profiler_sample_pending;
+#endif
 };
 
 /* interpreter state */
@@ -740,6 +740,15 @@ int slp_schedule_callback(PyTaskletObject *prev, PyTaskletObject *next);
 void slp_set_profile(Py_tracefunc func, PyObject *arg);
 void slp_set_trace(Py_tracefunc func, PyObject *arg);
 
+/* sampling profiler */
+PyObject * slp_init_profiler(void);
+void slp_profiler_fini(void);
+void slp_profiler_take_sample(PyThreadState *ts);
+
+/* soft switchable sorted() and filter() */
+int slp_list_sort_with_keys(PyObject *list, PyObject *keylist, int reverse);
+int slp_init_bltin_declarations(PyObject *module, PyModuleDef *module_def);
+
 /* Stackless extension for types */
 int slp_prepare_slots(PyTypeObject*);
 
@@ -829,6 +838,12 @@ slp_cstack_set_root(PyThreadState *tstate, const void * pstackvar);
 #define SLP_CSTACK_SET_ROOT(tstate, stackvar) slp_cstack_set_root((tstate), &(stackvar))
 PyObject *
 slp_cstack_set_base_and_goodgap(PyThreadState *tstate, const void * pstackvar, PyFrameObject *f);
+void
+slp_cstack_gap_note_save(PyThreadState *tstate, Py_ssize_t size);
+Py_ssize_t
+slp_cstack_get_watermark(PyThreadState *tstate);
+Py_ssize_t
+slp_cstack_clamp_watermark(Py_ssize_t watermark);
 
 
 
@@ -282,6 +282,12 @@ Code can use PyType_HasFeature(type_ob, flag_value) to test whether the
 given type object has a specified feature.
 */
 
+#ifndef Py_LIMITED_API
+/* Set if the __dict__ slot of instances may hold the attribute values
+   instead of a dict. See Objects/dictobject.c */
+#define Py_TPFLAGS_INLINE_VALUES (1UL << 4)
+#endif
+
 /* Set if the type object is dynamically allocated */
 #define Py_TPFLAGS_HEAPTYPE (1UL << 9)
 
@@ -128,6 +128,10 @@ extern "C" {
 #define CALL_METHOD             161
 #define CALL_FINALLY            162
 #define POP_FINALLY             163
+#define LOAD_FAST_LOAD_FAST     164
+#define LOAD_FAST_LOAD_ATTR     165
+#define STORE_FAST_LOAD_FAST    166
+#define COMPARE_AND_BRANCH      167
 
 /* EXCEPT_HANDLER is a special, implicit block type which is created when
    entering an except handler. It is not an opcode but we define it here
@@ -7,6 +7,7 @@ Unit tests are in test_collections.
 """
 
 from abc import ABCMeta, abstractmethod
+from _collections import FrozenDict as _FrozenDict
 import sys
 
 __all__ = ["Awaitable", "Coroutine",
@@ -689,6 +690,7 @@ class Mapping(Collection):
     __reversed__ = None
 
 Mapping.register(mappingproxy)
+Mapping.register(_FrozenDict)
 
 
 class MappingView(Sized):
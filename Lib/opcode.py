@@ -213,4 +213,17 @@ def_op('CALL_METHOD', 161)
 jrel_op('CALL_FINALLY', 162)
 def_op('POP_FINALLY', 163)
 
+# Superinstructions. The compiler never emits them, the interpreter fuses
+# frequent pairs of instructions in its private copy of the bytecode.
+# A superinstruction has the argument of the first instruction of the pair.
+# COMPARE_AND_BRANCH fuses COMPARE_OP and POP_JUMP_IF_FALSE.
+def_op('LOAD_FAST_LOAD_FAST', 164)
+haslocal.append(164)
+def_op('LOAD_FAST_LOAD_ATTR', 165)
+haslocal.append(165)
+def_op('STORE_FAST_LOAD_FAST', 166)
+haslocal.append(166)
+def_op('COMPARE_AND_BRANCH', 167)
+hascompare.append(167)
+
 del def_op, name_op, jrel_op, jabs_op
@@ -41,6 +41,7 @@ __all__ = ['atomic',
            'enable_softswitch',
            'get_channel_callback',
            'get_schedule_callback',
+           'get_stack_gap_stats',
            'get_thread_info',
            'getcurrent',
            'getcurrentid',
@@ -56,6 +57,7 @@ __all__ = ['atomic',
            'set_channel_callback',
            'set_error_handler',
            'set_schedule_callback',
+           'set_stack_gap',
            'switch_trap',
            'tasklet',
            'stackless',  # ugly
@@ -96,6 +98,70 @@ def _tasklet_get_unpicklable_state(tasklet):
         finally:
             pickle_flags(flags, PICKLEFLAGS_PICKLE_CONTEXT)
 
+class _Profiler(object):
+    """The statistical sampling profiler of Stackless Python
+
+    The profiler periodically samples the frame stack of the current tasklet
+    of any thread. It has no per tasklet state and costs nothing, if it is
+    not running. Use :meth:`sample` to record the stacks of blocked
+    tasklets.
+
+    Note: this class has been added on a provisional basis (see :pep:`411` for details.)
+    """
+    __slots__ = ()
+
+    def start(self, interval=1000, capacity=0):
+        """Start sampling every *interval* microseconds of CPU time"""
+        _stackless._profiler.start(interval, capacity)
+
+    def stop(self):
+        """Stop sampling. The recorded samples are kept"""
+        _stackless._profiler.stop()
+
+    def is_running(self):
+        """Return True, if the profiler is sampling"""
+        return _stackless._profiler.is_running()
+
+    def sample(self, tasklets):
+        """Record the frame stacks of the given tasklets"""
+        _stackless._profiler.sample(tasklets)
+
+    def samples(self):
+        """Return a list of the recorded samples, oldest first
+
+        Each sample is a tuple (thread_id, tasklet_id, on_demand, code_objects).
+        """
+        return _stackless._profiler.samples()
+
+    def clear(self):
+        """Remove all recorded samples"""
+        _stackless._profiler.clear()
+
+    def stats(self):
+        """Return a dictionary with statistics of the profiler"""
+        return _stackless._profiler.stats()
+
+    def collapsed(self, by_tasklet=False, include_on_demand=False):
+        """Return the recorded samples in the "collapsed stack" format
+
+        The result is a list of lines "frame;frame;... count", as expected by
+        flame graph tools. If *by_tasklet* is true, the outermost frame of each
+        stack is the id of the sampled tasklet.
+        """
+        counts = {}
+        for thread_id, tasklet_id, on_demand, codes in self.samples():
+            if on_demand and not include_on_demand:
+                continue
+            names = ["%s (%s:%d)" % (c.co_name, c.co_filename, c.co_firstlineno)
+                     for c in codes]
+            if by_tasklet:
+                names.insert(0, "tasklet-%#x" % (tasklet_id,))
+            key = ";".join(names)
+            counts[key] = counts.get(key, 0) + 1
+        return ["%s %d" % item for item in sorted(counts.items())]
+
+profiler = _Profiler()
+
 def transmogrify():
     """
     this function creates a subclass of the ModuleType with properties.
@@ -56,9 +56,9 @@ def randfloats(n):
 def flush():
     sys.stdout.flush()
 
-def doit(L):
+def doit(L, parallel=False):
     t0 = time.perf_counter()
-    L.sort()
+    L.sort(parallel=parallel)
     t1 = time.perf_counter()
     print("%6.2f" % (t1-t0), end=' ')
     flush()
@@ -72,6 +72,7 @@ def tabulate(r):
     floating point numbers with the following properties:
 
     *sort: random data
+    |sort: random data, sorted with parallel=True
     \sort: descending data
     /sort: ascending data
     3sort: ascending, then 3 random exchanges
@@ -82,7 +83,7 @@ def tabulate(r):
     !sort: worst case scenario
 
     """
-    cases = tuple([ch + "sort" for ch in r"*\/3+%~=!"])
+    cases = tuple([ch + "sort" for ch in r"*|\/3+%~=!"])
     fmt = ("%2s %7s" + " %6s"*len(cases))
     print(fmt % (("i", "2**i") + cases))
     for i in r:
@@ -90,7 +91,10 @@ def tabulate(r):
         L = randfloats(n)
         print("%2d %7d" % (i, n), end=' ')
         flush()
+        P = L[:]
         doit(L) # *sort
+        doit(P, True) # |sort
+        del P
         L.reverse()
         doit(L) # \sort
         doit(L) # /sort
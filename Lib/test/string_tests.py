@@ -266,6 +266,37 @@ class BaseTest:
         # issue #15534
         self.checkequal(0, '<......\u043c...', "rfind", "<")
 
+    def test_find_long(self):
+        # Long haystacks are searched in blocks of characters; put the
+        # match at every position, around the ends of the blocks and in
+        # the tail after the last block.
+        for m in (2, 3, 5, 17, 40):
+            p = 'ab' + 'c' * (m - 3) + 'd' if m > 2 else 'ad'
+            for n in (m + 14, m + 15, m + 16, 70):
+                for i in range(n - m + 1):
+                    s = 'a' * i + p + 'd' * (n - m - i)
+                    self.checkequal(i, s, 'find', p)
+                    self.checkequal(i, s, 'rfind', p)
+                    self.checkequal(1, s, 'count', p)
+                    self.checkequal(-1, s, 'find', p[:-1] + 'x')
+                    self.checkequal(-1, s, 'rfind', 'x' + p[1:])
+                    self.checkequal(i, s + s, 'find', p)
+                    self.checkequal(len(s) + i, s + s, 'rfind', p)
+                    self.checkequal(2, s + s, 'count', p)
+
+        # count() counts matches which do not overlap
+        for n in range(40):
+            self.checkequal(n // 2, 'a' * n, 'count', 'aa')
+            self.checkequal(n // 3, 'a' * n, 'count', 'aaa')
+            k = min(n // 2, 3)
+            self.checkequal('b' * k + 'a' * (n - 2 * k),
+                            'a' * n, 'replace', 'aa', 'b', 3)
+        s = 'xy' * 50 + 'z'
+        self.checkequal(50, s, 'count', 'xy')
+        self.checkequal(['', 'z'], s, 'split', 'xy' * 50)
+        self.checkequal(('xy' * 49, 'xy', 'z'), s, 'rpartition', 'xy')
+        self.checkequal('xyz', s, 'replace', 'xy', '', 49)
+
     def test_index(self):
         self.checkequal(0, 'abcdefghiabc', 'index', '')
         self.checkequal(3, 'abcdefghiabc', 'index', 'def')
@@ -111,6 +111,31 @@ class BinASCIITest(unittest.TestCase):
         # empty strings. TBD: shouldn't it raise an exception instead ?
         self.assertEqual(binascii.a2b_base64(self.type2test(fillers)), b'')
 
+    def test_base64_long(self):
+        # Long data is converted in blocks; check all lengths around the
+        # block sizes and characters to skip at every position
+        table = (b'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz'
+                 b'0123456789+/')
+        data = self.rawdata[-80:]
+        for n in range(80):
+            s = data[:n]
+            expected = bytearray()
+            for i in range(0, n, 3):
+                chunk = s[i:i+3]
+                v = int.from_bytes(chunk.ljust(3, b'\0'), 'big')
+                quad = bytes(table[(v >> k) & 0x3f] for k in (18, 12, 6, 0))
+                expected += quad[:len(chunk) + 1].ljust(4, b'=')
+            expected += b'\n'
+            a = binascii.b2a_base64(self.type2test(s))
+            self.assertEqual(a, expected)
+            self.assertEqual(binascii.a2b_base64(self.type2test(a)), s)
+        a = binascii.b2a_base64(data[:36])
+        for i in range(len(a)):
+            for c in b'\n !\x80':
+                noisy = a[:i] + bytes([c]) + a[i:]
+                self.assertEqual(binascii.a2b_base64(self.type2test(noisy)),
+                                 data[:36])
+
     def test_base64errors(self):
         # Test base64 with invalid padding
         def assertIncorrectPadding(data):
@@ -198,6 +223,31 @@ class BinASCIITest(unittest.TestCase):
 
         self.assertRaises(TypeError, binascii.crc32)
 
+    def test_crc_long(self):
+        # Long data is processed in blocks; compare with a bitwise
+        # computation for lengths around the block sizes
+        def crc32(data, crc):
+            crc ^= 0xffffffff
+            for b in data:
+                crc ^= b
+                for i in range(8):
+                    crc = (crc >> 1) ^ (0xedb88320 if crc & 1 else 0)
+            return crc ^ 0xffffffff
+        def crc_hqx(data, crc):
+            for b in data:
+                crc ^= b << 8
+                for i in range(8):
+                    crc = ((crc << 1) ^ (0x1021 if crc & 0x8000 else 0))
+                    crc &= 0xffff
+            return crc
+        data = self.rawdata * 4
+        for n in list(range(0, 150, 7)) + [64, 128, 1000]:
+            b = self.type2test(data[:n])
+            self.assertEqual(binascii.crc32(b, 0x12345678),
+                             crc32(data[:n], 0x12345678))
+            self.assertEqual(binascii.crc_hqx(b, 0x1234),
+                             crc_hqx(data[:n], 0x1234))
+
     def test_hqx(self):
         # Perform binhex4 style RLE-compression
         # Then calculate the hexbin4 binary-to-ASCII translation
@@ -240,6 +290,23 @@ class BinASCIITest(unittest.TestCase):
         self.assertEqual(binascii.hexlify(self.type2test(s)), t)
         self.assertEqual(binascii.unhexlify(self.type2test(t)), u)
 
+    def test_hex_long(self):
+        # Long data is converted in blocks; check all lengths around the
+        # block sizes and a bad digit at every position
+        data = self.rawdata[-80:]
+        for n in range(80):
+            s = data[:n]
+            t = ''.join('%02x' % c for c in s).encode('ascii')
+            self.assertEqual(binascii.hexlify(self.type2test(s)), t)
+            self.assertEqual(binascii.unhexlify(self.type2test(t)), s)
+            self.assertEqual(binascii.unhexlify(self.type2test(t.upper())), s)
+        t = binascii.hexlify(data[:40])
+        for i in range(len(t)):
+            for c in b'/:@G`g\x80 ':
+                bad = t[:i] + bytes([c]) + t[i+1:]
+                self.assertRaises(binascii.Error, binascii.a2b_hex,
+                                  self.type2test(bad))
+
     def test_hex_separator(self):
         """Test that hexlify and b2a_hex are binary versions of bytes.hex."""
         # Logic of separators is tested in test_bytes.py.  This checks that
@@ -492,6 +492,16 @@ class BaseBytesTest:
         seq = [b"abc"] * 1000
         expected = b"abc" + b".:abc" * 999
         self.assertEqual(dot_join(seq), expected)
+        # Items and separators of all short lengths
+        seq = [bytes(range(65, 65 + n)) for n in range(35)]
+        for n in range(18):
+            sep = b"-" * n
+            expected = b""
+            for i, item in enumerate(seq):
+                expected += sep + item if i else item
+            self.assertEqual(self.type2test(sep).join(seq), expected)
+            self.assertEqual(self.type2test(sep).join(seq[::-1]),
+                             sep.join(reversed(seq)))
         self.assertRaises(TypeError, self.type2test(b" ").join, None)
         # Error handling and cleanup when some item in the middle of the
         # sequence has the wrong type.
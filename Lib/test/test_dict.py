@@ -793,6 +793,35 @@ class DictTest(unittest.TestCase):
         resizing = True
         d[9] = 6
 
+    def test_large_table(self):
+        # Tables with more than 2**16 slots probe groups of slots.  Check
+        # lookups after deletions, with colliding hashes and non-str keys.
+        class Collide(str):
+            def __hash__(self):
+                return 42
+        n = 30000
+        for make_key in (str, lambda i: i << 20, lambda i: (i,)):
+            keys = [make_key(i) for i in range(n)]
+            d = dict.fromkeys(keys, 0)
+            for k in keys[::3]:
+                del d[k]
+            for k in keys[1::3]:
+                d.pop(k)
+            for i, k in enumerate(keys):
+                self.assertEqual(k in d, i % 3 == 2)
+            for k in keys[::3]:
+                d.setdefault(k, 1)
+            k, v = d.popitem()
+            self.assertEqual(v, 1)
+            self.assertNotIn(k, d)
+            self.assertEqual(d.copy(), d)
+            self.assertEqual(len(d), n - n // 3 - 1)
+        d = {Collide(i): i for i in range(n, n + 100)}
+        d.update((str(i), i) for i in range(n))
+        for i in range(n, n + 100):
+            self.assertEqual(d[Collide(i)], i)
+        self.assertNotIn(Collide(-1), d)
+
     def test_empty_presized_dict_in_freelist(self):
         # Bug #3537: if an empty but presized dict with a size larger
         # than 7 was in the freelist, it triggered an assertion failure
@@ -1042,6 +1071,82 @@ class DictTest(unittest.TestCase):
         a.a = 3
         self.assertFalse(_testcapi.dict_hassplittable(a.__dict__))
 
+    @support.cpython_only
+    def test_inline_values(self):
+        """instances keep their attributes inline until __dict__ is used"""
+        import _testcapi
+
+        class C:
+            pass
+        def has_dict(obj):
+            return any(type(r) is dict for r in gc.get_referents(obj))
+
+        a, b = C(), C()
+        a.x, a.y = 1, 2
+        b.x, b.y = 3, [4]
+        self.assertFalse(has_dict(a))
+        self.assertFalse(has_dict(b))
+        self.assertEqual((a.x, a.y, b.x, b.y), (1, 2, 3, [4]))
+        self.assertEqual(getattr(b, 'z', 5), 5)
+        b.x = 6
+        self.assertEqual(b.x, 6)
+        self.assertFalse(has_dict(b))
+
+        # Pickling copies the attributes
+        self.assertEqual(a.__reduce_ex__(2)[2], {'x': 1, 'y': 2})
+        self.assertFalse(has_dict(a))
+
+        # __dict__ creates a split table dict
+        d = a.__dict__
+        self.assertTrue(has_dict(a))
+        self.assertTrue(_testcapi.dict_hassplittable(d))
+        self.assertEqual(d, {'x': 1, 'y': 2})
+        a.z = 3
+        self.assertEqual(d, {'x': 1, 'y': 2, 'z': 3})
+        self.assertEqual(b.__reduce_ex__(2)[2], {'x': 6, 'y': [4]})
+
+        # Attributes in a different order need a dict
+        c = C()
+        c.y = 1
+        self.assertTrue(has_dict(c))
+        c.x = 2
+        self.assertEqual(list(c.__dict__), ['y', 'x'])
+
+        # Attribute loads work for both layouts
+        def get_x(obj):
+            return obj.x
+        e = C()
+        e.x = 7
+        for i in range(2000):
+            self.assertEqual(get_x(e), 7)
+            self.assertEqual(get_x(a), 1)
+        e.__dict__ = {'q': 8}
+        self.assertEqual(e.q, 8)
+        self.assertRaises(AttributeError, get_x, e)
+
+        # __class__ assignment and subclasses
+        class D(C):
+            pass
+        f = D()
+        f.x, f.y = 1, 2
+        self.assertFalse(has_dict(f))
+        f.__class__ = C
+        self.assertEqual((f.x, f.y), (1, 2))
+
+        # Cycles through inline values get collected
+        g = C()
+        g.x = g
+        ref = weakref.ref(g)
+        del g
+        gc.collect()
+        self.assertIsNone(ref())
+
+        # Deleting an attribute needs a dict
+        del b.y
+        self.assertTrue(has_dict(b))
+        self.assertEqual(b.__dict__, {'x': 6})
+        self.assertRaises(AttributeError, getattr, b, 'y')
+
     def test_iterator_pickling(self):
         for proto in range(pickle.HIGHEST_PROTOCOL + 1):
             data = {1:"a", 2:"b", 3:"c"}
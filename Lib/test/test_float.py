@@ -798,6 +798,36 @@ class ReprTestCase(unittest.TestCase):
             self.assertEqual(repr(float(s)), str(float(s)))
             self.assertEqual(repr(float(negs)), str(float(negs)))
 
+    @unittest.skipUnless(getattr(sys, 'float_repr_style', '') == 'short',
+                         "applies only when using short float repr style")
+    @support.requires_IEEE_754
+    def test_short_repr_random(self):
+        # repr() gives the shortest string that rounds to the float and, of
+        # these, the closest one
+        def significant_digits(s):
+            return s.partition('e')[0].replace('.', '').lstrip('-').strip('0')
+
+        rand = random.Random(1729)
+        values = [ldexp(1.0, e) for e in range(-1074, 1024)]
+        values += [1e23, 5e-324, sys.float_info.max, sys.float_info.min]
+        for i in range(5000):
+            bits = rand.getrandbits(63)
+            values.append(struct.unpack('<d', struct.pack('<Q', bits))[0])
+        for x in values:
+            if isinf(x) or isnan(x) or x == 0.0:
+                continue
+            r = repr(x)
+            self.assertEqual(float(r), x)
+            digits = significant_digits(r)
+            n = len(digits)
+            # at a power of two the correctly rounded string may be below
+            # the closer lower boundary
+            rounded = format(x, '.%de' % (n - 1))
+            if float(rounded) == x:
+                self.assertEqual(significant_digits(rounded), digits, r)
+            if n > 1:
+                self.assertNotEqual(float(format(x, '.%de' % (n - 2))), x, r)
+
 @support.requires_IEEE_754
 class RoundTestCase(unittest.TestCase):
 
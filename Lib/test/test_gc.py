@@ -437,8 +437,9 @@ class GCTests(unittest.TestCase):
         # That causes the trash cycle to get reclaimed via refcounts falling to
         # 0, thus mutating the trash graph as a side effect of merely asking
         # whether __del__ exists.  This used to (before 2.3b1) crash Python.
-        # Now __getattr__ isn't called.
-        self.assertEqual(gc.collect(), 4)
+        # Now __getattr__ isn't called.  The instance attributes are kept
+        # inline, so there are no instance dicts.
+        self.assertEqual(gc.collect(), 2)
         self.assertEqual(len(gc.garbage), garbagelen)
 
     def test_boom2(self):
@@ -463,9 +464,9 @@ class GCTests(unittest.TestCase):
         # Much like test_boom(), except that __getattr__ doesn't break the
         # cycle until the second time gc checks for __del__.  As of 2.3b1,
         # there isn't a second time, so this simply cleans up the trash cycle.
-        # We expect a, b, a.__dict__ and b.__dict__ (4 objects) to get
-        # reclaimed this way.
-        self.assertEqual(gc.collect(), 4)
+        # We expect a and b (2 objects, their attributes are kept inline) to
+        # get reclaimed this way.
+        self.assertEqual(gc.collect(), 2)
         self.assertEqual(len(gc.garbage), garbagelen)
 
     def test_boom_new(self):
@@ -485,7 +486,7 @@ class GCTests(unittest.TestCase):
         gc.collect()
         garbagelen = len(gc.garbage)
         del a, b
-        self.assertEqual(gc.collect(), 4)
+        self.assertEqual(gc.collect(), 2)
         self.assertEqual(len(gc.garbage), garbagelen)
 
     def test_boom2_new(self):
@@ -507,7 +508,7 @@ class GCTests(unittest.TestCase):
         gc.collect()
         garbagelen = len(gc.garbage)
         del a, b
-        self.assertEqual(gc.collect(), 4)
+        self.assertEqual(gc.collect(), 2)
         self.assertEqual(len(gc.garbage), garbagelen)
 
     def test_get_referents(self):
@@ -737,13 +738,18 @@ class GCTests(unittest.TestCase):
     def test_get_stats(self):
         stats = gc.get_stats()
         self.assertEqual(len(stats), 3)
-        for st in stats:
+        for i, st in enumerate(stats):
             self.assertIsInstance(st, dict)
-            self.assertEqual(set(st),
-                             {"collected", "collections", "uncollectable"})
+            keys = {"collected", "collections", "uncollectable", "time",
+                    "untracked", "kept"}
+            if i == 2:
+                keys |= {"slices", "truncated", "rounds", "fallbacks",
+                         "slice_collected", "slice_pauses"}
+            self.assertEqual(set(st), keys)
             self.assertGreaterEqual(st["collected"], 0)
             self.assertGreaterEqual(st["collections"], 0)
             self.assertGreaterEqual(st["uncollectable"], 0)
+            self.assertGreaterEqual(st["time"], 0.0)
         # Check that collection counts are incremented correctly
         if gc.isenabled():
             self.addCleanup(gc.enable)
@@ -760,12 +766,90 @@ class GCTests(unittest.TestCase):
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"] + 1)
 
+    @cpython_only
+    def test_untrack_young(self):
+        # Collections of the youngest generation untrack tuples and small
+        # dicts, which can't be part of a reference cycle.
+        if gc.isenabled():
+            self.addCleanup(gc.enable)
+            gc.disable()
+        gc.collect()
+        t = tuple([1, "a"])
+        d = {"t": t}
+        big = {i: t for i in range(100)}
+        kept = {"l": []}
+        self.assertTrue(gc.is_tracked(t))
+        self.assertTrue(gc.is_tracked(d))
+        self.assertTrue(gc.is_tracked(big))
+        old = gc.get_stats()[0]
+        gc.collect(0)
+        new = gc.get_stats()[0]
+        self.assertFalse(gc.is_tracked(t))
+        self.assertFalse(gc.is_tracked(d))
+        self.assertTrue(gc.is_tracked(big))
+        self.assertTrue(gc.is_tracked(kept))
+        self.assertGreaterEqual(new["untracked"], old["untracked"] + 2)
+        self.assertGreaterEqual(new["kept"], old["kept"] + 1)
+        # Large dicts are only untracked by full collections
+        gc.collect(1)
+        self.assertTrue(gc.is_tracked(big))
+        gc.collect()
+        self.assertFalse(gc.is_tracked(big))
+
     def test_freeze(self):
         gc.freeze()
         self.assertGreater(gc.get_freeze_count(), 0)
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    def test_set_incremental(self):
+        old = gc.get_incremental()
+        self.addCleanup(gc.set_incremental, old)
+        self.assertEqual(old, 0.0)
+        self.assertRaises(ValueError, gc.set_incremental, -1)
+        self.assertRaises(TypeError, gc.set_incremental, "1")
+        try:
+            gc.set_incremental(2.5)
+        except NotImplementedError:
+            self.skipTest("incremental collection is not supported")
+        self.assertEqual(gc.get_incremental(), 2.5)
+        gc.set_incremental(0)
+        self.assertEqual(gc.get_incremental(), 0.0)
+
+    def test_incremental_collection(self):
+        try:
+            gc.set_incremental(0.1)
+        except NotImplementedError:
+            self.skipTest("incremental collection is not supported")
+        self.addCleanup(gc.set_incremental, 0)
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        gc.collect()
+        gc.set_threshold(100, 1, 1)
+        old = gc.get_stats()[2]
+        # move a garbage cycle into the oldest generation
+        collected = []
+        c = C1055820(666)
+        wr = weakref.ref(c, lambda ignored: collected.append(True))
+        gc.collect(0)
+        gc.collect(1)
+        self.assertTrue(any(c is o for o in gc.get_objects(generation=2)))
+        del c
+        live = []
+        for i in range(200000):
+            live.append([])
+            if collected:
+                break
+        self.assertTrue(collected)
+        new = gc.get_stats()[2]
+        self.assertGreater(new["slices"], old["slices"])
+        self.assertGreater(new["slice_collected"], old["slice_collected"])
+        self.assertEqual(sum(new["slice_pauses"].values()), new["slices"])
+        self.assertEqual(max(new["slice_pauses"]), float("inf"))
+        self.assertTrue(all(l == [] for l in live))
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -911,8 +995,8 @@ class GCCallbackTests(unittest.TestCase):
     @cpython_only
     def test_collect_garbage(self):
         self.preclean()
-        # Each of these cause four objects to be garbage: Two
-        # Uncolectables and their instance dicts.
+        # Each of these cause two objects to be garbage: Two
+        # Uncolectables, which keep their attributes inline.
         Uncollectable()
         Uncollectable()
         C1055820(666)
@@ -922,7 +1006,7 @@ class GCCallbackTests(unittest.TestCase):
                 continue
             info = v[2]
             self.assertEqual(info["collected"], 2)
-            self.assertEqual(info["uncollectable"], 8)
+            self.assertEqual(info["uncollectable"], 4)
 
         # We should now have the Uncollectables in gc.garbage
         self.assertEqual(len(gc.garbage), 4)
@@ -939,7 +1023,7 @@ class GCCallbackTests(unittest.TestCase):
                 continue
             info = v[2]
             self.assertEqual(info["collected"], 0)
-            self.assertEqual(info["uncollectable"], 4)
+            self.assertEqual(info["uncollectable"], 2)
 
         # Uncollectables should be gone
         self.assertEqual(len(gc.garbage), 0)
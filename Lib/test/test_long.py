@@ -12,6 +12,8 @@ SHIFT = sys.int_info.bits_per_digit
 BASE = 2 ** SHIFT
 MASK = BASE - 1
 KARATSUBA_CUTOFF = 70   # from longobject.c
+TOOM3_CUTOFF = 250      # from longobject.c
+BURNIKEL_ZIEGLER_CUTOFF = 100   # from longobject.c
 
 # Max number of base BASE digits to use in test cases.  Doubling
 # this will more than double the runtime.
@@ -204,6 +206,22 @@ class LongTest(unittest.TestCase):
         self.check_division(710031681576388032, 26769404391308)
         self.check_division(1933622614268221, 30212853348836)
 
+    def test_division_recursive(self):
+        # Divisors and quotients with more than BURNIKEL_ZIEGLER_CUTOFF
+        # digits use recursive division.
+        cutoff = BURNIKEL_ZIEGLER_CUTOFF
+        digits = [cutoff - 1, cutoff + 1, cutoff + 2, 2 * cutoff + 1,
+                  4 * cutoff + 3, 9 * cutoff]
+        for leny in digits:
+            y = self.getran(leny)
+            for lenq in digits:
+                self.check_division(self.getran(leny + lenq), y)
+                # quotient digits of BASE - 1, and the largest remainder
+                q = BASE**lenq - 1
+                self.check_division(q * y + y - 1, y)
+                self.check_division(q * y - y + 1, y)
+                self.check_division((q << (leny * SHIFT)) + y - 1, y)
+
 
 
     def test_karatsuba(self):
@@ -229,6 +247,36 @@ class LongTest(unittest.TestCase):
                          1)
                     self.assertEqual(x, y)
 
+    def test_toom_cook(self):
+        cutoff = TOOM3_CUTOFF
+        digits = [(cutoff + 1, cutoff + 1), (cutoff + 1, cutoff + 2),
+                  (cutoff + 2, 3 * cutoff // 2), (2 * cutoff + 1,) * 2,
+                  (2 * cutoff + 2, 3 * cutoff + 2), (7 * cutoff,) * 2,
+                  (7 * cutoff, 10 * cutoff)]
+        for adigits, bdigits in digits:
+            abits = adigits * SHIFT
+            bbits = bdigits * SHIFT
+            with self.subTest(abits=abits, bbits=bbits):
+                # as in test_karatsuba
+                a = (1 << abits) - 1
+                b = (1 << bbits) - 1
+                self.assertEqual(a * b, (1 << (abits + bbits)) -
+                                        (1 << abits) - (1 << bbits) + 1)
+                self.assertEqual(a * a, (1 << (2 * abits)) -
+                                        (1 << (abits + 1)) + 1)
+                # compare with multiplications by single digits
+                x = self.getran(adigits)
+                y = self.getran(bdigits)
+                expected = 0
+                for i in range(bdigits):
+                    d = (abs(y) >> (i * SHIFT)) & MASK
+                    expected += (abs(x) * d) << (i * SHIFT)
+                if (x < 0) != (y < 0):
+                    expected = -expected
+                self.assertEqual(x * y, expected)
+                self.assertEqual(x * x, abs(x) * abs(x))
+                self.assertEqual((x * y) // y, x)
+
     def check_bitop_identities_1(self, x):
         eq = self.assertEqual
         with self.subTest(x=x):
@@ -321,6 +369,38 @@ class LongTest(unittest.TestCase):
                 x = self.getran(lenx)
                 self.check_format_1(x)
 
+    def test_format_huge(self):
+        # Conversions of ints with thousands of digits split them at powers
+        # of 10; compare with a quadratic conversion in chunks of 9 digits.
+        def from_digits(s):
+            x = 0
+            for i in range(len(s) % 9 or 9, len(s) + 9, 9):
+                x = x * 10**9 + int(s[max(i - 9, 0):i])
+            return x
+
+        rand = random.Random(43)
+        sizes = list(range(1300, 1400, 7)) + list(range(2600, 2800, 7))
+        sizes.extend([5000, 20000, 60000])
+        for n in sizes:
+            digits = ''.join(rand.choice('0123456789') for i in range(n - 1))
+            for s in ('1' + '0' * (n - 1), '9' * n,
+                      '5' + '0' * (n // 2) + '7' * (n - n // 2 - 1),
+                      rand.choice('123456789') + digits):
+                with self.subTest(n=n, s=s[:20]):
+                    x = from_digits(s)
+                    self.assertEqual(int(s), x)
+                    self.assertEqual(int('-' + s), -x)
+                    self.assertEqual(str(x), s)
+                    self.assertEqual(str(-x), '-' + s)
+                    self.assertEqual(int('0' * 100 + s), x)
+                    self.assertEqual(int(' ' + '_'.join(s) + ' '), x)
+        s = '12' * 2000
+        self.assertRaises(ValueError, int, s + '_')
+        self.assertRaises(ValueError, int, s + '__1')
+        self.assertRaises(ValueError, int, s + 'a')
+        self.assertRaises(ValueError, int, '0' + s, 0)
+        self.assertEqual(int('0' * 5000, 0), 0)
+
     def test_long(self):
         # Check conversions from string
         LL = [
@@ -463,6 +463,29 @@ class PyBytesIOTest(MemoryTestMixin, MemorySeekTestMixin, unittest.TestCase):
         memio.close()
         self.assertRaises(ValueError, memio.getbuffer)
 
+    def test_writelines_bytes(self):
+        # A list or tuple of bytes is written at once.
+        lines = [b'%d' % i * (i % 20) for i in range(100)]
+        memio = self.ioclass(b'0123456789')
+        memio.seek(5)
+        memio.writelines(lines)
+        self.assertEqual(memio.getvalue(), b'01234' + b''.join(lines))
+        value = bytearray(memio.getvalue())
+        value[3:7] = b'abcd'
+        memio.seek(3)
+        memio.writelines((b'ab', b'', b'cd'))
+        self.assertEqual(memio.getvalue(), value)
+        memio.seek(len(value) + 3)
+        memio.writelines([b'x', b'yz'])
+        self.assertEqual(memio.getvalue(), value + b'\0\0\0xyz')
+        self.assertEqual(memio.tell(), len(value) + 6)
+        memio.writelines([b'', b''])
+        self.assertEqual(memio.getvalue(), value + b'\0\0\0xyz')
+        # Items of other types are written as before.
+        memio = self.ioclass()
+        memio.writelines([b'a', bytearray(b'b'), memoryview(b'c'), b'd'])
+        self.assertEqual(memio.getvalue(), b'abcd')
+
     def test_read1(self):
         buf = self.buftype("1234567890")
         self.assertEqual(self.ioclass(buf).read1(), buf)
@@ -788,6 +811,25 @@ class CBytesIOTest(PyBytesIOTest):
             memio.write(b'foo')
         self._test_cow_mutation(mutation)
 
+    @support.cpython_only
+    def test_cow_writelines(self):
+        # Ensure writelines that would not cause a resize results in a copy.
+        def mutation(memio):
+            memio.seek(0)
+            memio.writelines([b'foo', b'bar'])
+        self._test_cow_mutation(mutation)
+
+    def test_writelines_exports(self):
+        memio = self.ioclass(b'1234567890')
+        buf = memio.getbuffer()
+        self.assertRaises(BufferError, memio.writelines, [b'x'])
+        self.assertRaises(BufferError, memio.writelines, [b''])
+        memio.writelines([])
+        del buf
+        support.gc_collect()
+        memio.writelines([b'x'])
+        self.assertEqual(memio.getvalue(), b'x234567890')
+
     @support.cpython_only
     def test_cow_setstate(self):
         # __setstate__ should cause buffer to be released.
@@ -349,5 +349,107 @@ class TestBuglets(unittest.TestCase):
             f()
 
 
+class TestSuperinstructions(BytecodeTestCase):
+    # The interpreter fuses instruction pairs in its private copy of the
+    # bytecode. co_code never contains superinstructions.
+
+    SUPERINSTRUCTIONS = ('LOAD_FAST_LOAD_FAST', 'LOAD_FAST_LOAD_ATTR',
+                         'STORE_FAST_LOAD_FAST', 'COMPARE_AND_BRANCH')
+
+    def executed_opnames(self, func, *args):
+        import sys
+        if not hasattr(sys, '_opcode_profile'):
+            self.skipTest('requires sys._opcode_profile()')
+        func(*args)
+        sys._opcode_profile(True)
+        try:
+            func(*args)
+        finally:
+            profile = sys._opcode_profile(False)
+        counts = profile['code'][func.__code__]
+        return {dis.opname[op] for op in counts}
+
+    def test_co_code_unchanged(self):
+        def f(a, b):
+            c = a.real
+            if a < b:
+                return a + b + c
+        code = f.__code__.co_code
+        f(1, 2)
+        self.assertEqual(f.__code__.co_code, code)
+        for name in self.SUPERINSTRUCTIONS:
+            self.assertNotInBytecode(f, name)
+
+    def test_executed(self):
+        def f(a, b):
+            c = a.real
+            if a < b:
+                return a + b + c
+        self.assertEqual(f(1, 2), 4)
+        executed = self.executed_opnames(f, 1, 2)
+        for name in self.SUPERINSTRUCTIONS:
+            self.assertIn(name, executed)
+        self.assertIn('LOAD_ATTR', executed)
+        self.assertIn('POP_JUMP_IF_FALSE', executed)
+
+    def test_jump_to_second_instruction(self):
+        # the loop jumps back to the LOAD_FAST after STORE_FAST
+        def f(n):
+            i = 0
+            while i < n:
+                i = i + 1
+            return i
+        self.assertEqual(f(10), 10)
+        self.assertEqual(f(0), 0)
+
+    def test_unbound_local(self):
+        def f(flag):
+            if flag:
+                a = 1
+            b = 2
+            return a + b
+        self.assertEqual(f(True), 3)
+        self.assertRaisesRegex(UnboundLocalError, "'a'", f, False)
+
+        def g():
+            b = 1
+            return b.real + a.real
+            a = 2
+        self.assertRaisesRegex(UnboundLocalError, "'a'", g)
+
+    def test_traceback_points_to_second_instruction(self):
+        def f(x):
+            return x.missing
+        try:
+            f(1)
+        except AttributeError as e:
+            tb = e.__traceback__.tb_next
+        else:
+            self.fail("AttributeError not raised")
+        instr = [i for i in dis.get_instructions(f)
+                 if i.offset == tb.tb_lasti][0]
+        self.assertEqual(instr.opname, 'LOAD_ATTR')
+
+    def test_tracing_sees_every_line(self):
+        import sys
+        def f():
+            a = 1
+            b = a
+            return b
+        lines = []
+        def tracer(frame, event, arg):
+            if frame.f_code is f.__code__ and event == 'line':
+                lines.append(frame.f_lineno - f.__code__.co_firstlineno)
+            return tracer
+        f()
+        old = sys.gettrace()
+        sys.settrace(tracer)
+        try:
+            f()
+        finally:
+            sys.settrace(old)
+        self.assertEqual(lines, [1, 2, 3])
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -378,6 +378,116 @@ class TestOptimizedCompares(unittest.TestCase):
         self.assertRaises(TypeError, [(1.0, 1.0), (False, "A"), 6].sort)
         self.assertRaises(TypeError, [('a', 1), (1, 'a')].sort)
         self.assertRaises(TypeError, [(1, 'a'), ('a', 1)].sort)
+
+#==============================================================================
+
+class TestRadix(unittest.TestCase):
+    # Random lists of at least 512 small ints, floats or Latin-1 strings are
+    # sorted by a radix sort.  Compare it with the merge sort, which is used
+    # for tuples, including the order of equal, but not identical keys.
+
+    def check(self, L):
+        for reverse in False, True:
+            expected = [x for x, in sorted([(x,) for x in L], reverse=reverse)]
+            actual = sorted(L, reverse=reverse)
+            for a, e in zip(actual, expected):
+                self.assertIs(a, e)
+            indices = sorted(range(len(L)), key=L.__getitem__,
+                             reverse=reverse)
+            self.assertEqual([L[i] for i in indices], expected)
+            for a, e in zip(indices, indices[1:]):
+                if L[a] == L[e]:
+                    self.assertLess(a, e)
+
+    def test_ints(self):
+        rand = random.Random(42)
+        for n in 511, 512, 1000, 10000:
+            self.check([rand.randrange(-2**30 + 1, 2**30) for i in range(n)])
+            self.check([rand.randrange(1000, 1010) + 0 for i in range(n)])
+            self.check([-rand.randrange(1000, 1100) for i in range(n)])
+
+    def test_floats(self):
+        rand = random.Random(42)
+        specials = [0.0, -0.0, 1.0, -1.0, 5e-324, -5e-324, 1e308,
+                    float('inf'), float('-inf')]
+        for n in 511, 512, 1000, 10000:
+            self.check([rand.uniform(-1e6, 1e6) for i in range(n)])
+            self.check([rand.choice(specials) * 1 for i in range(n)])
+        # NaNs are not ordered, so only the merge sort sorts them.
+        L = [rand.random() for i in range(1000)] + [float('nan')]
+        self.assertEqual(len(sorted(L)), len(L))
+
+    def test_strings(self):
+        rand = random.Random(42)
+        for n in 511, 512, 1000, 10000:
+            self.check([''.join(rand.choice('ab\xe9\x00')
+                                for i in range(rand.randrange(8)))
+                        for i in range(n)])
+            self.check(['%x' % rand.getrandbits(rand.randrange(1, 64))
+                        for i in range(n)])
+            self.check(['http://example.com/a/long/common/prefix/%d' %
+                        rand.randrange(1000) for i in range(n)])
+
+#==============================================================================
+
+class TestParallel(unittest.TestCase):
+    # Large enough to be cut into three chunks of 32768 entries.
+    n = 100000
+
+    def check(self, L, **kwargs):
+        expected = sorted(L, **kwargs)
+        for nthreads in 2, 3, True:
+            actual = L[:]
+            actual.sort(parallel=nthreads, **kwargs)
+            self.assertEqual(len(actual), len(expected))
+            for a, e in zip(actual, expected):
+                self.assertIs(a, e)
+
+    def test_types(self):
+        rand = random.Random(42)
+        self.check([rand.randrange(-10**9, 10**9) for i in range(self.n)])
+        self.check([rand.random() for i in range(self.n)])
+        self.check(['%x' % rand.getrandbits(40) for i in range(self.n)])
+
+    def test_structured(self):
+        self.check(list(range(self.n)))
+        self.check(list(range(self.n, 0, -1)))
+        self.check([i % 1000 for i in range(self.n)])
+        self.check([0] * self.n)
+
+    def test_stability(self):
+        rand = random.Random(42)
+        L = [(rand.randrange(100), i) for i in range(self.n)]
+        self.check(L, key=lambda x: x[0])
+        self.check(L, key=lambda x: x[0], reverse=True)
+        self.check(L, key=lambda x: str(x[0]))
+
+    def test_reverse(self):
+        rand = random.Random(42)
+        self.check([rand.randrange(1000) for i in range(self.n)], reverse=True)
+
+    def test_fallback(self):
+        # These keys are compared with Python semantics, under the GIL.
+        rand = random.Random(42)
+        self.check([rand.randrange(1 << 70) for i in range(self.n)])
+        self.check([rand.randrange(1000) for i in range(self.n)] + [0.5])
+        self.check([(rand.randrange(1000),) for i in range(self.n)])
+        self.check(['€%d' % i for i in range(self.n)])
+        self.check([3, 1, 2])
+        self.check([])
+
+    def test_arguments(self):
+        L = [3, 1, 2]
+        for parallel in False, True, 0, 1, 2, 10**100:
+            L.sort(parallel=parallel)
+            self.assertEqual(L, [1, 2, 3])
+        self.assertEqual(sorted(L, parallel=True), [1, 2, 3])
+        self.assertRaises(ValueError, L.sort, parallel=-1)
+        self.assertRaises(ValueError, L.sort, parallel=-10**100)
+        self.assertRaises(TypeError, L.sort, parallel=None)
+        self.assertRaises(TypeError, L.sort, parallel=2.0)
+        self.assertRaises(TypeError, L.sort, parallel='2')
+
 #==============================================================================
 
 if __name__ == "__main__":
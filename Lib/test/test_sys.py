@@ -408,6 +408,53 @@ class SysModuleTest(unittest.TestCase):
         leave_g.set()
         t.join()
 
+    @test.support.cpython_only
+    @test.support.reap_threads
+    def test_opcode_profile(self):
+        import dis
+        import threading
+
+        def f():
+            x = 0
+            for i in range(100):
+                x += i
+            return x
+
+        def thread_func():
+            for i in range(10):
+                f()
+
+        self.addCleanup(sys._opcode_profile, False)
+        self.assertIsNone(sys._opcode_profile(True))
+        f()
+        # the counts of a terminated thread are kept
+        t = threading.Thread(target=thread_func)
+        t.start()
+        t.join()
+        peek = sys._opcode_profile()
+        profile = sys._opcode_profile(False)
+        self.assertIsNone(sys._opcode_profile(False))
+
+        self.assertEqual(set(profile), {"opcodes", "pairs", "code"})
+        opcodes = profile["opcodes"]
+        self.assertEqual(len(opcodes), 256)
+        counts = profile["code"][f.__code__]
+        inplace_add = dis.opmap["INPLACE_ADD"]
+        self.assertEqual(counts[inplace_add], 11 * 100)
+        self.assertGreaterEqual(opcodes[inplace_add], 11 * 100)
+        self.assertGreaterEqual(peek["code"][f.__code__][inplace_add], 1100)
+        pair = (dis.opmap["LOAD_FAST"], inplace_add)
+        self.assertGreaterEqual(profile["pairs"][pair], 11 * 100)
+        # the first opcode of each thread has no predecessor
+        self.assertLessEqual(sum(profile["pairs"].values()), sum(opcodes))
+        self.assertEqual(sum(opcodes),
+                         sum(sum(d.values()) for d in profile["code"].values()))
+
+        # a new profile starts from scratch
+        sys._opcode_profile(True)
+        profile = sys._opcode_profile(False)
+        self.assertNotIn(f.__code__, profile["code"])
+
     def test_attributes(self):
         self.assertIsInstance(sys.api_version, int)
         self.assertIsInstance(sys.argv, list)
@@ -759,6 +806,57 @@ class SysModuleTest(unittest.TestCase):
         # The function has no parameter
         self.assertRaises(TypeError, sys._debugmallocstats, True)
 
+    @unittest.skipUnless(test.support.with_pymalloc(), "requires pymalloc")
+    def test_debugmallocstats_thread_pools(self):
+        # Each thread allocates from its own pymalloc pool cache
+        from test.support.script_helper import assert_python_ok
+        code = textwrap.dedent("""
+            import gc, sys, threading
+            def work():
+                l = [object() for i in range(10000)]
+            threads = [threading.Thread(target=work) for i in range(4)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            gc.collect()
+            sys._debugmallocstats()
+        """)
+        ret, out, err = assert_python_ok('-c', code)
+        stats = {}
+        for line in err.decode('ascii').splitlines():
+            name, sep, value = line.partition('=')
+            if sep and name.startswith('# '):
+                stats[name.strip()] = int(value.replace(',', ''))
+        self.assertGreaterEqual(stats['# thread pool caches created'], 5)
+        self.assertEqual(stats['# thread pool caches current'], 1)
+        self.assertGreater(stats['# thread pool cache switches'], 0)
+        self.assertGreater(stats['# pools returned to shared lists'], 0)
+
+    @unittest.skipUnless(test.support.with_pymalloc(), "requires pymalloc")
+    def test_debugmallocstats_arena_size(self):
+        from test.support.script_helper import (assert_python_ok,
+                                                assert_python_failure)
+        code = 'import sys; sys._debugmallocstats()'
+        ret, out, err = assert_python_ok('-c', code)
+        self.assertIn(b' * 262144 bytes/arena', err)
+        ret, out, err = assert_python_ok('-X', 'arena_size=2M', '-c', code)
+        self.assertIn(b' * 2097152 bytes/arena', err)
+        ret, out, err = assert_python_ok('-c', code,
+                                         PYTHONMALLOC_ARENA_SIZE='1024K')
+        self.assertIn(b' * 1048576 bytes/arena', err)
+        # The command line option has the priority
+        ret, out, err = assert_python_ok('-X', 'arena_size=4194304',
+                                         '-c', code,
+                                         PYTHONMALLOC_ARENA_SIZE='1M')
+        self.assertIn(b' * 4194304 bytes/arena', err)
+
+        for size in ('', 'x', '2G', '-1M', '3M', '128K', '64M'):
+            with self.subTest(size=size):
+                ret, out, err = assert_python_failure(
+                    '-X', 'arena_size=' + size, '-c', 'pass')
+                self.assertIn(b'arena', err)
+
     @unittest.skipUnless(hasattr(sys, "getallocatedblocks"),
                          "sys.getallocatedblocks unavailable on this build")
     def test_getallocatedblocks(self):
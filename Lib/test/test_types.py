@@ -775,6 +775,128 @@ class MappingProxyTests(unittest.TestCase):
         self.assertEqual(copy['key1'], 27)
 
 
+class FrozenDictSubclass(types.FrozenDict):
+    pass
+
+
+class FrozenDictTests(unittest.TestCase):
+    # FrozenDict is specific to Stackless Python
+
+    def test_constructor(self):
+        F = types.FrozenDict
+        self.assertEqual(F(), {})
+        self.assertEqual(F({'x': 1}, y=2), {'x': 1, 'y': 2})
+        self.assertEqual(F([('x', 1), ('y', 2)]), {'x': 1, 'y': 2})
+        self.assertEqual(F(collections.ChainMap({'x': 1}, {'y': 2})),
+                         {'x': 1, 'y': 2})
+        self.assertEqual(list(F(dict.fromkeys('zyx'))), ['z', 'y', 'x'])
+        fd = F(x=1)
+        self.assertIs(F(fd), fd)
+        self.assertIsNot(F(fd, y=2), fd)
+        self.assertRaises(TypeError, F, 10)
+        self.assertRaises(ValueError, F, ['ab', 'c'])
+
+    def test_immutable(self):
+        fd = types.FrozenDict(x=1)
+        with self.assertRaises(TypeError):
+            fd['x'] = 2
+        with self.assertRaises(TypeError):
+            del fd['x']
+        for name in ('clear', 'pop', 'popitem', 'setdefault', 'update'):
+            self.assertFalse(hasattr(fd, name), name)
+        self.assertRaises(TypeError, dict.__setitem__, fd, 'x', 2)
+        self.assertEqual(fd, {'x': 1})
+
+    def test_mapping(self):
+        keys = ['k%d' % i for i in range(1000)]
+        d = dict(zip(keys, range(1000)))
+        fd = types.FrozenDict(d)
+        self.assertEqual(len(fd), 1000)
+        for key, value in d.items():
+            self.assertIn(key, fd)
+            self.assertEqual(fd[key], value)
+        self.assertNotIn('x', fd)
+        self.assertRaises(KeyError, fd.__getitem__, 'x')
+        self.assertEqual(fd.get('k1'), 1)
+        self.assertIsNone(fd.get('x'))
+        self.assertEqual(list(fd), keys)
+        self.assertEqual(list(reversed(fd)), keys[::-1])
+        self.assertEqual(fd.keys(), d.keys())
+        self.assertEqual(list(fd.values()), list(d.values()))
+        self.assertEqual(fd.items(), d.items())
+        self.assertIn(('k1', 1), fd.items())
+        self.assertNotIn(('k1', 2), fd.items())
+        self.assertEqual(dict(fd), d)
+        self.assertEqual({**fd}, d)
+        self.assertIsInstance(fd, collections.abc.Mapping)
+        self.assertNotIsInstance(fd, collections.abc.MutableMapping)
+
+    def test_hash(self):
+        F = types.FrozenDict
+        self.assertEqual(hash(F(x=1, y=2)), hash(F(y=2, x=1)))
+        self.assertNotEqual(hash(F(x=1, y=2)), hash(F(x=2, y=1)))
+        self.assertEqual(hash(F()), hash(F()))
+        self.assertEqual({F(x=1): 'a'}[F(x=1)], 'a')
+        self.assertRaises(TypeError, hash, F(x=[]))
+        self.assertEqual(F(x=1), {'x': 1})
+        self.assertNotEqual(F(x=1), F(x=2))
+        self.assertNotEqual(F(x=1), [('x', 1)])
+
+    def test_copy_pickle(self):
+        import copy
+        fd = types.FrozenDict(x=[1], y='a')
+        self.assertIs(copy.copy(fd), fd)
+        self.assertIs(fd.copy(), fd)
+        deep = copy.deepcopy(fd)
+        self.assertEqual(deep, fd)
+        self.assertIsNot(deep['x'], fd['x'])
+        for proto in range(pickle.HIGHEST_PROTOCOL + 1):
+            with self.subTest(proto=proto):
+                copied = pickle.loads(pickle.dumps(fd, proto))
+                self.assertIs(type(copied), types.FrozenDict)
+                self.assertEqual(copied, fd)
+
+    def test_copy_pickle_subclass(self):
+        import copy
+        fd = FrozenDictSubclass(x=[1])
+        fd.attr = 3
+        copies = [copy.copy(fd), copy.deepcopy(fd)]
+        copies += [pickle.loads(pickle.dumps(fd, proto))
+                   for proto in range(pickle.HIGHEST_PROTOCOL + 1)]
+        for copied in copies:
+            self.assertIs(type(copied), FrozenDictSubclass)
+            self.assertEqual(copied, fd)
+            self.assertEqual(copied.attr, 3)
+        self.assertIsNot(copies[1]['x'], fd['x'])
+
+    def test_subclass(self):
+        class Sub(types.FrozenDict):
+            pass
+        fd = Sub(x=1)
+        self.assertEqual(repr(fd), "Sub({'x': 1})")
+        self.assertIsNot(Sub(fd), fd)
+        self.assertIs(type(fd.copy()), types.FrozenDict)
+        self.assertEqual(fd.copy(), fd)
+
+    def test_gc(self):
+        import gc
+        F = types.FrozenDict
+        self.assertFalse(gc.is_tracked(F(x=1, y='a')))
+        self.assertTrue(gc.is_tracked(F(x=[])))
+        class C:
+            pass
+        c = C()
+        c.fd = F(c=c)
+        ref = weakref.ref(c)
+        del c
+        gc.collect()
+        self.assertIsNone(ref())
+
+    def test_sizeof(self):
+        d = dict.fromkeys(range(1000))
+        self.assertLess(sys.getsizeof(types.FrozenDict(d)), sys.getsizeof(d))
+
+
 class ClassCreationTests(unittest.TestCase):
 
     class Meta(type):
@@ -464,6 +464,18 @@ class UnicodeTest(string_tests.CommonTest,
         self.checkraises(TypeError, ' ', 'join', [1, 2, 3])
         self.checkraises(TypeError, ' ', 'join', ['1', '2', 3])
 
+        # Items and separators of all short lengths and kinds
+        for first in 'a', '\xe9', '\u20ac', '\U0001f40d':
+            seq = [''.join(chr(ord(first) + i) for i in range(n))
+                   for n in range(35)]
+            for n in range(18):
+                for sepchar in '-', first:
+                    sep = sepchar * n
+                    expected = ''
+                    for i, item in enumerate(seq):
+                        expected += sep + item if i else item
+                    self.assertEqual(sep.join(seq), expected)
+
     @unittest.skipIf(sys.maxsize > 2**32,
         'needs too much memory on a 64-bit platform')
     def test_join_overflow(self):
@@ -1735,6 +1747,33 @@ class UnicodeTest(string_tests.CommonTest,
             self.assertRaises(UnicodeDecodeError,
                               (b'\xF4'+cb+b'\xBF\xBF').decode, 'utf-8')
 
+    def test_utf8_decode_long_sequences(self):
+        # Long texts are decoded in blocks, put the sequences at every
+        # position relative to the blocks
+        texts = ['a' * 40, '\xe9' * 20, 'я' * 20, '我' * 14,
+                 '\U0001f600' * 10, 'a\xe9я我\U0001f600' * 4]
+        valid = ['a', '\xff', '߿', 'ࠀ', '￿', '\U00010000',
+                 '\U0010ffff']
+        invalid = [b'\x80', b'\xc0\x80', b'\xc3', b'\xe0\x9f\xbf', b'\xe3\x81',
+                   b'\xed\xa0\x80', b'\xf0\x9f\x98', b'\xf4\x90\x80\x80',
+                   b'\xff']
+        for text in texts:
+            for i in range(len(text)):
+                head = text[:i]
+                tail = text[i:] + text
+                for s in valid:
+                    self.assertEqual((head + s + tail).encode().decode(),
+                                     head + s + tail)
+                for seq in invalid:
+                    data = head.encode() + seq + tail.encode()
+                    with self.assertRaises(UnicodeDecodeError) as cm:
+                        data.decode('utf-8')
+                    self.assertEqual(cm.exception.start, len(head.encode()))
+                    self.assertEqual(data.decode('utf-8', 'replace'),
+                                     head + '�' * len(
+                                         seq.decode('utf-8', 'replace')) +
+                                     tail)
+
     def test_issue8271(self):
         # Issue #8271: during the decoding of an invalid UTF-8 byte sequence,
         # only the start byte and the continuation byte(s) are now considered
@@ -2432,6 +2471,26 @@ class UnicodeTest(string_tests.CommonTest,
         self.assertTrue(astral >= bmp2)
         self.assertFalse(astral >= astral2)
 
+    @support.cpython_only
+    def test_narrowest_kind(self):
+        # Slices are stored in the kind of their greatest character, put it
+        # at every position relative to the blocks of the scans
+        chars = ['a', '\xe9', '€', '\U0001f600']
+        for n in range(1, 70):
+            for fill in chars[:-1]:
+                size = sys.getsizeof(fill * n)
+                self.assertEqual(sys.getsizeof(('\U0001f600' + fill * n)[1:]),
+                                 size)
+                self.assertEqual(sys.getsizeof(('€' + fill * n)[1:]),
+                                 size)
+                for wide in chars[chars.index(fill) + 1:]:
+                    for i in range(n):
+                        s = fill * i + wide + fill * (n - i - 1)
+                        t = ('\U0001f600' + s)[1:]
+                        self.assertEqual(t, s)
+                        self.assertEqual(sys.getsizeof(t),
+                                         sys.getsizeof(wide * n))
+
     def test_free_after_iterating(self):
         support.check_free_after_iterating(self, iter, str)
         support.check_free_after_iterating(self, reversed, str)
@@ -2823,6 +2882,18 @@ class CAPITest(unittest.TestCase):
         self.assertRaises(SystemError, unicode_copycharacters, s, 0, s, 0, -1)
         self.assertRaises(SystemError, unicode_copycharacters, s, 0, b'', 0, 0)
 
+        # wide -> narrow: the copied characters fit
+        for n in range(1, 70):
+            for wide in strings[1:]:
+                for to in strings[:strings.index(wide)]:
+                    from_ = wide[0] + to[0] * n
+                    self.assertEqual(
+                        unicode_copycharacters(to[0] * n, 0, from_, 1, n),
+                        (to[0] * n, n))
+                    self.assertRaises(
+                        SystemError,
+                        unicode_copycharacters, to[0] * n, 0, from_, 0, n)
+
     @support.cpython_only
     def test_encode_decimal(self):
         from _testcapi import unicode_encodedecimal
@@ -2554,6 +2554,9 @@ PyInit__collections(void)
     Py_INCREF(&PyODict_Type);
     PyModule_AddObject(m, "OrderedDict", (PyObject *)&PyODict_Type);
 
+    Py_INCREF(&PyFrozenDict_Type);
+    PyModule_AddObject(m, "FrozenDict", (PyObject *)&PyFrozenDict_Type);
+
     if (PyType_Ready(&dequeiter_type) < 0)
         return NULL;
     Py_INCREF(&dequeiter_type);
@@ -3636,6 +3636,10 @@ tzinfo_reduce(PyObject *self, PyObject *Py_UNUSED(ignored))
         PyErr_Clear();
         state = Py_None;
         dictptr = _PyObject_GetDictPtr(self);
+        if (dictptr == NULL && PyErr_Occurred()) {
+            Py_DECREF(args);
+            return NULL;
+        }
         if (dictptr && *dictptr && PyDict_GET_SIZE(*dictptr)) {
             state = *dictptr;
         }
@@ -3,6 +3,7 @@
 #include "pycore_pystate.h"
 #include "pycore_tupleobject.h"
 #include "structmember.h"
+#include "stackless_api.h"
 
 /* _functools module written and maintained
    by Hye-Shik Chang <perky@FreeBSD.org>
@@ -130,6 +131,7 @@ static PyObject *
 partial_fastcall(partialobject *pto, PyObject **args, Py_ssize_t nargs,
                  PyObject *kwargs)
 {
+    STACKLESS_GETARG();
     PyObject *small_stack[_PY_FASTCALL_SMALL_STACK];
     PyObject *ret;
     PyObject **stack, **stack_buf = NULL;
@@ -166,7 +168,9 @@ partial_fastcall(partialobject *pto, PyObject **args, Py_ssize_t nargs,
                nargs * sizeof(PyObject*));
     }
 
+    STACKLESS_PROMOTE_ALL();
     ret = _PyObject_FastCallDict(pto->fn, stack, nargs2, kwargs);
+    STACKLESS_ASSERT();
     PyMem_Free(stack_buf);
     return ret;
 }
@@ -174,6 +178,7 @@ partial_fastcall(partialobject *pto, PyObject **args, Py_ssize_t nargs,
 static PyObject *
 partial_call_impl(partialobject *pto, PyObject *args, PyObject *kwargs)
 {
+    STACKLESS_GETARG();
     PyObject *ret, *args2;
 
     /* Note: tupleconcat() is optimized for empty tuples */
@@ -183,7 +188,9 @@ partial_call_impl(partialobject *pto, PyObject *args, PyObject *kwargs)
     }
     assert(PyTuple_Check(args2));
 
+    STACKLESS_PROMOTE_ALL();
     ret = PyObject_Call(pto->fn, args2, kwargs);
+    STACKLESS_ASSERT();
     Py_DECREF(args2);
     return ret;
 }
@@ -191,6 +198,7 @@ partial_call_impl(partialobject *pto, PyObject *args, PyObject *kwargs)
 static PyObject *
 partial_call(partialobject *pto, PyObject *args, PyObject *kwargs)
 {
+    STACKLESS_GETARG();
     PyObject *kwargs2, *res;
 
     assert (PyCallable_Check(pto->fn));
@@ -220,6 +228,7 @@ partial_call(partialobject *pto, PyObject *args, PyObject *kwargs)
     }
 
 
+    STACKLESS_PROMOTE_ALL();
     if (pto->use_fastcall) {
         res = partial_fastcall(pto,
                                _PyTuple_ITEMS(args),
@@ -229,6 +238,7 @@ partial_call(partialobject *pto, PyObject *args, PyObject *kwargs)
     else {
         res = partial_call_impl(pto, args, kwargs2);
     }
+    STACKLESS_ASSERT();
     Py_XDECREF(kwargs2);
     return res;
 }
@@ -379,6 +389,12 @@ static PyMethodDef partial_methods[] = {
     {NULL,              NULL}           /* sentinel */
 };
 
+#ifdef STACKLESS
+static PyMappingMethods partial_as_mapping = {
+    .slpflags.tp_call = -1,
+};
+#endif
+
 static PyTypeObject partial_type = {
     PyVarObject_HEAD_INIT(NULL, 0)
     "functools.partial",                /* tp_name */
@@ -393,7 +409,11 @@ static PyTypeObject partial_type = {
     (reprfunc)partial_repr,             /* tp_repr */
     0,                                  /* tp_as_number */
     0,                                  /* tp_as_sequence */
+#ifdef STACKLESS
+    &partial_as_mapping,                /* tp_as_mapping */
+#else
     0,                                  /* tp_as_mapping */
+#endif
     0,                                  /* tp_hash */
     (ternaryfunc)partial_call,          /* tp_call */
     0,                                  /* tp_str */
@@ -401,7 +421,8 @@ static PyTypeObject partial_type = {
     PyObject_GenericSetAttr,            /* tp_setattro */
     0,                                  /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
-        Py_TPFLAGS_BASETYPE,            /* tp_flags */
+        Py_TPFLAGS_BASETYPE |
+        Py_TPFLAGS_HAVE_STACKLESS_EXTENSION,    /* tp_flags */
     partial_doc,                        /* tp_doc */
     (traverseproc)partial_traverse,     /* tp_traverse */
     0,                                  /* tp_clear */
@@ -155,12 +155,14 @@ resize_buffer(bytesio *self, size_t size)
     return -1;
 }
 
-/* Internal routine for writing a string of bytes to the buffer of a BytesIO
-   object. Returns the number of bytes written, or -1 on error. */
-static Py_ssize_t
-write_bytes(bytesio *self, const char *bytes, Py_ssize_t len)
+/* Internal routine for making room for len bytes at the current position
+   of a BytesIO object and moving the position past them.  Returns a pointer
+   to the room, which the caller must fill, or NULL on error. */
+static char *
+reserve_bytes(bytesio *self, Py_ssize_t len)
 {
     size_t endpos;
+    char *room;
     assert(self->buf != NULL);
     assert(self->pos >= 0);
     assert(len >= 0);
@@ -168,11 +170,11 @@ write_bytes(bytesio *self, const char *bytes, Py_ssize_t len)
     endpos = (size_t)self->pos + len;
     if (endpos > (size_t)PyBytes_GET_SIZE(self->buf)) {
         if (resize_buffer(self, endpos) < 0)
-            return -1;
+            return NULL;
     }
     else if (SHARED_BUF(self)) {
         if (unshare_buffer(self, Py_MAX(endpos, (size_t)self->string_size)) < 0)
-            return -1;
+            return NULL;
     }
 
     if (self->pos > self->string_size) {
@@ -188,9 +190,9 @@ write_bytes(bytesio *self, const char *bytes, Py_ssize_t len)
                (self->pos - self->string_size) * sizeof(char));
     }
 
-    /* Copy the data to the internal buffer, overwriting some of the existing
-       data if self->pos < self->string_size. */
-    memcpy(PyBytes_AS_STRING(self->buf) + self->pos, bytes, len);
+    /* The data will overwrite some of the existing data if
+       self->pos < self->string_size. */
+    room = PyBytes_AS_STRING(self->buf) + self->pos;
     self->pos = endpos;
 
     /* Set the new length of the internal string if it has changed. */
@@ -198,6 +200,19 @@ write_bytes(bytesio *self, const char *bytes, Py_ssize_t len)
         self->string_size = endpos;
     }
 
+    return room;
+}
+
+/* Internal routine for writing a string of bytes to the buffer of a BytesIO
+   object. Returns the number of bytes written, or -1 on error. */
+static Py_ssize_t
+write_bytes(bytesio *self, const char *bytes, Py_ssize_t len)
+{
+    char *room = reserve_bytes(self, len);
+
+    if (room == NULL)
+        return -1;
+    memcpy(room, bytes, len);
     return len;
 }
 
@@ -706,6 +721,44 @@ _io_BytesIO_writelines(bytesio *self, PyObject *lines)
 
     CHECK_CLOSED(self);
 
+    if (PyList_CheckExact(lines) || PyTuple_CheckExact(lines)) {
+        /* Fast path for a list or tuple of bytes objects: make room for all
+           of them at once, instead of growing the buffer for each.  This
+           doesn't call back into Python code, so lines can't change. */
+        PyObject **items = PySequence_Fast_ITEMS(lines);
+        Py_ssize_t n = PySequence_Fast_GET_SIZE(lines);
+        Py_ssize_t i, len, size = 0;
+        char *room;
+
+        for (i = 0; i < n; i++) {
+            if (!PyBytes_CheckExact(items[i]))
+                break;
+            len = PyBytes_GET_SIZE(items[i]);
+            if (len > PY_SSIZE_T_MAX - size) {
+                PyErr_SetString(PyExc_OverflowError,
+                                "new buffer size too large");
+                return NULL;
+            }
+            size += len;
+        }
+        if (i == n) {
+            if (n == 0)
+                Py_RETURN_NONE;
+            CHECK_EXPORTS(self);
+            if (size == 0)
+                Py_RETURN_NONE;
+            room = reserve_bytes(self, size);
+            if (room == NULL)
+                return NULL;
+            for (i = 0; i < n; i++) {
+                len = PyBytes_GET_SIZE(items[i]);
+                memcpy(room, PyBytes_AS_STRING(items[i]), len);
+                room += len;
+            }
+            Py_RETURN_NONE;
+        }
+    }
+
     it = PyObject_GetIter(lines);
     if (it == NULL)
         return NULL;
@@ -186,6 +186,238 @@ static const unsigned short crctab_hqx[256] = {
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,
 };
 
+/* SSE2 is part of the x86-64 baseline and is used unconditionally by the
+   hex decoder.  The SSSE3 base64 codec and the PCLMUL CRC-32 are compiled
+   with function attributes and are only used if the CPU supports them,
+   which binascii_exec() checks at run time. */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HAVE_BINASCII_SSE2
+#  include <emmintrin.h>
+#endif
+#if defined(HAVE_BINASCII_SSE2) && \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define HAVE_BINASCII_SSSE3
+#  include <tmmintrin.h>
+#  include <wmmintrin.h>
+static int binascii_ssse3_enabled = 0;
+static int binascii_clmul_enabled = 0;
+#endif
+
+/* crctab_hqx8[k][i] is the CRC-CCITT of the byte i followed by k zero
+   bytes, so that crc_hqx() can process 8 bytes per step.  The table is
+   computed by binascii_exec(). */
+static int crctab_hqx8_ready = 0;
+static unsigned short crctab_hqx8[8][256];
+
+static void
+binascii_init_tables(void)
+{
+    int i, k;
+
+    if (!crctab_hqx8_ready) {
+        for (i = 0; i < 256; i++) {
+            crctab_hqx8[0][i] = crctab_hqx[i];
+        }
+        for (k = 1; k < 8; k++) {
+            for (i = 0; i < 256; i++) {
+                unsigned int crc = crctab_hqx8[k - 1][i];
+                crctab_hqx8[k][i] = ((crc << 8) & 0xff00) ^
+                                    crctab_hqx[crc >> 8];
+            }
+        }
+        crctab_hqx8_ready = 1;
+    }
+#ifdef HAVE_BINASCII_SSSE3
+    binascii_ssse3_enabled = __builtin_cpu_supports("ssse3");
+    binascii_clmul_enabled = __builtin_cpu_supports("pclmul");
+#endif
+}
+
+#ifdef HAVE_BINASCII_SSE2
+/* Decode the hex digits at s in blocks of 32 to 16 bytes at out, until less
+   than 32 digits are left or a block contains a character which is not a
+   hex digit.  Return the number of digits decoded. */
+static Py_ssize_t
+unhex_sse2(const unsigned char *s, Py_ssize_t len, unsigned char *out)
+{
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i five = _mm_set1_epi8(5);
+    const __m128i ten = _mm_set1_epi8(10);
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    Py_ssize_t i;
+
+    for (i = 0; i + 32 <= len; i += 32, out += 16) {
+        __m128i v[2];
+        int k;
+        for (k = 0; k < 2; k++) {
+            __m128i in = _mm_loadu_si128((const __m128i *)(s + i + 16 * k));
+            /* c - '0' <= 9 or (c | 0x20) - 'a' <= 5, unsigned */
+            __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+            __m128i letter = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)),
+                                          _mm_set1_epi8('a'));
+            __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+            __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, five),
+                                               letter);
+            if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF)
+                return i;
+            in = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                              _mm_and_si128(is_letter,
+                                            _mm_add_epi8(letter, ten)));
+            /* the high nibble is in the low byte of every 16-bit lane */
+            v[k] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(in, low_byte), 4),
+                                _mm_srli_epi16(in, 8));
+        }
+        _mm_storeu_si128((__m128i *)out, _mm_packus_epi16(v[0], v[1]));
+    }
+    return i;
+}
+#endif
+
+#ifdef HAVE_BINASCII_SSSE3
+/* The SSSE3 base64 codec is the algorithm of Muła and Lemire, "Faster
+   Base64 Encoding and Decoding Using AVX2 Instructions" (2018), with 16
+   byte vectors. */
+
+/* Encode blocks of 12 bytes at s to 16 characters at out, while 16 bytes
+   can be loaded.  Return the number of bytes encoded. */
+__attribute__((target("ssse3")))
+static Py_ssize_t
+base64_encode_ssse3(const unsigned char *s, Py_ssize_t len, unsigned char *out)
+{
+    /* '0' - 52 for 52..61, '+' - 62, '/' - 63, 'A' - 0, 'a' - 26 */
+    const __m128i shift = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    Py_ssize_t i;
+
+    for (i = 0; i + 16 <= len; i += 12, out += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i index, t;
+        /* bytes b1 b0 b2 b1 in every 32-bit lane */
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                               4, 5, 3, 4, 1, 2, 0, 1));
+        /* move the four 6-bit groups to the low bits of the four bytes */
+        index = _mm_or_si128(
+            _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                            _mm_set1_epi32(0x04000040)),
+            _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                            _mm_set1_epi32(0x01000010)));
+        /* 0 for 26..51, 1..12 for 52..63 and 13 for 0..25 */
+        t = _mm_or_si128(_mm_subs_epu8(index, _mm_set1_epi8(51)),
+                         _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), index),
+                                       _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i *)out,
+                         _mm_add_epi8(index, _mm_shuffle_epi8(shift, t)));
+    }
+    return i;
+}
+
+/* Decode blocks of 16 base64 characters at s to 12 bytes at out, until
+   less than 24 characters are left or a block contains a character which
+   is not a base64 digit, like padding and whitespace.  Return the number
+   of characters decoded. */
+__attribute__((target("ssse3")))
+static Py_ssize_t
+base64_decode_ssse3(const unsigned char *s, Py_ssize_t len, unsigned char *out)
+{
+    /* bit sets of the classes of the low and the high nibble; a character
+       is valid if the two sets are disjoint */
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    /* the value to add by the high nibble, and for '/' */
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+    Py_ssize_t i;
+
+    for (i = 0; i + 24 <= len; i += 16, out += 12) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2f));
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i roll;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi),
+                                             _mm_setzero_si128())) != 0xFFFF)
+            break;
+        roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(
+            _mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+        in = _mm_add_epi8(in, roll);
+        /* pack the four 6-bit values of every 32-bit lane to 3 bytes */
+        in = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+        in = _mm_madd_epi16(in, _mm_set1_epi32(0x00011000));
+        in = _mm_shuffle_epi8(in, _mm_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128((__m128i *)out, in);
+    }
+    return i;
+}
+
+/* Update the inverted CRC-32 crc with the len bytes at s, by folding 64
+   bytes at a time with carry-less multiplication, as in Gopal et al., "Fast
+   CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+   (Intel, 2009).  len must be a multiple of 16 and at least 64. */
+__attribute__((target("pclmul")))
+static unsigned int
+crc32_clmul(const unsigned char *s, Py_ssize_t len, unsigned int crc)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i low32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x0, x1, x2, x3, x4, t;
+
+    assert(len >= 64 && len % 16 == 0);
+    x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)s),
+                       _mm_cvtsi32_si128((int)crc));
+    x2 = _mm_loadu_si128((const __m128i *)(s + 16));
+    x3 = _mm_loadu_si128((const __m128i *)(s + 32));
+    x4 = _mm_loadu_si128((const __m128i *)(s + 48));
+    s += 64;
+    len -= 64;
+
+#define CRC32_FOLD(x, k, y) \
+    (t = _mm_clmulepi64_si128(x, k, 0x00), \
+     _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), t), y))
+
+    /* fold four blocks of 16 bytes in parallel */
+    for (; len >= 64; s += 64, len -= 64) {
+        x1 = CRC32_FOLD(x1, k1k2, _mm_loadu_si128((const __m128i *)s));
+        x2 = CRC32_FOLD(x2, k1k2, _mm_loadu_si128((const __m128i *)(s + 16)));
+        x3 = CRC32_FOLD(x3, k1k2, _mm_loadu_si128((const __m128i *)(s + 32)));
+        x4 = CRC32_FOLD(x4, k1k2, _mm_loadu_si128((const __m128i *)(s + 48)));
+    }
+    /* fold them into one */
+    x1 = CRC32_FOLD(x1, k3k4, x2);
+    x1 = CRC32_FOLD(x1, k3k4, x3);
+    x1 = CRC32_FOLD(x1, k3k4, x4);
+    for (; len >= 16; s += 16, len -= 16) {
+        x1 = CRC32_FOLD(x1, k3k4, _mm_loadu_si128((const __m128i *)s));
+    }
+#undef CRC32_FOLD
+
+    /* fold 128 bits to 64 bits */
+    x0 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x0);
+    x0 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), k5, 0x00);
+    x1 = _mm_xor_si128(x1, x0);
+
+    /* Barrett reduction to 32 bits */
+    x0 = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), poly, 0x10);
+    x0 = _mm_clmulepi64_si128(_mm_and_si128(x0, low32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x0);
+    return (unsigned int)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+#endif
+
 /*[clinic input]
 module binascii
 [clinic start generated code]*/
@@ -482,6 +714,16 @@ binascii_a2b_base64_impl(PyObject *module, Py_buffer *data)
     bin_data_start = bin_data;
 
     for( ; ascii_len > 0; ascii_len--, ascii_data++) {
+#ifdef HAVE_BINASCII_SSSE3
+        /* At the start of a quad no bits are left over. */
+        if (quad_pos == 0 && binascii_ssse3_enabled && ascii_len >= 24) {
+            Py_ssize_t n = base64_decode_ssse3(ascii_data, ascii_len,
+                                               bin_data);
+            ascii_data += n;
+            ascii_len -= n;
+            bin_data += n / 4 * 3;
+        }
+#endif
         this_ch = *ascii_data;
 
         if (this_ch > 0x7f ||
@@ -604,6 +846,14 @@ binascii_b2a_base64_impl(PyObject *module, Py_buffer *data, int newline)
     if (ascii_data == NULL)
         return NULL;
 
+#ifdef HAVE_BINASCII_SSSE3
+    if (binascii_ssse3_enabled) {
+        Py_ssize_t n = base64_encode_ssse3(bin_data, bin_len, ascii_data);
+        bin_data += n;
+        bin_len -= n;
+        ascii_data += n / 3 * 4;
+    }
+#endif
     for( ; bin_len > 0 ; bin_len--, bin_data++ ) {
         /* Shift the data into our buffer */
         leftchar = (leftchar << 8) | *bin_data;
@@ -982,6 +1232,13 @@ binascii_crc_hqx_impl(PyObject *module, Py_buffer *data, unsigned int crc)
     bin_data = data->buf;
     len = data->len;
 
+    for (; len >= 8; len -= 8, bin_data += 8) {
+        crc = crctab_hqx8[7][(crc >> 8) ^ bin_data[0]] ^
+              crctab_hqx8[6][(crc & 0xff) ^ bin_data[1]] ^
+              crctab_hqx8[5][bin_data[2]] ^ crctab_hqx8[4][bin_data[3]] ^
+              crctab_hqx8[3][bin_data[4]] ^ crctab_hqx8[2][bin_data[5]] ^
+              crctab_hqx8[1][bin_data[6]] ^ crctab_hqx8[0][bin_data[7]];
+    }
     while(len-- > 0) {
         crc = ((crc<<8)&0xff00) ^ crctab_hqx[(crc>>8)^*bin_data++];
     }
@@ -1109,41 +1366,20 @@ static const unsigned int crc_32_tab[256] = {
 };
 #endif  /* USE_ZLIB_CRC32 */
 
-/*[clinic input]
-binascii.crc32 -> unsigned_int
-
-    data: Py_buffer
-    crc: unsigned_int(bitwise=True) = 0
-    /
-
-Compute CRC-32 incrementally.
-[clinic start generated code]*/
-
 static unsigned int
-binascii_crc32_impl(PyObject *module, Py_buffer *data, unsigned int crc)
-/*[clinic end generated code: output=52cf59056a78593b input=bbe340bc99d25aa8]*/
-
+crc32_update(const unsigned char *bin_data, Py_ssize_t len, unsigned int crc)
 #ifdef USE_ZLIB_CRC32
 /* This was taken from zlibmodule.c PyZlib_crc32 (but is PY_SSIZE_T_CLEAN) */
 {
-    const Byte *buf;
-    Py_ssize_t len;
     int signed_val;
 
-    buf = (Byte*)data->buf;
-    len = data->len;
-    signed_val = crc32(crc, buf, len);
+    signed_val = crc32(crc, (const Byte *)bin_data, len);
     return (unsigned int)signed_val & 0xffffffffU;
 }
 #else  /* USE_ZLIB_CRC32 */
 { /* By Jim Ahlstrom; All rights transferred to CNRI */
-    const unsigned char *bin_data;
-    Py_ssize_t len;
     unsigned int result;
 
-    bin_data = data->buf;
-    len = data->len;
-
     crc = ~ crc;
     while (len-- > 0) {
         crc = crc_32_tab[(crc ^ *bin_data++) & 0xff] ^ (crc >> 8);
@@ -1155,6 +1391,36 @@ binascii_crc32_impl(PyObject *module, Py_buffer *data, unsigned int crc)
 }
 #endif  /* USE_ZLIB_CRC32 */
 
+/*[clinic input]
+binascii.crc32 -> unsigned_int
+
+    data: Py_buffer
+    crc: unsigned_int(bitwise=True) = 0
+    /
+
+Compute CRC-32 incrementally.
+[clinic start generated code]*/
+
+static unsigned int
+binascii_crc32_impl(PyObject *module, Py_buffer *data, unsigned int crc)
+/*[clinic end generated code: output=52cf59056a78593b input=bbe340bc99d25aa8]*/
+{
+    const unsigned char *bin_data;
+    Py_ssize_t len;
+
+    bin_data = data->buf;
+    len = data->len;
+#ifdef HAVE_BINASCII_SSSE3
+    if (binascii_clmul_enabled && len >= 64) {
+        Py_ssize_t n = len & ~(Py_ssize_t)15;
+        crc = ~crc32_clmul(bin_data, n, ~crc);
+        bin_data += n;
+        len -= n;
+    }
+#endif
+    return crc32_update(bin_data, len, crc);
+}
+
 /*[clinic input]
 binascii.b2a_hex
 
@@ -1252,7 +1518,13 @@ binascii_a2b_hex_impl(PyObject *module, Py_buffer *hexstr)
         return NULL;
     retbuf = PyBytes_AS_STRING(retval);
 
-    for (i=j=0; i < arglen; i += 2) {
+    i = j = 0;
+#ifdef HAVE_BINASCII_SSE2
+    i = unhex_sse2((const unsigned char *)argbuf, arglen,
+                   (unsigned char *)retbuf);
+    j = i / 2;
+#endif
+    for (; i < arglen; i += 2) {
         unsigned int top = _PyLong_DigitValue[Py_CHARMASK(argbuf[i])];
         unsigned int bot = _PyLong_DigitValue[Py_CHARMASK(argbuf[i+1])];
         if (top >= 16 || bot >= 16) {
@@ -1623,6 +1895,8 @@ binascii_exec(PyObject *m) {
         return -1;
     }
 
+    binascii_init_tables();
+
     state->Error = PyErr_NewException("binascii.Error", PyExc_ValueError, NULL);
     if (state->Error == NULL) {
         return -1;
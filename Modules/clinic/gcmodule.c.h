@@ -373,4 +373,160 @@ gc_get_freeze_count(PyObject *module, PyObject *Py_UNUSED(ignored))
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=e40d384b1f0d513c input=a9049054013a1b77]*/
+
+PyDoc_STRVAR(gc_set_incremental__doc__,
+"set_incremental($module, budget_ms, /)\n"
+"--\n"
+"\n"
+"Set the time budget of a slice of the incremental collection.\n"
+"\n"
+"Automatic collections of the oldest generation are split into slices, which\n"
+"take about budget_ms milliseconds each.  A budget of zero disables\n"
+"incremental collection.");
+
+#define GC_SET_INCREMENTAL_METHODDEF    \
+    {"set_incremental", (PyCFunction)gc_set_incremental, METH_O, gc_set_incremental__doc__},
+
+PyDoc_STRVAR(gc_get_incremental__doc__,
+"get_incremental($module, /)\n"
+"--\n"
+"\n"
+"Return the time budget of a slice of the incremental collection in ms.");
+
+#define GC_GET_INCREMENTAL_METHODDEF    \
+    {"get_incremental", (PyCFunction)gc_get_incremental, METH_NOARGS, gc_get_incremental__doc__},
+
+static PyObject *
+gc_get_incremental_impl(PyObject *module);
+
+static PyObject *
+gc_get_incremental(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_incremental_impl(module);
+}
+
+#if defined(STACKLESS)
+
+PyDoc_STRVAR(gc_set_park_threshold__doc__,
+"set_park_threshold($module, threshold, limit=0, /)\n"
+"--\n"
+"\n"
+"Set the thresholds of the parked generation.\n"
+"\n"
+"A tasklet, that stays blocked on a channel during threshold full collections,\n"
+"is moved together with its frames into the parked generation.  Automatic\n"
+"collections ignore the parked generation.  It is merged back into the oldest\n"
+"generation by an explicit full collection or if more than limit objects have\n"
+"been parked since the last merge.  A threshold of zero disables parking and\n"
+"a limit of zero means no limit.");
+
+#define GC_SET_PARK_THRESHOLD_METHODDEF    \
+    {"set_park_threshold", (PyCFunction)(void(*)(void))gc_set_park_threshold, METH_FASTCALL, gc_set_park_threshold__doc__},
+
+static PyObject *
+gc_set_park_threshold_impl(PyObject *module, int threshold, Py_ssize_t limit);
+
+static PyObject *
+gc_set_park_threshold(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    int threshold;
+    Py_ssize_t limit = 0;
+
+    if (!_PyArg_CheckPositional("set_park_threshold", nargs, 1, 2)) {
+        goto exit;
+    }
+    if (PyFloat_Check(args[0])) {
+        PyErr_SetString(PyExc_TypeError,
+                        "integer argument expected, got float" );
+        goto exit;
+    }
+    threshold = _PyLong_AsInt(args[0]);
+    if (threshold == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    if (nargs < 2) {
+        goto skip_optional;
+    }
+    if (PyFloat_Check(args[1])) {
+        PyErr_SetString(PyExc_TypeError,
+                        "integer argument expected, got float" );
+        goto exit;
+    }
+    {
+        Py_ssize_t ival = -1;
+        PyObject *iobj = PyNumber_Index(args[1]);
+        if (iobj != NULL) {
+            ival = PyLong_AsSsize_t(iobj);
+            Py_DECREF(iobj);
+        }
+        if (ival == -1 && PyErr_Occurred()) {
+            goto exit;
+        }
+        limit = ival;
+    }
+skip_optional:
+    return_value = gc_set_park_threshold_impl(module, threshold, limit);
+
+exit:
+    return return_value;
+}
+
+#endif /* defined(STACKLESS) */
+
+#if defined(STACKLESS)
+
+PyDoc_STRVAR(gc_get_park_threshold__doc__,
+"get_park_threshold($module, /)\n"
+"--\n"
+"\n"
+"Return the thresholds of the parked generation as a tuple (threshold, limit).");
+
+#define GC_GET_PARK_THRESHOLD_METHODDEF    \
+    {"get_park_threshold", (PyCFunction)gc_get_park_threshold, METH_NOARGS, gc_get_park_threshold__doc__},
+
+static PyObject *
+gc_get_park_threshold_impl(PyObject *module);
+
+static PyObject *
+gc_get_park_threshold(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_park_threshold_impl(module);
+}
+
+#endif /* defined(STACKLESS) */
+
+#if defined(STACKLESS)
+
+PyDoc_STRVAR(gc_get_parked_stats__doc__,
+"get_parked_stats($module, /)\n"
+"--\n"
+"\n"
+"Return a dictionary containing statistics of the parked generation.");
+
+#define GC_GET_PARKED_STATS_METHODDEF    \
+    {"get_parked_stats", (PyCFunction)gc_get_parked_stats, METH_NOARGS, gc_get_parked_stats__doc__},
+
+static PyObject *
+gc_get_parked_stats_impl(PyObject *module);
+
+static PyObject *
+gc_get_parked_stats(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_parked_stats_impl(module);
+}
+
+#endif /* defined(STACKLESS) */
+
+#ifndef GC_SET_PARK_THRESHOLD_METHODDEF
+    #define GC_SET_PARK_THRESHOLD_METHODDEF
+#endif /* !defined(GC_SET_PARK_THRESHOLD_METHODDEF) */
+
+#ifndef GC_GET_PARK_THRESHOLD_METHODDEF
+    #define GC_GET_PARK_THRESHOLD_METHODDEF
+#endif /* !defined(GC_GET_PARK_THRESHOLD_METHODDEF) */
+
+#ifndef GC_GET_PARKED_STATS_METHODDEF
+    #define GC_GET_PARKED_STATS_METHODDEF
+#endif /* !defined(GC_GET_PARKED_STATS_METHODDEF) */
+/*[clinic end generated code: output=51b6576741badeed input=a9049054013a1b77]*/
@@ -52,6 +52,13 @@ module gc
 // No objects in interpreter have this flag after GC ends.
 #define PREV_MASK_COLLECTING   _PyGC_PREV_MASK_COLLECTING
 
+// Objects of the oldest generation, which were examined by a slice of the
+// current round of the incremental collection, have this flag set to the
+// value of state->visited_space.  See collect_increment().
+#ifdef _PyGC_PREV_MASK_VISITED
+#define PREV_MASK_VISITED      _PyGC_PREV_MASK_VISITED
+#endif
+
 // Lowest bit of _gc_next is used for UNREACHABLE flag.
 //
 // This flag represents the object is in unreachable list in move_unreachable()
@@ -102,6 +109,25 @@ gc_reset_refs(PyGC_Head *g, Py_ssize_t refs)
         | ((uintptr_t)(refs) << _PyGC_PREV_SHIFT);
 }
 
+#ifdef PREV_MASK_VISITED
+static inline int
+gc_is_visited(struct _gc_runtime_state *state, PyGC_Head *g)
+{
+    return ((g->_gc_prev & PREV_MASK_VISITED) != 0) == state->visited_space;
+}
+
+static inline void
+gc_set_visited(struct _gc_runtime_state *state, PyGC_Head *g, int visited)
+{
+    if (visited == state->visited_space) {
+        g->_gc_prev |= PREV_MASK_VISITED;
+    }
+    else {
+        g->_gc_prev &= ~PREV_MASK_VISITED;
+    }
+}
+#endif
+
 static inline void
 gc_decref(PyGC_Head *g)
 {
@@ -124,6 +150,9 @@ static PyObject *gc_str = NULL;
                 DEBUG_SAVEALL
 
 #define GEN_HEAD(state, n) (&(state)->generations[n].head)
+#ifdef STACKLESS
+#define PARKED_HEAD(state) (&(state)->parked_generation.head)
+#endif
 
 void
 _PyGC_Initialize(struct _gc_runtime_state *state)
@@ -146,6 +175,17 @@ _PyGC_Initialize(struct _gc_runtime_state *state)
            (uintptr_t)&state->permanent_generation.head}, 0, 0
     };
     state->permanent_generation = permanent_generation;
+#ifdef STACKLESS
+    struct gc_generation parked_generation = {
+          {(uintptr_t)PARKED_HEAD(state), (uintptr_t)PARKED_HEAD(state)}, 0, 0
+    };
+    state->parked_generation = parked_generation;
+#endif
+    PyGC_Head incremental_rest = {(uintptr_t)&state->incremental_rest,
+                                  (uintptr_t)&state->incremental_rest};
+    state->incremental_rest = incremental_rest;
+    state->incremental_ns_per_object = 100;
+    state->visited_space = 1;
 }
 
 /*
@@ -544,9 +584,30 @@ move_unreachable(PyGC_Head *young, PyGC_Head *unreachable)
     young->_gc_prev = (uintptr_t)prev;
 }
 
-static void
-untrack_tuples(PyGC_Head *head)
+/* Dictionaries with more items are only untracked by collections of the
+   oldest generation, see untrack_young(). */
+#define UNTRACK_DICT_MAX 32
+
+/* Try to untrack the tuples and dicts of head, which can't be part of a
+ * reference cycle.  This runs before the reference counts are examined,
+ * so the untracked objects are not traversed by the collection.  The list
+ * is in allocation order and the items of a container are usually older
+ * than the container, so nested containers get untracked in one pass.
+ *
+ * A dict, which gets untracked, is tracked again as soon as a container
+ * is stored into it, and lands in the youngest generation.  To avoid a
+ * quadratic build-up of large dicts (see issue #14775), only dicts with at
+ * most dict_max items are examined.  Collections of the youngest
+ * generation examine small dicts, collections of the middle generation
+ * none and collections of the oldest generation all.
+ *
+ * Return the number of untracked objects.  The number of examined objects,
+ * which stay tracked, is added to *kept.
+ */
+static Py_ssize_t
+untrack_young(PyGC_Head *head, Py_ssize_t dict_max, Py_ssize_t *kept)
 {
+    Py_ssize_t untracked = 0;
     PyGC_Head *next, *gc = GC_NEXT(head);
     while (gc != head) {
         PyObject *op = FROM_GC(gc);
@@ -554,23 +615,23 @@ untrack_tuples(PyGC_Head *head)
         if (PyTuple_CheckExact(op)) {
             _PyTuple_MaybeUntrack(op);
         }
-        gc = next;
-    }
-}
-
-/* Try to untrack all currently tracked dictionaries */
-static void
-untrack_dicts(PyGC_Head *head)
-{
-    PyGC_Head *next, *gc = GC_NEXT(head);
-    while (gc != head) {
-        PyObject *op = FROM_GC(gc);
-        next = GC_NEXT(gc);
-        if (PyDict_CheckExact(op)) {
+        else if (PyDict_CheckExact(op) &&
+                 ((PyDictObject *)op)->ma_used <= dict_max) {
             _PyDict_MaybeUntrack(op);
         }
+        else {
+            gc = next;
+            continue;
+        }
+        if (_PyObject_GC_IS_TRACKED(op)) {
+            (*kept)++;
+        }
+        else {
+            untracked++;
+        }
         gc = next;
     }
+    return untracked;
 }
 
 /* Return true if object has a pre-PEP 442 finalization method. */
@@ -941,6 +1002,112 @@ delete_garbage(struct _gc_runtime_state *state,
     }
 }
 
+#ifdef STACKLESS
+/* The parked generation
+ *
+ * A Stackless application may have a huge number of tasklets, which are
+ * blocked on channels most of the time.  Each full collection traverses
+ * these tasklets and their frame chains again, although they rarely change.
+ * Therefore a tasklet, that stays blocked for park_threshold full
+ * collections, is moved together with its frames into the parked
+ * generation.  Like the permanent generation, the parked generation is not
+ * examined by collections.  Its objects are reachable from outside of the
+ * collected generations, therefore parking never frees a live object.  It
+ * only delays the collection of garbage cycles through parked objects until
+ * the parked generation gets merged back into the oldest generation.  This
+ * happens on an explicit collection (gc.collect(), PyGC_Collect()) or if
+ * more than park_limit objects have been parked since the last merge.
+ */
+
+static void
+unpark_all(struct _gc_runtime_state *state)
+{
+    if (!gc_list_is_empty(PARKED_HEAD(state))) {
+        gc_list_merge(PARKED_HEAD(state), GEN_HEAD(state, NUM_GENERATIONS-1));
+        state->parked_stats.merges++;
+    }
+    state->parked_pending = 0;
+}
+
+/* Move long time blocked tasklets found in the oldest generation old and
+ * their frames into the parked generation.
+ *
+ * A frame must be moved only, if it is in old.  Otherwise we could steal a
+ * frozen frame from the permanent generation.  We temporarily use the
+ * PREV_MASK_COLLECTING flag to mark the members of old.  Only called at the
+ * end of a full collection, when the flag is unused.
+ */
+static void
+park_blocked_tasklets(struct _gc_runtime_state *state, PyGC_Head *old)
+{
+    PyGC_Head tasklets;
+    PyGC_Head *gc, *next;
+    Py_ssize_t epoch = state->generation_stats[NUM_GENERATIONS-1].collections + 1;
+    Py_ssize_t n_tasklets = 0, n_frames = 0;
+
+    assert(state->park_threshold > 0);
+    validate_list(old, 0);
+    for (gc = GC_NEXT(old); gc != old; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        gc->_gc_prev |= PREV_MASK_COLLECTING;
+        if (PyTasklet_Check(op)) {
+            PyTaskletObject *t = (PyTaskletObject *)op;
+            if (!t->flags.blocked) {
+                continue;
+            }
+            if (t->gc_blocked_since == 0) {
+                t->gc_blocked_since = epoch;
+            }
+            else if (epoch - t->gc_blocked_since >= state->park_threshold) {
+                n_tasklets++;
+            }
+        }
+    }
+
+    if (n_tasklets) {
+        gc_list_init(&tasklets);
+        for (gc = GC_NEXT(old); gc != old; gc = next) {
+            PyObject *op = FROM_GC(gc);
+            next = GC_NEXT(gc);
+            if (PyTasklet_Check(op)) {
+                PyTaskletObject *t = (PyTaskletObject *)op;
+                if (t->flags.blocked && t->gc_blocked_since &&
+                    epoch - t->gc_blocked_since >= state->park_threshold) {
+                    gc_clear_collecting(gc);
+                    gc_list_move(gc, &tasklets);
+                }
+            }
+        }
+        for (gc = GC_NEXT(&tasklets); gc != &tasklets; gc = GC_NEXT(gc)) {
+            PyFrameObject *f = ((PyTaskletObject *)FROM_GC(gc))->f.frame;
+            for (; f != NULL; f = f->f_back) {
+                PyGC_Head *fgc = AS_GC(f);
+                if (_PyObject_GC_IS_TRACKED(f) && gc_is_collecting(fgc)) {
+                    gc_clear_collecting(fgc);
+                    gc_list_move(fgc, PARKED_HEAD(state));
+                    n_frames++;
+                }
+            }
+        }
+        gc_list_merge(&tasklets, PARKED_HEAD(state));
+    }
+
+    for (gc = GC_NEXT(old); gc != old; gc = GC_NEXT(gc)) {
+        gc_clear_collecting(gc);
+    }
+    validate_list(old, 0);
+
+    state->parked_stats.tasklets += n_tasklets;
+    state->parked_stats.frames += n_frames;
+    state->parked_pending += n_tasklets + n_frames;
+    state->long_lived_total -= n_tasklets + n_frames;
+    if (n_tasklets && (state->debug & DEBUG_STATS)) {
+        PySys_FormatStderr("gc: parked %zd tasklets and %zd frames\n",
+                           n_tasklets, n_frames);
+    }
+}
+#endif
+
 /* Clear all free lists
  * All free lists are cleared during the collection of the highest generation.
  * Allocated items in the free list may keep a pymalloc arena occupied.
@@ -971,6 +1138,8 @@ collect(struct _gc_runtime_state *state, int generation,
     int i;
     Py_ssize_t m = 0; /* # objects collected */
     Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    Py_ssize_t untracked = 0; /* # objects untracked by untrack_young() */
+    Py_ssize_t kept = 0; /* # objects examined by untrack_young() */
     PyGC_Head *young; /* the generation we are examining */
     PyGC_Head *old; /* next older generation */
 #ifdef STACKLESS
@@ -985,6 +1154,7 @@ collect(struct _gc_runtime_state *state, int generation,
 #endif
     PyGC_Head *gc;
     _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
+    _PyTime_t t_start = _PyTime_GetPerfCounter();
 
     if (state->debug & DEBUG_STATS) {
         PySys_WriteStderr("gc: collecting generation %d...\n",
@@ -995,6 +1165,10 @@ collect(struct _gc_runtime_state *state, int generation,
                               gc_list_size(GEN_HEAD(state, i)));
         PySys_WriteStderr("\ngc: objects in permanent generation: %zd",
                          gc_list_size(&state->permanent_generation.head));
+#ifdef STACKLESS
+        PySys_WriteStderr("\ngc: objects in parked generation: %zd",
+                         gc_list_size(PARKED_HEAD(state)));
+#endif
         t1 = _PyTime_GetMonotonicClock();
 
         PySys_WriteStderr("\n");
@@ -1009,6 +1183,13 @@ collect(struct _gc_runtime_state *state, int generation,
     for (i = 0; i <= generation; i++)
         state->generations[i].count = 0;
 
+#ifdef STACKLESS
+    if (generation == NUM_GENERATIONS-1 && !state->incremental_slice &&
+        state->park_limit > 0 && state->parked_pending > state->park_limit) {
+        unpark_all(state);
+    }
+#endif
+
     /* merge younger generations with one we are currently collecting */
     for (i = 0; i < generation; i++) {
         gc_list_merge(GEN_HEAD(state, i), GEN_HEAD(state, generation));
@@ -1020,9 +1201,25 @@ collect(struct _gc_runtime_state *state, int generation,
         old = GEN_HEAD(state, generation+1);
     else
         old = young;
+#ifdef PREV_MASK_VISITED
+    /* New members of the oldest generation must be marked as unvisited
+     * for the incremental collection.  Collect them aside first. */
+    if (generation == NUM_GENERATIONS-2 && state->incremental_budget > 0) {
+        old = &state->incremental_rest;
+    }
+#endif
 
     validate_list(young, 0);
     validate_list(old, 0);
+    if (generation == 0) {
+        untracked = untrack_young(young, UNTRACK_DICT_MAX, &kept);
+    }
+    else if (generation == NUM_GENERATIONS-1) {
+        untracked = untrack_young(young, PY_SSIZE_T_MAX, &kept);
+    }
+    else {
+        untracked = untrack_young(young, -1, &kept);
+    }
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
      * refcount greater than 0 when all the references within the
@@ -1041,20 +1238,26 @@ collect(struct _gc_runtime_state *state, int generation,
     move_unreachable(young, &unreachable);  // gc_prev is pointer again
     validate_list(young, 0);
 
-    untrack_tuples(young);
     /* Move reachable objects to next generation. */
     if (young != old) {
         if (generation == NUM_GENERATIONS - 2) {
-            state->long_lived_pending += gc_list_size(young);
+            Py_ssize_t promoted = gc_list_size(young);
+            state->long_lived_pending += promoted;
+            state->incremental_promoted += promoted;
         }
         gc_list_merge(young, old);
     }
     else {
-        /* We only untrack dicts in full collections, to avoid quadratic
-           dict build-up. See issue #14775. */
-        untrack_dicts(young);
-        state->long_lived_pending = 0;
-        state->long_lived_total = gc_list_size(young);
+        if (!state->incremental_slice) {
+            state->long_lived_pending = 0;
+            state->long_lived_total = gc_list_size(young);
+            /* all objects are unvisited after a full collection */
+            state->visited_space = 1;
+            state->incremental_truncated = 0;
+            state->incremental_survivors = 0;
+            state->incremental_promoted = 0;
+            state->incremental_fallback = 0;
+        }
     }
 
     /* All objects in unreachable are trash, but objects reachable from
@@ -1130,10 +1333,28 @@ collect(struct _gc_runtime_state *state, int generation,
     handle_legacy_finalizers(state, &finalizers, old);
     validate_list(old, 0);
 
-    /* Clear free list only during the collection of the highest
-     * generation */
-    if (generation == NUM_GENERATIONS-1) {
+#ifdef PREV_MASK_VISITED
+    if (old == &state->incremental_rest) {
+        for (gc = GC_NEXT(old); gc != old; gc = GC_NEXT(gc)) {
+            gc_set_visited(state, gc, 0);
+        }
+        gc_list_merge(old, GEN_HEAD(state, NUM_GENERATIONS-1));
+    }
+#endif
+
+#ifdef STACKLESS
+    if (generation == NUM_GENERATIONS-1 && !state->incremental_slice &&
+        state->park_threshold > 0) {
+        park_blocked_tasklets(state, old);
+    }
+#endif
+
+    /* Clear free list and return the pymalloc pools of idle threads only
+     * during the collection of the highest generation.  The incremental
+     * collection does this at the end of a round. */
+    if (generation == NUM_GENERATIONS-1 && !state->incremental_slice) {
         clear_freelists();
+        _PyObject_ReturnIdleThreadPools();
     }
 
     if (PyErr_Occurred()) {
@@ -1156,10 +1377,19 @@ collect(struct _gc_runtime_state *state, int generation,
         *n_uncollectable = n;
     }
 
-    struct gc_generation_stats *stats = &state->generation_stats[generation];
-    stats->collections++;
-    stats->collected += m;
-    stats->uncollectable += n;
+    /* A slice of the incremental collection has its own stats */
+    if (!state->incremental_slice) {
+        struct gc_generation_stats *stats = &state->generation_stats[generation];
+        stats->collections++;
+        stats->collected += m;
+        stats->uncollectable += n;
+        stats->duration += _PyTime_GetPerfCounter() - t_start;
+        stats->untracked += untracked;
+        stats->kept += kept;
+    }
+    else {
+        state->incremental_stats.collected += m;
+    }
 
     if (PyDTrace_GC_DONE_ENABLED()) {
         PyDTrace_GC_DONE(n+m);
@@ -1228,6 +1458,256 @@ collect_with_callback(struct _gc_runtime_state *state, int generation)
     return result;
 }
 
+/* Incremental collection of the oldest generation
+ *
+ * A full collection examines all objects of the oldest generation at once,
+ * which pauses a program with a large heap for a long time.  If a time
+ * budget is set with gc.set_incremental(), automatic collections of the
+ * oldest generation are split into slices instead.  A slice collects an
+ * increment, which consists of the young generations and a part of the
+ * oldest generation.  Collecting a subset of all objects is always safe,
+ * because references from outside of the subset keep its objects alive.
+ * To find garbage cycles, the increment is grown from unvisited objects of
+ * the oldest generation by adding all unvisited objects they refer to,
+ * until the size limit derived from the budget is reached.
+ *
+ * The survivors of a slice are marked as visited and are not added to
+ * further increments of the current round.  The oldest generation is kept
+ * in order: visited objects first, unvisited objects last.  A round is
+ * complete, when an increment takes the last unvisited objects.  Then the
+ * meaning of the visited flag is inverted, which marks all objects as
+ * unvisited at once.
+ *
+ * A garbage cycle, that is split by the size limit, survives its slice.
+ * Therefore a round with a truncated increment is followed by a full
+ * collection, if the survivors of the round exceed the survivors of the
+ * previous round by more than 25%.
+ */
+
+/* minimum number of objects added to an increment */
+#define MIN_INCREMENT 1000
+
+/* upper bounds of the buckets of the slice pause histogram in ms */
+static const double slice_pause_bounds[GC_SLICE_PAUSE_BUCKETS-1] = {
+    0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50, 100
+};
+
+#ifdef PREV_MASK_VISITED
+
+struct increment {
+    struct _gc_runtime_state *state;
+    PyGC_Head *head;
+    Py_ssize_t size;
+    Py_ssize_t limit;
+    int truncated;
+};
+
+/* A traversal callback for build_increment. */
+static int
+visit_increment(PyObject *op, struct increment *inc)
+{
+    if (!PyObject_IS_GC(op)) {
+        return 0;
+    }
+    PyGC_Head *gc = AS_GC(op);
+    // Ignore untracked objects and objects already in the increment.
+    if (gc->_gc_next == 0 || gc_is_collecting(gc) ||
+        gc_is_visited(inc->state, gc)) {
+        return 0;
+    }
+    if (inc->size >= inc->limit) {
+        /* stop the traversal of a large container */
+        inc->truncated = 1;
+        return 1;
+    }
+    gc_list_move(gc, inc->head);
+    gc->_gc_prev |= PREV_MASK_COLLECTING;
+    inc->size++;
+    return 0;
+}
+
+/* Add unvisited objects from the end of rest and the objects reachable
+ * from them and from the young objects already in the increment.  We
+ * temporarily use the PREV_MASK_COLLECTING flag to mark the members of
+ * the increment.
+ */
+static void
+build_increment(struct increment *inc, PyGC_Head *rest, Py_ssize_t limit)
+{
+    PyGC_Head *head = inc->head;
+    PyGC_Head *gc;
+
+    for (gc = GC_NEXT(head); gc != head; gc = GC_NEXT(gc)) {
+        gc->_gc_prev |= PREV_MASK_COLLECTING;
+        inc->size++;
+    }
+    inc->limit = inc->size + Py_MAX(limit - inc->size, MIN_INCREMENT);
+
+    gc = head;
+    for (;;) {
+        /* traverse the objects in the order they were added */
+        while (GC_NEXT(gc) != head && !inc->truncated) {
+            gc = GC_NEXT(gc);
+            PyObject *op = FROM_GC(gc);
+            (void) Py_TYPE(op)->tp_traverse(op,
+                                            (visitproc)visit_increment,
+                                            inc);
+        }
+        if (inc->truncated || inc->size >= inc->limit) {
+            break;
+        }
+        PyGC_Head *seed = GC_PREV(rest);
+        if (seed == rest || gc_is_visited(inc->state, seed)) {
+            break;
+        }
+        gc_list_move(seed, head);
+        seed->_gc_prev |= PREV_MASK_COLLECTING;
+        inc->size++;
+    }
+
+    for (gc = GC_NEXT(head); gc != head; gc = GC_NEXT(gc)) {
+        gc_clear_collecting(gc);
+    }
+}
+
+/* Start a new round with all objects of the oldest generation unvisited. */
+static void
+restart_incremental(struct _gc_runtime_state *state)
+{
+    PyGC_Head *lists[] = {GEN_HEAD(state, NUM_GENERATIONS-1),
+                          &state->incremental_rest};
+    for (int i = 0; i < 2; i++) {
+        PyGC_Head *gc;
+        for (gc = GC_NEXT(lists[i]); gc != lists[i]; gc = GC_NEXT(gc)) {
+            gc_set_visited(state, gc, 0);
+        }
+    }
+    state->incremental_truncated = 0;
+    state->incremental_survivors = 0;
+    state->incremental_promoted = 0;
+    state->incremental_fallback = 0;
+}
+
+/* Return the number of objects a slice can examine within the budget. */
+static Py_ssize_t
+increment_limit(struct _gc_runtime_state *state)
+{
+    return (Py_ssize_t)(state->incremental_budget /
+                        state->incremental_ns_per_object);
+}
+
+/* Return true if the next slice is due.  Slices are collected more often
+ * than full collections: whenever the oldest generation reaches its
+ * threshold or the promoted objects would exceed the budget of a slice.
+ */
+static int
+increment_due(struct _gc_runtime_state *state)
+{
+    struct gc_generation *gen = &state->generations[NUM_GENERATIONS-1];
+    return (gen->count > gen->threshold ||
+            4 * state->incremental_promoted > increment_limit(state));
+}
+
+/* Collect the next slice of the incremental collection. */
+static Py_ssize_t
+collect_increment(struct _gc_runtime_state *state)
+{
+    PyGC_Head *old = GEN_HEAD(state, NUM_GENERATIONS-1);
+    PyGC_Head *rest = &state->incremental_rest;
+    struct gc_incremental_stats *stats = &state->incremental_stats;
+    PyGC_Head *gc;
+    Py_ssize_t n, survivors = 0;
+    int i, round_done;
+
+    if (state->incremental_fallback) {
+        stats->fallbacks++;
+        return collect_with_callback(state, NUM_GENERATIONS-1);
+    }
+
+#ifdef STACKLESS
+    /* An increment could take parked objects, like frozen objects.  Merge
+     * them back as unvisited objects, which belong to the end of the
+     * oldest generation. */
+    for (gc = GC_NEXT(PARKED_HEAD(state)); gc != PARKED_HEAD(state);
+         gc = GC_NEXT(gc)) {
+        gc_set_visited(state, gc, 0);
+    }
+    unpark_all(state);
+#endif
+
+    _PyTime_t t_start = _PyTime_GetPerfCounter();
+
+    /* The increment takes the place of the oldest generation, while it is
+     * collected.  Keep the rest aside. */
+    assert(gc_list_is_empty(rest));
+    gc_list_merge(old, rest);
+    for (i = 0; i < NUM_GENERATIONS-1; i++) {
+        gc_list_merge(GEN_HEAD(state, i), old);
+    }
+    /* The size limit follows from the budget.  But the increments must
+     * outgrow the objects moved into the oldest generation, or a round
+     * would not end before the garbage accumulates.  With four times the
+     * promoted objects, the oldest generation grows by about a third of
+     * its size during a round. */
+    Py_ssize_t limit = Py_MAX(increment_limit(state),
+                              4 * state->incremental_promoted);
+    state->incremental_promoted = 0;
+    struct increment inc = {state, old, 0, 0, 0};
+    build_increment(&inc, rest, limit);
+    round_done = gc_list_is_empty(rest) || gc_is_visited(state, GC_PREV(rest));
+
+    state->incremental_slice = 1;
+    n = collect_with_callback(state, NUM_GENERATIONS-1);
+    state->incremental_slice = 0;
+
+    for (gc = GC_NEXT(old); gc != old; gc = GC_NEXT(gc)) {
+        gc_set_visited(state, gc, 1);
+        survivors++;
+    }
+    gc_list_merge(rest, old);
+    state->incremental_survivors += survivors;
+    if (inc.truncated) {
+        state->incremental_truncated = 1;
+        stats->truncated++;
+    }
+
+    if (round_done) {
+        stats->rounds++;
+        if (state->incremental_truncated &&
+            state->incremental_survivors - state->long_lived_total >
+            state->long_lived_total / 4) {
+            /* do a full collection instead of the next slice */
+            state->incremental_fallback = 1;
+        }
+        else {
+            state->visited_space = !state->visited_space;
+            state->long_lived_pending = 0;
+            state->long_lived_total = state->incremental_survivors;
+            state->incremental_truncated = 0;
+            state->incremental_survivors = 0;
+            clear_freelists();
+            _PyObject_ReturnIdleThreadPools();
+        }
+    }
+
+    /* Adapt the estimated time per object to the actual pause */
+    _PyTime_t pause = _PyTime_GetPerfCounter() - t_start;
+    _PyTime_t ns = (3 * state->incremental_ns_per_object +
+                    pause / Py_MAX(inc.size, 1)) / 4;
+    state->incremental_ns_per_object = Py_MAX(ns, 1);
+
+    double ms = _PyTime_AsSecondsDouble(pause) * 1e3;
+    for (i = 0; i < GC_SLICE_PAUSE_BUCKETS-1; i++) {
+        if (ms <= slice_pause_bounds[i]) {
+            break;
+        }
+    }
+    stats->pauses[i]++;
+    stats->slices++;
+    return n;
+}
+#endif
+
 static Py_ssize_t
 collect_generations(struct _gc_runtime_state *state)
 {
@@ -1235,6 +1715,15 @@ collect_generations(struct _gc_runtime_state *state)
      * exceeds the threshold.  Objects in the that generation and
      * generations younger than it will be collected. */
     Py_ssize_t n = 0;
+#ifdef PREV_MASK_VISITED
+    /* An increment could take objects from the permanent generation.
+       Don't split the collection while there are frozen objects. */
+    if (state->incremental_budget > 0 &&
+        gc_list_is_empty(&state->permanent_generation.head) &&
+        increment_due(state)) {
+        return collect_increment(state);
+    }
+#endif
     for (int i = NUM_GENERATIONS-1; i >= 0; i--) {
         if (state->generations[i].count > state->generations[i].threshold) {
             /* Avoid quadratic performance degradation in number
@@ -1326,6 +1815,11 @@ gc_collect_impl(PyObject *module, int generation)
     }
     else {
         state->collecting = 1;
+#ifdef STACKLESS
+        if (generation == NUM_GENERATIONS - 1) {
+            unpark_all(state);
+        }
+#endif
         n = collect_with_callback(state, generation);
         state->collecting = 0;
     }
@@ -1475,6 +1969,16 @@ gc_get_referrers(PyObject *self, PyObject *args)
             return NULL;
         }
     }
+    if (!(gc_referrers_for(args, &state->incremental_rest, result))) {
+        Py_DECREF(result);
+        return NULL;
+    }
+#ifdef STACKLESS
+    if (!(gc_referrers_for(args, PARKED_HEAD(state), result))) {
+        Py_DECREF(result);
+        return NULL;
+    }
+#endif
     return result;
 }
 
@@ -1558,6 +2062,10 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
         if (append_objects(result, GEN_HEAD(state, generation))) {
             goto error;
         }
+        if (generation == NUM_GENERATIONS-1 &&
+            append_objects(result, &state->incremental_rest)) {
+            goto error;
+        }
 
         return result;
     }
@@ -1568,6 +2076,14 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
             goto error;
         }
     }
+    if (append_objects(result, &state->incremental_rest)) {
+        goto error;
+    }
+#ifdef STACKLESS
+    if (append_objects(result, PARKED_HEAD(state))) {
+        goto error;
+    }
+#endif
     return result;
 
 error:
@@ -1575,6 +2091,46 @@ error:
     return NULL;
 }
 
+/* Add the stats of the incremental collection to the dictionary of the
+ * oldest generation.  Return 0 if all OK, < 0 on error.
+ */
+static int
+add_incremental_stats(PyObject *dict, struct gc_incremental_stats *st)
+{
+    PyObject *pauses = PyDict_New();
+    if (pauses == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < GC_SLICE_PAUSE_BUCKETS; i++) {
+        double bound = i < GC_SLICE_PAUSE_BUCKETS-1 ?
+            slice_pause_bounds[i] : Py_HUGE_VAL;
+        PyObject *key = PyFloat_FromDouble(bound);
+        PyObject *value = PyLong_FromSsize_t(st->pauses[i]);
+        if (key == NULL || value == NULL ||
+            PyDict_SetItem(pauses, key, value) < 0) {
+            Py_XDECREF(key);
+            Py_XDECREF(value);
+            Py_DECREF(pauses);
+            return -1;
+        }
+        Py_DECREF(key);
+        Py_DECREF(value);
+    }
+    PyObject *stats = Py_BuildValue("{snsnsnsnsnsN}",
+                                    "slices", st->slices,
+                                    "truncated", st->truncated,
+                                    "rounds", st->rounds,
+                                    "fallbacks", st->fallbacks,
+                                    "slice_collected", st->collected,
+                                    "slice_pauses", pauses);
+    if (stats == NULL) {
+        return -1;
+    }
+    int err = PyDict_Update(dict, stats);
+    Py_DECREF(stats);
+    return err;
+}
+
 /*[clinic input]
 gc.get_stats
 
@@ -1587,6 +2143,7 @@ gc_get_stats_impl(PyObject *module)
 {
     int i;
     struct gc_generation_stats stats[NUM_GENERATIONS], *st;
+    struct gc_incremental_stats incremental_stats;
 
     /* To get consistent values despite allocations while constructing
        the result list, we use a snapshot of the running stats. */
@@ -1594,6 +2151,7 @@ gc_get_stats_impl(PyObject *module)
     for (i = 0; i < NUM_GENERATIONS; i++) {
         stats[i] = state->generation_stats[i];
     }
+    incremental_stats = state->incremental_stats;
 
     PyObject *result = PyList_New(0);
     if (result == NULL)
@@ -1602,13 +2160,21 @@ gc_get_stats_impl(PyObject *module)
     for (i = 0; i < NUM_GENERATIONS; i++) {
         PyObject *dict;
         st = &stats[i];
-        dict = Py_BuildValue("{snsnsn}",
+        dict = Py_BuildValue("{snsnsnsdsnsn}",
                              "collections", st->collections,
                              "collected", st->collected,
-                             "uncollectable", st->uncollectable
+                             "uncollectable", st->uncollectable,
+                             "time", _PyTime_AsSecondsDouble(st->duration),
+                             "untracked", st->untracked,
+                             "kept", st->kept
                             );
         if (dict == NULL)
             goto error;
+        if (i == NUM_GENERATIONS-1 &&
+            add_incremental_stats(dict, &incremental_stats) < 0) {
+            Py_DECREF(dict);
+            goto error;
+        }
         if (PyList_Append(result, dict)) {
             Py_DECREF(dict);
             goto error;
@@ -1667,6 +2233,11 @@ gc_freeze_impl(PyObject *module)
         gc_list_merge(GEN_HEAD(state, i), &state->permanent_generation.head);
         state->generations[i].count = 0;
     }
+    gc_list_merge(&state->incremental_rest, &state->permanent_generation.head);
+#ifdef STACKLESS
+    gc_list_merge(PARKED_HEAD(state), &state->permanent_generation.head);
+    state->parked_pending = 0;
+#endif
     Py_RETURN_NONE;
 }
 
@@ -1684,6 +2255,11 @@ gc_unfreeze_impl(PyObject *module)
 {
     struct _gc_runtime_state *state = &_PyRuntime.gc;
     gc_list_merge(&state->permanent_generation.head, GEN_HEAD(state, NUM_GENERATIONS-1));
+#ifdef PREV_MASK_VISITED
+    if (state->incremental_budget > 0) {
+        restart_incremental(state);
+    }
+#endif
     Py_RETURN_NONE;
 }
 
@@ -1700,6 +2276,134 @@ gc_get_freeze_count_impl(PyObject *module)
     return gc_list_size(&_PyRuntime.gc.permanent_generation.head);
 }
 
+/*[clinic input]
+gc.set_incremental
+
+    budget_ms: object
+    /
+
+Set the time budget of a slice of the incremental collection.
+
+Automatic collections of the oldest generation are split into slices, which
+take about budget_ms milliseconds each.  A budget of zero disables
+incremental collection.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_incremental(PyObject *module, PyObject *budget_ms)
+/*[clinic end generated code: output=da79eab74c93b067 input=e3f97edab4130c0d]*/
+{
+    struct _gc_runtime_state *state = &_PyRuntime.gc;
+    _PyTime_t budget;
+    if (_PyTime_FromMillisecondsObject(&budget, budget_ms,
+                                       _PyTime_ROUND_CEILING) < 0) {
+        return NULL;
+    }
+    if (budget < 0) {
+        PyErr_SetString(PyExc_ValueError, "budget must not be negative");
+        return NULL;
+    }
+#ifdef PREV_MASK_VISITED
+    if (budget > 0 && state->incremental_budget == 0) {
+        restart_incremental(state);
+    }
+    state->incremental_budget = budget;
+    Py_RETURN_NONE;
+#else
+    if (budget > 0) {
+        PyErr_SetString(PyExc_NotImplementedError,
+                        "incremental collection is not supported "
+                        "on this platform");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+#endif
+}
+
+/*[clinic input]
+gc.get_incremental
+
+Return the time budget of a slice of the incremental collection in ms.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_incremental_impl(PyObject *module)
+/*[clinic end generated code: output=7dd3078b18c0e4ba input=b1cea09cb1253b9b]*/
+{
+    _PyTime_t budget = _PyRuntime.gc.incremental_budget;
+    return PyFloat_FromDouble(_PyTime_AsSecondsDouble(budget) * 1e3);
+}
+
+#ifdef STACKLESS
+/*[clinic input]
+gc.set_park_threshold
+
+    threshold: int
+    limit: Py_ssize_t = 0
+    /
+
+Set the thresholds of the parked generation.
+
+A tasklet, that stays blocked on a channel during threshold full collections,
+is moved together with its frames into the parked generation.  Automatic
+collections ignore the parked generation.  It is merged back into the oldest
+generation by an explicit full collection or if more than limit objects have
+been parked since the last merge.  A threshold of zero disables parking and
+a limit of zero means no limit.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_park_threshold_impl(PyObject *module, int threshold, Py_ssize_t limit)
+/*[clinic end generated code: output=931fc85e8a491a5e input=15108c19fe6b19fa]*/
+{
+    struct _gc_runtime_state *state = &_PyRuntime.gc;
+    if (threshold < 0 || limit < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "threshold and limit must not be negative");
+        return NULL;
+    }
+    state->park_threshold = threshold;
+    state->park_limit = limit;
+    if (threshold == 0) {
+        unpark_all(state);
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_park_threshold
+
+Return the thresholds of the parked generation as a tuple (threshold, limit).
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_park_threshold_impl(PyObject *module)
+/*[clinic end generated code: output=7ed6388b9ec5e6ac input=1b2de2a85b0ec09a]*/
+{
+    struct _gc_runtime_state *state = &_PyRuntime.gc;
+    return Py_BuildValue("(in)", state->park_threshold, state->park_limit);
+}
+
+/*[clinic input]
+gc.get_parked_stats
+
+Return a dictionary containing statistics of the parked generation.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_parked_stats_impl(PyObject *module)
+/*[clinic end generated code: output=2d01b7231591ecb9 input=a225a94097355855]*/
+{
+    struct _gc_runtime_state *state = &_PyRuntime.gc;
+    struct gc_parked_stats st = state->parked_stats;
+    return Py_BuildValue("{snsnsnsn}",
+                         "objects", gc_list_size(PARKED_HEAD(state)),
+                         "tasklets", st.tasklets,
+                         "frames", st.frames,
+                         "merges", st.merges);
+}
+#endif
+
 
 PyDoc_STRVAR(gc__doc__,
 "This module provides access to the garbage collector for reference cycles.\n"
@@ -1720,7 +2424,15 @@ PyDoc_STRVAR(gc__doc__,
 "get_referents() -- Return the list of objects that an object refers to.\n"
 "freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
 "unfreeze() -- Unfreeze all objects in the permanent generation.\n"
-"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"set_incremental() -- Set the time budget of the incremental collection.\n"
+"get_incremental() -- Return the time budget of the incremental collection.\n"
+#ifdef STACKLESS
+"set_park_threshold() -- Set the thresholds of the parked generation.\n"
+"get_park_threshold() -- Return the thresholds of the parked generation.\n"
+"get_parked_stats() -- Return statistics of the parked generation.\n"
+#endif
+);
 
 static PyMethodDef GcMethods[] = {
     GC_ENABLE_METHODDEF
@@ -1742,6 +2454,11 @@ static PyMethodDef GcMethods[] = {
     GC_FREEZE_METHODDEF
     GC_UNFREEZE_METHODDEF
     GC_GET_FREEZE_COUNT_METHODDEF
+    GC_SET_INCREMENTAL_METHODDEF
+    GC_GET_INCREMENTAL_METHODDEF
+    GC_SET_PARK_THRESHOLD_METHODDEF
+    GC_GET_PARK_THRESHOLD_METHODDEF
+    GC_GET_PARKED_STATS_METHODDEF
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -1815,6 +2532,9 @@ PyGC_Collect(void)
         PyObject *exc, *value, *tb;
         state->collecting = 1;
         PyErr_Fetch(&exc, &value, &tb);
+#ifdef STACKLESS
+        unpark_all(state);
+#endif
         n = collect_with_callback(state, NUM_GENERATIONS - 1);
         PyErr_Restore(exc, value, tb);
         state->collecting = 0;
@@ -1848,6 +2568,9 @@ _PyGC_CollectNoFail(void)
     }
     else {
         state->collecting = 1;
+#ifdef STACKLESS
+        unpark_all(state);
+#endif
         n = collect(state, NUM_GENERATIONS - 1, NULL, NULL, 1);
         state->collecting = 0;
     }
@@ -1104,6 +1104,7 @@ bytearray_dealloc(PyByteArrayObject *self)
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
+#include "stringlib/copy.h"
 #include "stringlib/join.h"
 #include "stringlib/partition.h"
 #include "stringlib/split.h"
@@ -1324,6 +1324,7 @@ PyBytes_AsStringAndSize(PyObject *obj,
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
+#include "stringlib/copy.h"
 #include "stringlib/join.h"
 #include "stringlib/partition.h"
 #include "stringlib/split.h"
@@ -240,6 +240,7 @@ PyCode_New(int argcount, int posonlyargcount, int kwonlyargcount,
     co->co_opcache = NULL;
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
+    co->co_quickened = NULL;
     return co;
 }
 
@@ -259,8 +260,8 @@ _PyCode_InitOpcache(PyCodeObject *co)
         unsigned char opcode = _Py_OPCODE(opcodes[i]);
         i++;  // 'i' is now aligned to (next_instr - first_instr)
 
-        // TODO: LOAD_METHOD, LOAD_ATTR
-        if (opcode == LOAD_GLOBAL) {
+        if (opcode == LOAD_GLOBAL || opcode == LOAD_ATTR ||
+            opcode == LOAD_METHOD) {
             opts++;
             co->co_opcache_map[i] = (unsigned char)opts;
             if (opts > 254) {
@@ -286,6 +287,33 @@ _PyCode_InitOpcache(PyCodeObject *co)
     return 0;
 }
 
+#define CODE_IS_QUICKENED_COPY(co) \
+    ((co)->co_quickened != NULL && \
+     (co)->co_quickened != (_Py_CODEUNIT *)PyBytes_AS_STRING((co)->co_code))
+
+/* Set co->co_quickened. If the bytecode contains pairs of instructions,
+   that can be fused into superinstructions, the interpreter executes a
+   private copy of the bytecode, otherwise co_code itself. On a memory error
+   the interpreter executes co_code. */
+void
+_PyCode_Quicken(PyCodeObject *co)
+{
+    Py_ssize_t size = PyBytes_GET_SIZE(co->co_code);
+    _Py_CODEUNIT *code = (_Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code);
+    _Py_CODEUNIT *copy;
+
+    assert(co->co_quickened == NULL);
+    co->co_quickened = code;
+    copy = (_Py_CODEUNIT *)PyMem_Malloc(size);
+    if (copy == NULL)
+        return;
+    memcpy(copy, code, size);
+    if (_PyCode_FuseSuperinstructions(copy, size / sizeof(_Py_CODEUNIT)))
+        co->co_quickened = copy;
+    else
+        PyMem_Free(copy);
+}
+
 PyCodeObject *
 PyCode_NewEmpty(const char *filename, const char *funcname, int firstlineno)
 {
@@ -516,6 +544,10 @@ code_dealloc(PyCodeObject *co)
     }
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
+    if (CODE_IS_QUICKENED_COPY(co)) {
+        PyMem_Free(co->co_quickened);
+    }
+    co->co_quickened = NULL;
 
     if (co->co_extra != NULL) {
         PyInterpreterState *interp = _PyInterpreterState_GET_UNSAFE();
@@ -570,6 +602,9 @@ code_sizeof(PyCodeObject *co, PyObject *Py_UNUSED(args))
         // co_opcache
         res += co->co_opcache_size * sizeof(_PyOpcache);
     }
+    if (CODE_IS_QUICKENED_COPY(co)) {
+        res += PyBytes_GET_SIZE(co->co_code);
+    }
     return PyLong_FromSsize_t(res);
 }
 
@@ -39,6 +39,9 @@ Size of indices is dk_size.  Type of each index in indices is vary on dk_size:
 * int32 for 2**16 <= dk_size <= 2**31
 * int64 for 2**32 <= dk_size
 
+Large tables with int32 indices also keep a tag of the hash in the high byte
+of each used index, see the comment at DK_TAGS_MINSIZE.
+
 dk_entries is array of PyDictKeyEntry.  It's size is USABLE_FRACTION(dk_size).
 DK_ENTRIES(dk) can be used to get pointer to entries.
 
@@ -116,6 +119,12 @@ converting the dict to the combined table.
 #include "dict-common.h"
 #include "stringlib/eq.h"    /* to get unicode_eq() */
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HAVE_DK_GROUP_SSE2
+#  include <emmintrin.h>
+#endif
+
 /*[clinic input]
 class dict "PyDictObject *" "&PyDict_Type"
 [clinic start generated code]*/
@@ -325,6 +334,155 @@ dictkeys_decref(PyDictKeysObject *dk)
     }
 }
 
+/*
+Tables with DK_TAGS_MINSIZE to DK_TAGS_MAXSIZE slots store a 7 bit tag of the
+scrambled hash in the high byte of each used index and probe groups of
+DK_GROUP_WIDTH consecutive slots instead of single slots.  The indices of a
+group fill a cache line; their tags are compared at once with SSE2
+instructions.  This way a lookup reads only the entries of slots with a
+matching tag, and it stops at the first group that has an empty slot.  For a
+table with a million keys a failed lookup usually touches a single cache
+line, instead of a chain of indices and entries.
+
+The groups are visited in the order of the recurrence explained above, with
+the group number in place of the slot number.  Within a group, the slots are
+visited starting at the slot given by the low bits of the hash, so that
+consecutive ints are still found at the first slot probed.
+
+Smaller tables mostly stay in the cache and probe single slots.  Larger
+tables have too many entries to spare the bits for a tag.  Without SSE2,
+comparing the tags one at a time is slower than probing single slots, so
+the tags are not used; the scalar versions of the group functions only keep
+the code portable.
+*/
+#define DK_GROUP_SHIFT 4
+#define DK_GROUP_WIDTH (1 << DK_GROUP_SHIFT)
+#define DK_TAGS_MINSIZE ((Py_ssize_t)1 << 16)
+#define DK_TAGS_MAXSIZE ((Py_ssize_t)1 << 24)
+#define DK_TAG_IXMASK 0xffffff
+#ifdef HAVE_DK_GROUP_SSE2
+#define DK_HAS_TAGS(dk) \
+    (DK_SIZE(dk) >= DK_TAGS_MINSIZE && DK_SIZE(dk) <= DK_TAGS_MAXSIZE)
+#else
+#define DK_HAS_TAGS(dk) 0
+#endif
+#if SIZEOF_SIZE_T > 4
+#define DK_TAG(hash) \
+    ((int32_t)(((size_t)(hash) * (size_t)0x9E3779B97F4A7C15ULL) >> 57))
+#else
+#define DK_TAG(hash) ((int32_t)(((size_t)(hash) * (size_t)0x9E3779B9UL) >> 25))
+#endif
+
+/* First slot of group g and position of slot i within its group. */
+#define DK_GROUP_START(g) ((g) << DK_GROUP_SHIFT)
+#define DK_GROUP_POS(i) ((unsigned int)(i) & (DK_GROUP_WIDTH - 1))
+#define DK_GROUP(dk, g) (&((int32_t *)(dk)->dk_indices)[DK_GROUP_START(g)])
+
+/* write the tag of hash to the used slot i. */
+static inline void
+dictkeys_set_tag(PyDictKeysObject *keys, Py_ssize_t i, Py_hash_t hash)
+{
+    if (DK_HAS_TAGS(keys)) {
+        int32_t *indices = (int32_t *)(keys->dk_indices);
+        assert(indices[i] >= 0 && indices[i] <= DK_TAG_IXMASK);
+        indices[i] |= DK_TAG(hash) << 24;
+    }
+}
+
+#ifdef HAVE_DK_GROUP_SSE2
+/* Pack the results of four 32 bit compares into a mask of 16 bits. */
+static inline unsigned int
+dk_group_pack(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+    return (unsigned int)_mm_movemask_epi8(
+        _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+}
+
+#define DK_GROUP_LOAD(group, j) \
+    _mm_loadu_si128((const __m128i *)(group) + (j))
+#endif
+
+/* Return a mask of the slots of the group whose tag is equal to tag. */
+static inline unsigned int
+dk_group_match(const int32_t *group, int32_t tag)
+{
+#ifdef HAVE_DK_GROUP_SSE2
+    const __m128i t = _mm_set1_epi32(tag);
+    return dk_group_pack(
+        _mm_cmpeq_epi32(_mm_srli_epi32(DK_GROUP_LOAD(group, 0), 24), t),
+        _mm_cmpeq_epi32(_mm_srli_epi32(DK_GROUP_LOAD(group, 1), 24), t),
+        _mm_cmpeq_epi32(_mm_srli_epi32(DK_GROUP_LOAD(group, 2), 24), t),
+        _mm_cmpeq_epi32(_mm_srli_epi32(DK_GROUP_LOAD(group, 3), 24), t));
+#else
+    unsigned int m = 0;
+    for (int j = 0; j < DK_GROUP_WIDTH; j++) {
+        m |= (unsigned int)(group[j] >= 0 && (group[j] >> 24) == tag) << j;
+    }
+    return m;
+#endif
+}
+
+/* Return a mask of the empty slots of the group. */
+static inline unsigned int
+dk_group_match_empty(const int32_t *group)
+{
+#ifdef HAVE_DK_GROUP_SSE2
+    const __m128i e = _mm_set1_epi32(DKIX_EMPTY);
+    return dk_group_pack(_mm_cmpeq_epi32(DK_GROUP_LOAD(group, 0), e),
+                         _mm_cmpeq_epi32(DK_GROUP_LOAD(group, 1), e),
+                         _mm_cmpeq_epi32(DK_GROUP_LOAD(group, 2), e),
+                         _mm_cmpeq_epi32(DK_GROUP_LOAD(group, 3), e));
+#else
+    unsigned int m = 0;
+    for (int j = 0; j < DK_GROUP_WIDTH; j++) {
+        m |= (unsigned int)(group[j] == DKIX_EMPTY) << j;
+    }
+    return m;
+#endif
+}
+
+/* Return a mask of the empty and dummy slots of the group. */
+static inline unsigned int
+dk_group_match_free(const int32_t *group)
+{
+#ifdef HAVE_DK_GROUP_SSE2
+    /* the saturating packs keep the sign of the indices */
+    return dk_group_pack(DK_GROUP_LOAD(group, 0), DK_GROUP_LOAD(group, 1),
+                         DK_GROUP_LOAD(group, 2), DK_GROUP_LOAD(group, 3));
+#else
+    unsigned int m = 0;
+    for (int j = 0; j < DK_GROUP_WIDTH; j++) {
+        m |= (unsigned int)(group[j] < 0) << j;
+    }
+    return m;
+#endif
+}
+
+/* Rotate the mask m of a group, so that bit 0 stands for the slot at
+   position pos. */
+static inline unsigned int
+dk_group_rotate(unsigned int m, unsigned int pos)
+{
+    return ((m | (m << DK_GROUP_WIDTH)) >> pos) & ((1U << DK_GROUP_WIDTH) - 1);
+}
+
+/* Return the slot for the lowest bit of the rotated mask m of group g. */
+static inline size_t
+dk_group_slot(size_t g, unsigned int pos, unsigned int m)
+{
+    unsigned int j;
+
+    assert(m != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    j = (unsigned int)__builtin_ctz(m);
+#else
+    for (j = 0; !(m & 1); j++) {
+        m >>= 1;
+    }
+#endif
+    return DK_GROUP_START(g) + DK_GROUP_POS(pos + j);
+}
+
 /* lookup indices.  returns DKIX_EMPTY, DKIX_DUMMY, or ix >=0 */
 static inline Py_ssize_t
 dictkeys_get_index(PyDictKeysObject *keys, Py_ssize_t i)
@@ -349,6 +507,9 @@ dictkeys_get_index(PyDictKeysObject *keys, Py_ssize_t i)
     else {
         int32_t *indices = (int32_t*)(keys->dk_indices);
         ix = indices[i];
+        if (ix >= 0 && s <= DK_TAGS_MAXSIZE) {
+            ix &= DK_TAG_IXMASK;
+        }
     }
     assert(ix >= DKIX_DUMMY);
     return ix;
@@ -698,10 +859,42 @@ PyDict_New(void)
     return new_dict(Py_EMPTY_KEYS, empty_values);
 }
 
+/* Version of lookdict_index() for tables with tags */
+static Py_ssize_t
+lookdict_index_grouped(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
+{
+    int32_t tag = DK_TAG(hash);
+    size_t gmask = DK_MASK(k) >> DK_GROUP_SHIFT;
+    size_t perturb = (size_t)hash;
+    size_t g = ((size_t)hash & DK_MASK(k)) >> DK_GROUP_SHIFT;
+    unsigned int pos = DK_GROUP_POS(hash);
+
+    for (;;) {
+        const int32_t *group = DK_GROUP(k, g);
+        unsigned int m = dk_group_rotate(dk_group_match(group, tag), pos);
+        for (; m; m &= m - 1) {
+            size_t i = dk_group_slot(g, pos, m);
+            if (dictkeys_get_index(k, i) == index) {
+                return i;
+            }
+        }
+        if (dk_group_match_empty(group)) {
+            return DKIX_EMPTY;
+        }
+        perturb >>= PERTURB_SHIFT;
+        g = gmask & (g*5 + perturb + 1);
+    }
+    Py_UNREACHABLE();
+}
+
 /* Search index of hash table from offset of entry table */
 static Py_ssize_t
 lookdict_index(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
 {
+    if (DK_HAS_TAGS(k)) {
+        return lookdict_index_grouped(k, hash, index);
+    }
+
     size_t mask = DK_MASK(k);
     size_t perturb = (size_t)hash;
     size_t i = (size_t)hash & mask;
@@ -720,6 +913,97 @@ lookdict_index(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
     Py_UNREACHABLE();
 }
 
+/* Versions of lookdict() and lookdict_unicode() for tables with tags, see
+   the comment at DK_TAGS_MINSIZE. */
+static Py_ssize_t
+lookdict_grouped(PyDictObject *mp, PyObject *key,
+                 Py_hash_t hash, PyObject **value_addr)
+{
+    PyDictKeysObject *dk = mp->ma_keys;
+    PyDictKeyEntry *ep0 = DK_ENTRIES(dk);
+    int32_t tag = DK_TAG(hash);
+    size_t gmask = DK_MASK(dk) >> DK_GROUP_SHIFT;
+    size_t perturb = (size_t)hash;
+    size_t g = ((size_t)hash & DK_MASK(dk)) >> DK_GROUP_SHIFT;
+    unsigned int pos = DK_GROUP_POS(hash);
+
+    for (;;) {
+        const int32_t *group = DK_GROUP(dk, g);
+        unsigned int m = dk_group_rotate(dk_group_match(group, tag), pos);
+        for (; m; m &= m - 1) {
+            Py_ssize_t ix = dictkeys_get_index(dk, dk_group_slot(g, pos, m));
+            assert(ix >= 0);
+            PyDictKeyEntry *ep = &ep0[ix];
+            assert(ep->me_key != NULL);
+            if (ep->me_key == key) {
+                *value_addr = ep->me_value;
+                return ix;
+            }
+            if (ep->me_hash == hash) {
+                PyObject *startkey = ep->me_key;
+                Py_INCREF(startkey);
+                int cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+                Py_DECREF(startkey);
+                if (cmp < 0) {
+                    *value_addr = NULL;
+                    return DKIX_ERROR;
+                }
+                if (dk == mp->ma_keys && ep->me_key == startkey) {
+                    if (cmp > 0) {
+                        *value_addr = ep->me_value;
+                        return ix;
+                    }
+                }
+                else {
+                    /* The dict was mutated, restart */
+                    return lookdict(mp, key, hash, value_addr);
+                }
+            }
+        }
+        if (dk_group_match_empty(group)) {
+            *value_addr = NULL;
+            return DKIX_EMPTY;
+        }
+        perturb >>= PERTURB_SHIFT;
+        g = gmask & (g*5 + perturb + 1);
+    }
+    Py_UNREACHABLE();
+}
+
+/* Return the index of the entry of the exact str key or DKIX_EMPTY */
+static Py_ssize_t
+lookdict_unicode_grouped(PyDictKeysObject *dk, PyObject *key, Py_hash_t hash)
+{
+    PyDictKeyEntry *ep0 = DK_ENTRIES(dk);
+    int32_t tag = DK_TAG(hash);
+    size_t gmask = DK_MASK(dk) >> DK_GROUP_SHIFT;
+    size_t perturb = (size_t)hash;
+    size_t g = ((size_t)hash & DK_MASK(dk)) >> DK_GROUP_SHIFT;
+    unsigned int pos = DK_GROUP_POS(hash);
+
+    for (;;) {
+        const int32_t *group = DK_GROUP(dk, g);
+        unsigned int m = dk_group_rotate(dk_group_match(group, tag), pos);
+        for (; m; m &= m - 1) {
+            Py_ssize_t ix = dictkeys_get_index(dk, dk_group_slot(g, pos, m));
+            assert(ix >= 0);
+            PyDictKeyEntry *ep = &ep0[ix];
+            assert(ep->me_key != NULL);
+            assert(PyUnicode_CheckExact(ep->me_key));
+            if (ep->me_key == key ||
+                    (ep->me_hash == hash && unicode_eq(ep->me_key, key))) {
+                return ix;
+            }
+        }
+        if (dk_group_match_empty(group)) {
+            return DKIX_EMPTY;
+        }
+        perturb >>= PERTURB_SHIFT;
+        g = gmask & (g*5 + perturb + 1);
+    }
+    Py_UNREACHABLE();
+}
+
 /*
 The basic lookup function used by all operations.
 This is based on Algorithm D from Knuth Vol. 3, Sec. 6.4.
@@ -754,6 +1038,9 @@ lookdict(PyDictObject *mp, PyObject *key,
 
 top:
     dk = mp->ma_keys;
+    if (DK_HAS_TAGS(dk)) {
+        return lookdict_grouped(mp, key, hash, value_addr);
+    }
     ep0 = DK_ENTRIES(dk);
     mask = DK_MASK(dk);
     perturb = hash;
@@ -815,6 +1102,11 @@ lookdict_unicode(PyDictObject *mp, PyObject *key,
     }
 
     PyDictKeyEntry *ep0 = DK_ENTRIES(mp->ma_keys);
+    if (DK_HAS_TAGS(mp->ma_keys)) {
+        Py_ssize_t ix = lookdict_unicode_grouped(mp->ma_keys, key, hash);
+        *value_addr = ix >= 0 ? ep0[ix].me_value : NULL;
+        return ix;
+    }
     size_t mask = DK_MASK(mp->ma_keys);
     size_t perturb = (size_t)hash;
     size_t i = (size_t)hash & mask;
@@ -858,6 +1150,11 @@ lookdict_unicode_nodummy(PyDictObject *mp, PyObject *key,
     }
 
     PyDictKeyEntry *ep0 = DK_ENTRIES(mp->ma_keys);
+    if (DK_HAS_TAGS(mp->ma_keys)) {
+        Py_ssize_t ix = lookdict_unicode_grouped(mp->ma_keys, key, hash);
+        *value_addr = ix >= 0 ? ep0[ix].me_value : NULL;
+        return ix;
+    }
     size_t mask = DK_MASK(mp->ma_keys);
     size_t perturb = (size_t)hash;
     size_t i = (size_t)hash & mask;
@@ -903,6 +1200,11 @@ lookdict_split(PyDictObject *mp, PyObject *key,
     }
 
     PyDictKeyEntry *ep0 = DK_ENTRIES(mp->ma_keys);
+    if (DK_HAS_TAGS(mp->ma_keys)) {
+        Py_ssize_t ix = lookdict_unicode_grouped(mp->ma_keys, key, hash);
+        *value_addr = ix >= 0 ? mp->ma_values[ix] : NULL;
+        return ix;
+    }
     size_t mask = DK_MASK(mp->ma_keys);
     size_t perturb = (size_t)hash;
     size_t i = (size_t)hash & mask;
@@ -998,6 +1300,20 @@ find_empty_slot(PyDictKeysObject *keys, Py_hash_t hash)
 {
     assert(keys != NULL);
 
+    if (DK_HAS_TAGS(keys)) {
+        size_t gmask = DK_MASK(keys) >> DK_GROUP_SHIFT;
+        size_t g = ((size_t)hash & DK_MASK(keys)) >> DK_GROUP_SHIFT;
+        unsigned int pos = DK_GROUP_POS(hash);
+        for (size_t perturb = hash;;) {
+            unsigned int m = dk_group_match_free(DK_GROUP(keys, g));
+            if (m) {
+                return dk_group_slot(g, pos, dk_group_rotate(m, pos));
+            }
+            perturb >>= PERTURB_SHIFT;
+            g = gmask & (g*5 + perturb + 1);
+        }
+    }
+
     const size_t mask = DK_MASK(keys);
     size_t i = hash & mask;
     Py_ssize_t ix = dictkeys_get_index(keys, i);
@@ -1062,6 +1378,7 @@ insertdict(PyDictObject *mp, PyObject *key, Py_hash_t hash, PyObject *value)
         Py_ssize_t hashpos = find_empty_slot(mp->ma_keys, hash);
         ep = &DK_ENTRIES(mp->ma_keys)[mp->ma_keys->dk_nentries];
         dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_set_tag(mp->ma_keys, hashpos, hash);
         ep->me_key = key;
         ep->me_hash = hash;
         if (mp->ma_values) {
@@ -1147,6 +1464,14 @@ Internal routine used by dictresize() to build a hashtable of entries.
 static void
 build_indices(PyDictKeysObject *keys, PyDictKeyEntry *ep, Py_ssize_t n)
 {
+    if (DK_HAS_TAGS(keys)) {
+        for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
+            Py_ssize_t i = find_empty_slot(keys, ep->me_hash);
+            dictkeys_set_index(keys, i, ix);
+            dictkeys_set_tag(keys, i, ep->me_hash);
+        }
+        return;
+    }
     size_t mask = (size_t)DK_SIZE(keys) - 1;
     for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
         Py_hash_t hash = ep->me_hash;
@@ -1418,6 +1743,52 @@ _PyDict_GetItem_KnownHash(PyObject *op, PyObject *key, Py_hash_t hash)
     return value;
 }
 
+/* Lookup the string key in an exact dict using the index of the entry
+   found by a previous lookup as a hint. Used by the opcode cache of
+   LOAD_ATTR and LOAD_METHOD.
+
+   Return the index of the entry and store a borrowed reference to the value
+   in *value. If the key wasn't present, store NULL in *value and return a
+   negative number. This returns a negative number *with* an exception set
+   if an exception occurred.
+*/
+Py_ssize_t
+_PyDict_GetItemHint(PyDictObject *mp, PyObject *key,
+                    Py_ssize_t hint, PyObject **value)
+{
+    Py_hash_t hash;
+    PyObject *res;
+
+    assert(*value == NULL);
+    assert(PyDict_CheckExact((PyObject *)mp));
+    assert(PyUnicode_CheckExact(key));
+
+    if (hint >= 0 && hint < mp->ma_keys->dk_nentries) {
+        PyDictKeyEntry *ep = DK_ENTRIES(mp->ma_keys) + (size_t)hint;
+        if (ep->me_key == key) {
+            if (mp->ma_values != NULL) {
+                res = mp->ma_values[(size_t)hint];
+            }
+            else {
+                res = ep->me_value;
+            }
+            if (res != NULL) {
+                *value = res;
+                return hint;
+            }
+        }
+    }
+
+    hash = ((PyASCIIObject *) key)->hash;
+    if (hash == -1) {
+        hash = PyObject_Hash(key);
+        if (hash == -1) {
+            return DKIX_ERROR;
+        }
+    }
+    return (mp->ma_keys->dk_lookup)(mp, key, hash, value);
+}
+
 /* Variant of PyDict_GetItem() that doesn't suppress exceptions.
    This returns NULL *with* an exception set if an exception occurred.
    It returns NULL *without* an exception set if the key wasn't present.
@@ -1645,7 +2016,7 @@ int
 _PyDict_DelItemIf(PyObject *op, PyObject *key,
                   int (*predicate)(PyObject *value))
 {
-    Py_ssize_t hashpos, ix;
+    Py_ssize_t ix;
     PyDictObject *mp;
     Py_hash_t hash;
     PyObject *old_value;
@@ -1681,11 +2052,8 @@ _PyDict_DelItemIf(PyObject *op, PyObject *key,
     if (res == -1)
         return -1;
 
-    hashpos = lookdict_index(mp->ma_keys, hash, ix);
-    assert(hashpos >= 0);
-
     if (res > 0)
-        return delitem_common(mp, hashpos, ix, old_value);
+        return delitem_common(mp, hash, ix, old_value);
     else
         return 0;
 }
@@ -1741,7 +2109,7 @@ _PyDict_Next(PyObject *op, Py_ssize_t *ppos, PyObject **pkey,
     PyDictKeyEntry *entry_ptr;
     PyObject *value;
 
-    if (!PyDict_Check(op))
+    if (!PyDict_Check(op) && !PyFrozenDict_Check(op))
         return 0;
     mp = (PyDictObject *)op;
     i = *ppos;
@@ -2466,7 +2834,8 @@ dict_merge(PyObject *a, PyObject *b, int override)
         return -1;
     }
     mp = (PyDictObject*)a;
-    if (PyDict_Check(b) && (Py_TYPE(b)->tp_iter == (getiterfunc)dict_iter)) {
+    if ((PyDict_Check(b) || PyFrozenDict_Check(b)) &&
+            (Py_TYPE(b)->tp_iter == (getiterfunc)dict_iter)) {
         other = (PyDictObject*)b;
         if (other == mp || other->ma_used == 0)
             /* a.update(a) or a.update({}); nothing to do */
@@ -2923,6 +3292,7 @@ PyDict_SetDefault(PyObject *d, PyObject *key, PyObject *defaultobj)
         ep0 = DK_ENTRIES(mp->ma_keys);
         ep = &ep0[mp->ma_keys->dk_nentries];
         dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_set_tag(mp->ma_keys, hashpos, hash);
         Py_INCREF(key);
         Py_INCREF(value);
         MAINTAIN_TRACKING(mp, key, value);
@@ -3520,7 +3890,7 @@ dictiter_iternextkey(dictiterobject *di)
 
     if (d == NULL)
         return NULL;
-    assert (PyDict_Check(d));
+    assert (PyDict_Check(d) || PyFrozenDict_Check(d));
 
     if (di->di_used != d->ma_used) {
         PyErr_SetString(PyExc_RuntimeError,
@@ -3608,7 +3978,7 @@ dictiter_iternextvalue(dictiterobject *di)
 
     if (d == NULL)
         return NULL;
-    assert (PyDict_Check(d));
+    assert (PyDict_Check(d) || PyFrozenDict_Check(d));
 
     if (di->di_used != d->ma_used) {
         PyErr_SetString(PyExc_RuntimeError,
@@ -3695,7 +4065,7 @@ dictiter_iternextitem(dictiterobject *di)
 
     if (d == NULL)
         return NULL;
-    assert (PyDict_Check(d));
+    assert (PyDict_Check(d) || PyFrozenDict_Check(d));
 
     if (di->di_used != d->ma_used) {
         PyErr_SetString(PyExc_RuntimeError,
@@ -3804,7 +4174,7 @@ dictreviter_iternext(dictiterobject *di)
     if (d == NULL) {
         return NULL;
     }
-    assert (PyDict_Check(d));
+    assert (PyDict_Check(d) || PyFrozenDict_Check(d));
 
     if (di->di_used != d->ma_used) {
         PyErr_SetString(PyExc_RuntimeError,
@@ -3904,7 +4274,7 @@ static PyObject *
 dict___reversed___impl(PyDictObject *self)
 /*[clinic end generated code: output=e674483336d1ed51 input=23210ef3477d8c4d]*/
 {
-    assert (PyDict_Check(self));
+    assert (PyDict_Check(self) || PyFrozenDict_Check(self));
     return dictiter_new(self, &PyDictRevIterKey_Type);
 }
 
@@ -3987,7 +4357,7 @@ _PyDictView_New(PyObject *dict, PyTypeObject *type)
         PyErr_BadInternalCall();
         return NULL;
     }
-    if (!PyDict_Check(dict)) {
+    if (!PyDict_Check(dict) && !PyFrozenDict_Check(dict)) {
         /* XXX Get rid of this restriction later */
         PyErr_Format(PyExc_TypeError,
                      "%s() requires a dict argument, not '%s'",
@@ -4375,6 +4745,23 @@ dictitems_iter(_PyDictViewObject *dv)
     return dictiter_new(dv->dv_dict, &PyDictIterItem_Type);
 }
 
+/* Like PyDict_GetItemWithError(), but also for a FrozenDict */
+static PyObject *
+view_getitem(PyDictObject *mp, PyObject *key)
+{
+    Py_hash_t hash;
+    PyObject *value;
+
+    if (!PyUnicode_CheckExact(key) ||
+        (hash = ((PyASCIIObject *) key)->hash) == -1) {
+        hash = PyObject_Hash(key);
+        if (hash == -1)
+            return NULL;
+    }
+    (mp->ma_keys->dk_lookup)(mp, key, hash, &value);
+    return value;
+}
+
 static int
 dictitems_contains(_PyDictViewObject *dv, PyObject *obj)
 {
@@ -4386,7 +4773,7 @@ dictitems_contains(_PyDictViewObject *dv, PyObject *obj)
         return 0;
     key = PyTuple_GET_ITEM(obj, 0);
     value = PyTuple_GET_ITEM(obj, 1);
-    found = PyDict_GetItemWithError((PyObject *)dv->dv_dict, key);
+    found = view_getitem(dv->dv_dict, key);
     if (found == NULL) {
         if (PyErr_Occurred())
             return -1;
@@ -4567,13 +4954,275 @@ _PyDict_NewKeysForClass(void)
 
 #define CACHED_KEYS(tp) (((PyHeapTypeObject*)tp)->ht_cached_keys)
 
+/* Inline values
+
+   Instances of types with the Py_TPFLAGS_INLINE_VALUES flag don't need a
+   dict for their attributes.  As long as the attributes of an instance are
+   a prefix of the shared keys of its type (in the order of the keys), the
+   __dict__ slot of the instance holds a tagged pointer to an array of the
+   attribute values.  The array also holds a reference to the keys, because
+   the type may replace its shared keys later.  This saves the dict object
+   and its GC header.
+
+   The dict gets created on demand, if the __dict__ attribute or
+   _PyObject_GetDictPtr() is used or if an attribute gets deleted or doesn't
+   fit into the keys.  Only the functions below, the generic attribute
+   functions in Objects/object.c, the subtype functions in
+   Objects/typeobject.c and LOAD_ATTR and LOAD_METHOD in Python/ceval.c
+   access inline values.
+*/
+
+typedef struct {
+    PyDictKeysObject *iv_keys;
+    PyObject *iv_values[1];
+} PyInlineValues;
+
+#define INLINE_VALUES_TAG ((uintptr_t)1)
+#define INLINE_VALUES_FROM_SLOT(op) \
+    ((PyInlineValues *)((uintptr_t)(op) & ~INLINE_VALUES_TAG))
+#define INLINE_VALUES_TO_SLOT(iv) \
+    ((PyObject *)((uintptr_t)(iv) | INLINE_VALUES_TAG))
+#define INLINE_VALUES_SIZE(iv) USABLE_FRACTION(DK_SIZE((iv)->iv_keys))
+
+/* Return the index of the str key in the shared keys or DKIX_EMPTY */
+static Py_ssize_t
+inline_values_lookup(PyDictKeysObject *keys, PyObject *key, Py_hash_t hash)
+{
+    PyDictKeyEntry *ep0 = DK_ENTRIES(keys);
+    size_t mask = DK_MASK(keys);
+    size_t perturb = (size_t)hash;
+    size_t i = (size_t)hash & mask;
+
+    assert(keys->dk_lookup == lookdict_split);
+    assert(PyUnicode_CheckExact(key));
+    if (DK_HAS_TAGS(keys)) {
+        return lookdict_unicode_grouped(keys, key, hash);
+    }
+    for (;;) {
+        Py_ssize_t ix = dictkeys_get_index(keys, i);
+        assert(ix != DKIX_DUMMY);
+        if (ix == DKIX_EMPTY) {
+            return DKIX_EMPTY;
+        }
+        PyDictKeyEntry *ep = &ep0[ix];
+        if (ep->me_key == key ||
+            (ep->me_hash == hash && unicode_eq(ep->me_key, key))) {
+            return ix;
+        }
+        perturb >>= PERTURB_SHIFT;
+        i = mask & (i*5 + perturb + 1);
+    }
+    Py_UNREACHABLE();
+}
+
+static Py_hash_t
+unicode_get_hash(PyObject *key)
+{
+    Py_hash_t hash = ((PyASCIIObject *)key)->hash;
+    if (hash == -1) {
+        /* can't fail for an exact str */
+        hash = PyObject_Hash(key);
+    }
+    return hash;
+}
+
+/* Try to store the attribute into the inline values.  Like insertdict()
+   for a split table, this adds the key to the shared keys, if all keys are
+   already set and there is room.  Return 0, if the attribute doesn't fit. */
+static int
+inline_values_setitem(PyInlineValues *iv, PyObject *key, PyObject *value)
+{
+    PyDictKeysObject *keys = iv->iv_keys;
+    Py_ssize_t ix;
+    Py_hash_t hash;
+    PyObject *old_value;
+
+    if (!PyUnicode_CheckExact(key)) {
+        return 0;
+    }
+    hash = unicode_get_hash(key);
+    ix = inline_values_lookup(keys, key, hash);
+    if (ix == DKIX_EMPTY) {
+        if (keys->dk_usable <= 0 || (keys->dk_nentries > 0 &&
+                iv->iv_values[keys->dk_nentries - 1] == NULL)) {
+            return 0;
+        }
+        ix = keys->dk_nentries;
+        Py_ssize_t hashpos = find_empty_slot(keys, hash);
+        PyDictKeyEntry *ep = &DK_ENTRIES(keys)[ix];
+        dictkeys_set_index(keys, hashpos, ix);
+        dictkeys_set_tag(keys, hashpos, hash);
+        Py_INCREF(key);
+        ep->me_key = key;
+        ep->me_hash = hash;
+        keys->dk_usable--;
+        keys->dk_nentries++;
+    }
+    old_value = iv->iv_values[ix];
+    /* the attributes must stay a prefix of the keys */
+    if (old_value == NULL && ix > 0 && iv->iv_values[ix - 1] == NULL) {
+        return 0;
+    }
+    Py_INCREF(value);
+    iv->iv_values[ix] = value;
+    Py_XDECREF(old_value);
+    return 1;
+}
+
+/* Store the first attribute of an instance into new inline values.
+   Return 0, if the attribute doesn't fit. */
+static int
+inline_values_new(PyObject **dictptr, PyDictKeysObject *keys,
+                  PyObject *key, PyObject *value)
+{
+    PyInlineValues *iv;
+    Py_ssize_t i, size;
+
+    size = USABLE_FRACTION(DK_SIZE(keys));
+    iv = PyMem_Malloc(sizeof(PyInlineValues) + (size - 1) * sizeof(PyObject *));
+    if (iv == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    iv->iv_keys = keys;
+    for (i = 0; i < size; i++) {
+        iv->iv_values[i] = NULL;
+    }
+    if (!inline_values_setitem(iv, key, value)) {
+        PyMem_Free(iv);
+        return 0;
+    }
+    dictkeys_incref(keys);
+    *dictptr = INLINE_VALUES_TO_SLOT(iv);
+    return 1;
+}
+
+PyObject *
+_PyObject_MaterializeDict(PyObject **dictptr)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(*dictptr);
+    PyDictKeysObject *keys = iv->iv_keys;
+    Py_ssize_t size = INLINE_VALUES_SIZE(iv), used = 0;
+    PyObject **values;
+    PyDictObject *mp;
+    int track = 0;
+
+    assert(_PyDict_IS_INLINE_VALUES(*dictptr));
+    values = new_values(size);
+    if (values == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memcpy(values, iv->iv_values, size * sizeof(PyObject *));
+    while (used < size && values[used] != NULL) {
+        track |= _PyObject_GC_MAY_BE_TRACKED(values[used]);
+        used++;
+    }
+    dictkeys_incref(keys);
+    mp = (PyDictObject *)new_dict(keys, values);
+    if (mp == NULL) {
+        return NULL;
+    }
+    /* the dict took over the values */
+    mp->ma_used = used;
+    dictkeys_decref(keys);
+    PyMem_Free(iv);
+    if (track) {
+        _PyObject_GC_TRACK(mp);
+    }
+    ASSERT_CONSISTENT(mp);
+    *dictptr = (PyObject *)mp;
+    return (PyObject *)mp;
+}
+
+Py_ssize_t
+_PyInlineValues_GetItemHint(PyObject *op, PyObject *key,
+                            Py_ssize_t hint, PyObject **value)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(op);
+    PyDictKeysObject *keys = iv->iv_keys;
+
+    assert(*value == NULL);
+    assert(_PyDict_IS_INLINE_VALUES(op));
+    assert(PyUnicode_CheckExact(key));
+
+    if (hint < 0 || hint >= keys->dk_nentries ||
+        DK_ENTRIES(keys)[hint].me_key != key) {
+        hint = inline_values_lookup(keys, key, unicode_get_hash(key));
+        if (hint < 0) {
+            return hint;
+        }
+    }
+    *value = iv->iv_values[hint];
+    return hint;
+}
+
+Py_ssize_t
+_PyInlineValues_Size(PyObject *op)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(op);
+    Py_ssize_t size = INLINE_VALUES_SIZE(iv), used = 0;
+
+    while (used < size && iv->iv_values[used] != NULL) {
+        used++;
+    }
+    return used;
+}
+
+PyObject *
+_PyInlineValues_AsDict(PyObject *op)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(op);
+    PyDictKeyEntry *ep0 = DK_ENTRIES(iv->iv_keys);
+    Py_ssize_t i, used = _PyInlineValues_Size(op);
+    PyObject *dict = _PyDict_NewPresized(used);
+
+    if (dict == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < used; i++) {
+        if (PyDict_SetItem(dict, ep0[i].me_key, iv->iv_values[i]) < 0) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+    }
+    return dict;
+}
+
+int
+_PyInlineValues_Traverse(PyObject *op, visitproc visit, void *arg)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(op);
+    Py_ssize_t i, size = INLINE_VALUES_SIZE(iv);
+
+    for (i = 0; i < size && iv->iv_values[i] != NULL; i++) {
+        Py_VISIT(iv->iv_values[i]);
+    }
+    return 0;
+}
+
+void
+_PyInlineValues_Free(PyObject *op)
+{
+    PyInlineValues *iv = INLINE_VALUES_FROM_SLOT(op);
+    Py_ssize_t i, size = INLINE_VALUES_SIZE(iv);
+
+    for (i = 0; i < size && iv->iv_values[i] != NULL; i++) {
+        Py_DECREF(iv->iv_values[i]);
+    }
+    dictkeys_decref(iv->iv_keys);
+    PyMem_Free(iv);
+}
+
 PyObject *
 PyObject_GenericGetDict(PyObject *obj, void *context)
 {
     PyObject *dict, **dictptr = _PyObject_GetDictPtr(obj);
     if (dictptr == NULL) {
-        PyErr_SetString(PyExc_AttributeError,
-                        "This object has no __dict__");
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_AttributeError,
+                            "This object has no __dict__");
+        }
         return NULL;
     }
     dict = *dictptr;
@@ -4600,9 +5249,26 @@ _PyObjectDict_SetItem(PyTypeObject *tp, PyObject **dictptr,
     PyDictKeysObject *cached;
 
     assert(dictptr != NULL);
+    dict = *dictptr;
+    if (dict != NULL && _PyDict_IS_INLINE_VALUES(dict)) {
+        if (value != NULL &&
+            inline_values_setitem(INLINE_VALUES_FROM_SLOT(dict), key, value)) {
+            return 0;
+        }
+        if (_PyObject_MaterializeDict(dictptr) == NULL) {
+            return -1;
+        }
+    }
     if ((tp->tp_flags & Py_TPFLAGS_HEAPTYPE) && (cached = CACHED_KEYS(tp))) {
         assert(dictptr != NULL);
         dict = *dictptr;
+        if (dict == NULL && value != NULL &&
+            (tp->tp_flags & Py_TPFLAGS_INLINE_VALUES)) {
+            res = inline_values_new(dictptr, cached, key, value);
+            if (res != 0) {
+                return res < 0 ? -1 : 0;
+            }
+        }
         if (dict == NULL) {
             dictkeys_incref(cached);
             dict = new_dict_with_shared_keys(cached);
@@ -4672,3 +5338,407 @@ _PyDictKeys_DecRef(PyDictKeysObject *keys)
 {
     dictkeys_decref(keys);
 }
+
+/* FrozenDict: an immutable mapping with the layout of a dict.
+
+   The entries are copied into a combined keys object, that has the smallest
+   table for the number of items and exactly as many entries as items.  The
+   object never changes afterwards, so it has no resize slack and no version
+   tag, and its lookups, iterators and views are the ones of dict. */
+
+typedef struct {
+    PyDictObject fd_dict;
+    Py_hash_t fd_hash;      /* -1 until computed */
+} PyFrozenDictObject;
+
+/* Return a new frozen copy of the keys and values of the dict mp */
+static PyDictKeysObject *
+frozen_keys_new(PyDictObject *mp)
+{
+    PyDictKeysObject *dk;
+    PyDictKeyEntry *ep;
+    Py_ssize_t size, es, nentries, pos = 0;
+    PyObject *key, *value;
+    Py_hash_t hash;
+    int unicode = 1;
+
+    for (size = PyDict_MINSIZE; USABLE_FRACTION(size) < mp->ma_used; size <<= 1)
+        ;
+    if (size <= 0xff) {
+        es = 1;
+    }
+    else if (size <= 0xffff) {
+        es = 2;
+    }
+#if SIZEOF_VOID_P > 4
+    else if (size <= 0xffffffff) {
+        es = 4;
+    }
+#endif
+    else {
+        es = sizeof(Py_ssize_t);
+    }
+    /* The smallest keys objects may end up in keys_free_list, so they
+       need all their entries. */
+    nentries = size == PyDict_MINSIZE ? USABLE_FRACTION(size) : mp->ma_used;
+    dk = PyObject_MALLOC(sizeof(PyDictKeysObject)
+                         + es * size
+                         + sizeof(PyDictKeyEntry) * nentries);
+    if (dk == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    _Py_INC_REFTOTAL;
+    dk->dk_refcnt = 1;
+    dk->dk_size = size;
+    dk->dk_usable = 0;
+    dk->dk_nentries = 0;
+    memset(&dk->dk_indices[0], 0xff, es * size);
+    memset(DK_ENTRIES(dk), 0, sizeof(PyDictKeyEntry) * nentries);
+
+    ep = DK_ENTRIES(dk);
+    while (_PyDict_Next((PyObject *)mp, &pos, &key, &value, &hash)) {
+        Py_INCREF(key);
+        Py_INCREF(value);
+        ep->me_key = key;
+        ep->me_hash = hash;
+        ep->me_value = value;
+        unicode &= PyUnicode_CheckExact(key);
+        ep++;
+    }
+    dk->dk_nentries = mp->ma_used;
+    dk->dk_lookup = unicode ? lookdict_unicode_nodummy : lookdict;
+    build_indices(dk, DK_ENTRIES(dk), dk->dk_nentries);
+    return dk;
+}
+
+static PyObject *
+frozendict_from_dict(PyTypeObject *type, PyDictObject *mp)
+{
+    PyFrozenDictObject *fd;
+    PyDictKeysObject *keys;
+    PyDictKeyEntry *ep;
+    Py_ssize_t i;
+    int track = 0;
+
+    keys = frozen_keys_new(mp);
+    if (keys == NULL) {
+        return NULL;
+    }
+    fd = (PyFrozenDictObject *)type->tp_alloc(type, 0);
+    if (fd == NULL) {
+        dictkeys_decref(keys);
+        return NULL;
+    }
+    fd->fd_dict.ma_used = keys->dk_nentries;
+    fd->fd_dict.ma_version_tag = 0;
+    fd->fd_dict.ma_keys = keys;
+    fd->fd_dict.ma_values = NULL;
+    fd->fd_hash = -1;
+
+    /* Like tuples of atomic objects, the mapping can't be part of a cycle,
+       if none of its items can be tracked. */
+    ep = DK_ENTRIES(keys);
+    for (i = 0; i < keys->dk_nentries; i++) {
+        if (_PyObject_GC_MAY_BE_TRACKED(ep[i].me_key) ||
+            _PyObject_GC_MAY_BE_TRACKED(ep[i].me_value)) {
+            track = 1;
+            break;
+        }
+    }
+    if (!track && type == &PyFrozenDict_Type) {
+        _PyObject_GC_UNTRACK(fd);
+    }
+    return (PyObject *)fd;
+}
+
+PyObject *
+PyFrozenDict_New(PyObject *mapping)
+{
+    PyObject *dict, *result;
+
+    if (mapping != NULL && PyFrozenDict_CheckExact(mapping)) {
+        Py_INCREF(mapping);
+        return mapping;
+    }
+    dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+    if (mapping != NULL && PyDict_Merge(dict, mapping, 1) < 0) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+    result = frozendict_from_dict(&PyFrozenDict_Type, (PyDictObject *)dict);
+    Py_DECREF(dict);
+    return result;
+}
+
+static PyObject *
+frozendict_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyObject *dict, *result;
+
+    if (type == &PyFrozenDict_Type && kwds == NULL &&
+            PyTuple_GET_SIZE(args) == 1 &&
+            PyFrozenDict_CheckExact(PyTuple_GET_ITEM(args, 0))) {
+        result = PyTuple_GET_ITEM(args, 0);
+        Py_INCREF(result);
+        return result;
+    }
+    dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+    if (dict_update_common(dict, args, kwds, type->tp_name) < 0) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+    result = frozendict_from_dict(type, (PyDictObject *)dict);
+    Py_DECREF(dict);
+    return result;
+}
+
+static void
+frozendict_dealloc(PyFrozenDictObject *fd)
+{
+    PyObject_GC_UnTrack(fd);
+    Py_TRASHCAN_BEGIN(fd, frozendict_dealloc)
+    dictkeys_decref(fd->fd_dict.ma_keys);
+    Py_TYPE(fd)->tp_free((PyObject *)fd);
+    Py_TRASHCAN_END
+}
+
+static int
+frozendict_traverse(PyFrozenDictObject *fd, visitproc visit, void *arg)
+{
+    PyDictKeysObject *keys = fd->fd_dict.ma_keys;
+    PyDictKeyEntry *ep = DK_ENTRIES(keys);
+    Py_ssize_t i;
+
+    for (i = 0; i < keys->dk_nentries; i++) {
+        Py_VISIT(ep[i].me_key);
+        Py_VISIT(ep[i].me_value);
+    }
+    return 0;
+}
+
+static PyObject *
+frozendict_repr(PyFrozenDictObject *fd)
+{
+    PyObject *items, *result;
+
+    items = dict_repr(&fd->fd_dict);
+    if (items == NULL) {
+        return NULL;
+    }
+    result = PyUnicode_FromFormat("%s(%U)", _PyType_Name(Py_TYPE(fd)), items);
+    Py_DECREF(items);
+    return result;
+}
+
+static Py_uhash_t
+frozendict_shuffle_bits(Py_uhash_t h)
+{
+    return ((h ^ 89869747UL) ^ (h << 16)) * 3644798167UL;
+}
+
+/* Like the hash of a frozenset of the items, but without the tuples. */
+static Py_hash_t
+frozendict_hash(PyFrozenDictObject *fd)
+{
+    PyDictKeysObject *keys = fd->fd_dict.ma_keys;
+    PyDictKeyEntry *ep = DK_ENTRIES(keys);
+    Py_uhash_t hash = 0;
+    Py_ssize_t i;
+
+    if (fd->fd_hash != -1) {
+        return fd->fd_hash;
+    }
+    for (i = 0; i < keys->dk_nentries; i++) {
+        Py_hash_t value_hash = PyObject_Hash(ep[i].me_value);
+        if (value_hash == -1) {
+            return -1;
+        }
+        hash ^= frozendict_shuffle_bits(
+            (Py_uhash_t)ep[i].me_hash ^
+            frozendict_shuffle_bits((Py_uhash_t)value_hash));
+    }
+    hash ^= ((Py_uhash_t)keys->dk_nentries + 1) * 1927868237UL;
+    hash = hash * 69069U + 907133923UL;
+    if (hash == (Py_uhash_t)-1) {
+        hash = 590923713UL;
+    }
+    fd->fd_hash = (Py_hash_t)hash;
+    return fd->fd_hash;
+}
+
+static PyObject *
+frozendict_richcompare(PyObject *v, PyObject *w, int op)
+{
+    int cmp;
+
+    if (!(PyDict_Check(w) || PyFrozenDict_Check(w)) ||
+            (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    cmp = dict_equal((PyDictObject *)v, (PyDictObject *)w);
+    if (cmp < 0) {
+        return NULL;
+    }
+    return PyBool_FromLong(cmp == (op == Py_EQ));
+}
+
+static PyObject *
+frozendict_copy(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    if (PyFrozenDict_CheckExact(self)) {
+        Py_INCREF(self);
+        return self;
+    }
+    return PyFrozenDict_New(self);
+}
+
+static PyObject *
+frozendict_reduce(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    _Py_IDENTIFIER(__dict__);
+    PyObject *dict, *state;
+    Py_ssize_t state_len;
+
+    /* capture the instance state of subclasses */
+    if (_PyObject_LookupAttrId(self, &PyId___dict__, &state) < 0) {
+        return NULL;
+    }
+    if (state != NULL) {
+        state_len = PyObject_Length(state);
+        if (state_len < 0) {
+            Py_DECREF(state);
+            return NULL;
+        }
+        if (state_len == 0) {
+            Py_CLEAR(state);
+        }
+    }
+
+    dict = PyDict_New();
+    if (dict == NULL) {
+        Py_XDECREF(state);
+        return NULL;
+    }
+    if (PyDict_Merge(dict, self, 1) < 0) {
+        Py_DECREF(dict);
+        Py_XDECREF(state);
+        return NULL;
+    }
+    if (state == NULL) {
+        return Py_BuildValue("O(N)", Py_TYPE(self), dict);
+    }
+    return Py_BuildValue("O(N)N", Py_TYPE(self), dict, state);
+}
+
+static PyObject *
+frozendict_sizeof(PyFrozenDictObject *fd, PyObject *Py_UNUSED(ignored))
+{
+    PyDictKeysObject *keys = fd->fd_dict.ma_keys;
+    Py_ssize_t nentries;
+
+    nentries = DK_SIZE(keys) == PyDict_MINSIZE ?
+        USABLE_FRACTION(PyDict_MINSIZE) : keys->dk_nentries;
+    return PyLong_FromSsize_t(_PyObject_SIZE(Py_TYPE(fd))
+                              + sizeof(PyDictKeysObject)
+                              + DK_IXSIZE(keys) * DK_SIZE(keys)
+                              + sizeof(PyDictKeyEntry) * nentries);
+}
+
+static PyMappingMethods frozendict_as_mapping = {
+    (lenfunc)dict_length,                       /* mp_length */
+    (binaryfunc)dict_subscript,                 /* mp_subscript */
+    0,                                          /* mp_ass_subscript */
+};
+
+static PySequenceMethods frozendict_as_sequence = {
+    0,                                          /* sq_length */
+    0,                                          /* sq_concat */
+    0,                                          /* sq_repeat */
+    0,                                          /* sq_item */
+    0,                                          /* sq_slice */
+    0,                                          /* sq_ass_item */
+    0,                                          /* sq_ass_slice */
+    PyDict_Contains,                            /* sq_contains */
+};
+
+PyDoc_STRVAR(frozendict_copy__doc__,
+"D.copy() -> D, as the mapping is immutable");
+
+static PyMethodDef frozendict_methods[] = {
+    DICT___CONTAINS___METHODDEF
+    {"__getitem__", (PyCFunction)(void(*)(void))dict_subscript,
+     METH_O | METH_COEXIST, getitem__doc__},
+    {"__sizeof__", (PyCFunction)(void(*)(void))frozendict_sizeof,
+     METH_NOARGS, sizeof__doc__},
+    {"__reduce__", (PyCFunction)frozendict_reduce, METH_NOARGS,
+     reduce_doc},
+    DICT_GET_METHODDEF
+    {"keys", dictkeys_new, METH_NOARGS, keys__doc__},
+    {"items", dictitems_new, METH_NOARGS, items__doc__},
+    {"values", dictvalues_new, METH_NOARGS, values__doc__},
+    {"copy", (PyCFunction)frozendict_copy, METH_NOARGS,
+     frozendict_copy__doc__},
+    DICT___REVERSED___METHODDEF
+    {NULL,              NULL}   /* sentinel */
+};
+
+PyDoc_STRVAR(frozendict_doc,
+"FrozenDict() -> new empty frozen dictionary\n"
+"FrozenDict(mapping) -> new frozen dictionary initialized from a mapping\n"
+"    object's (key, value) pairs\n"
+"FrozenDict(iterable) -> new frozen dictionary initialized from an\n"
+"    iterable of (key, value) pairs\n"
+"FrozenDict(**kwargs) -> new frozen dictionary initialized with the\n"
+"    name=value pairs in the keyword argument list.\n"
+"\n"
+"The mapping is immutable and hashable, if its values are hashable.");
+
+PyTypeObject PyFrozenDict_Type = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "types.FrozenDict",
+    sizeof(PyFrozenDictObject),
+    0,
+    (destructor)frozendict_dealloc,             /* tp_dealloc */
+    0,                                          /* tp_vectorcall_offset */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_as_async */
+    (reprfunc)frozendict_repr,                  /* tp_repr */
+    0,                                          /* tp_as_number */
+    &frozendict_as_sequence,                    /* tp_as_sequence */
+    &frozendict_as_mapping,                     /* tp_as_mapping */
+    (hashfunc)frozendict_hash,                  /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    PyObject_GenericGetAttr,                    /* tp_getattro */
+    0,                                          /* tp_setattro */
+    0,                                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
+        Py_TPFLAGS_BASETYPE,                    /* tp_flags */
+    frozendict_doc,                             /* tp_doc */
+    (traverseproc)frozendict_traverse,          /* tp_traverse */
+    0,                                          /* tp_clear */
+    frozendict_richcompare,                     /* tp_richcompare */
+    0,                                          /* tp_weaklistoffset */
+    (getiterfunc)dict_iter,                     /* tp_iter */
+    0,                                          /* tp_iternext */
+    frozendict_methods,                         /* tp_methods */
+    0,                                          /* tp_members */
+    0,                                          /* tp_getset */
+    0,                                          /* tp_base */
+    0,                                          /* tp_dict */
+    0,                                          /* tp_descr_get */
+    0,                                          /* tp_descr_set */
+    0,                                          /* tp_dictoffset */
+    0,                                          /* tp_init */
+    PyType_GenericAlloc,                        /* tp_alloc */
+    frozendict_new,                             /* tp_new */
+    PyObject_GC_Del,                            /* tp_free */
+};
@@ -2838,6 +2838,11 @@ _PyErr_TrySetFromCause(const char *format, ...)
 
     /* Ensure the instance dict is also empty */
     dictptr = _PyObject_GetDictPtr(val);
+    if (dictptr == NULL && PyErr_Occurred()) {
+        PyErr_Clear();
+        PyErr_Restore(exc, val, tb);
+        return NULL;
+    }
     if (dictptr != NULL && *dictptr != NULL &&
         PyDict_GET_SIZE(*dictptr) > 0) {
         /* While we could potentially copy a non-empty instance dictionary
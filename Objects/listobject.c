@@ -5,6 +5,7 @@
 #include "pycore_pystate.h"
 #include "pycore_tupleobject.h"
 #include "pycore_accu.h"
+#include "pycore_stackless.h"
 
 #ifdef STDC_HEADERS
 #include <stddef.h>
@@ -12,6 +13,10 @@
 #include <sys/types.h>          /* For size_t */
 #endif
 
+#ifdef MS_WINDOWS
+#include <windows.h>            /* For GetSystemInfo() */
+#endif
+
 /*[clinic input]
 class list "PyListObject *" "&PyList_Type"
 [clinic start generated code]*/
@@ -1218,6 +1223,11 @@ struct s_MergeState {
      * of tuples. It may be set to safe_object_compare, but the idea is that hopefully
      * we can assume more, and use one of the special-case compares. */
     int (*tuple_elem_compare)(PyObject *, PyObject *, MergeState *);
+
+    /* True while the sort runs without the GIL, see parallel_sort().  The
+     * special case compares must not check their result against
+     * PyObject_RichCompareBool() then. */
+    int nogil;
 };
 
 /* binarysort is the best method for sorting small arrays: it does
@@ -1551,6 +1561,7 @@ merge_init(MergeState *ms, Py_ssize_t list_size, int has_keyfunc)
     ms->a.keys = ms->temparray;
     ms->n = 0;
     ms->min_gallop = MIN_GALLOP;
+    ms->nogil = 0;
 }
 
 /* Free all the temp memory owned by the MergeState.  This must be called
@@ -2020,6 +2031,60 @@ reverse_sortslice(sortslice *s, Py_ssize_t n)
         reverse_slice(s->values, &s->values[n]);
 }
 
+/* Merge sort the size > 0 entries of lo in place, using the compare and the
+ * temp memory of ms.  March over the slice once, left to right, finding
+ * natural runs, and extending short natural runs to minrun elements.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int
+mergesort_slice(MergeState *ms, sortslice lo, Py_ssize_t size)
+{
+    Py_ssize_t nremaining = size;
+    Py_ssize_t minrun;
+    PyObject **base = lo.keys;
+
+    assert(size > 0);
+    minrun = merge_compute_minrun(nremaining);
+    do {
+        int descending;
+        Py_ssize_t n;
+
+        /* Identify next run. */
+        n = count_run(ms, lo.keys, lo.keys + nremaining, &descending);
+        if (n < 0)
+            return -1;
+        if (descending)
+            reverse_sortslice(&lo, n);
+        /* If short, extend to min(minrun, nremaining). */
+        if (n < minrun) {
+            const Py_ssize_t force = nremaining <= minrun ?
+                              nremaining : minrun;
+            if (binarysort(ms, lo, lo.keys + force, lo.keys + n) < 0)
+                return -1;
+            n = force;
+        }
+        /* Push run onto pending-runs stack, and maybe merge. */
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = lo;
+        ms->pending[ms->n].len = n;
+        ++ms->n;
+        if (merge_collapse(ms) < 0)
+            return -1;
+        /* Advance to find next run. */
+        sortslice_advance(&lo, n);
+        nremaining -= n;
+    } while (nremaining);
+
+    if (merge_force_collapse(ms) < 0)
+        return -1;
+    assert(ms->n == 1);
+    assert(ms->pending[0].base.keys == base);
+    assert(ms->pending[0].len == size);
+    (void)base;
+    return 0;
+}
+
 /* Here we define custom comparison functions to optimize for the cases one commonly
  * encounters in practice: homogeneous lists, often of one of the basic types. */
 
@@ -2096,7 +2161,7 @@ unsafe_latin_compare(PyObject *v, PyObject *w, MergeState *ms)
            res < 0 :
            PyUnicode_GET_LENGTH(v) < PyUnicode_GET_LENGTH(w));
 
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));;
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2124,7 +2189,7 @@ unsafe_long_compare(PyObject *v, PyObject *w, MergeState *ms)
         w0 = -w0;
 
     res = v0 < w0;
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2139,7 +2204,7 @@ unsafe_float_compare(PyObject *v, PyObject *w, MergeState *ms)
     assert(v->ob_type == &PyFloat_Type);
 
     res = PyFloat_AS_DOUBLE(v) < PyFloat_AS_DOUBLE(w);
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2185,6 +2250,624 @@ unsafe_tuple_compare(PyObject *v, PyObject *w, MergeState *ms)
         return PyObject_RichCompareBool(vt->ob_item[i], wt->ob_item[i], Py_LT);
 }
 
+/* Radix sort.
+ *
+ * Big lists whose keys use the long, float or latin compare are sorted
+ * without comparisons.  Small ints and floats are mapped to unsigned
+ * integers in the same order and sorted by an LSD radix sort, with one
+ * counting pass per byte that differs between the keys.  Strings are
+ * distributed into buckets by their bytes, most significant first, and
+ * small buckets are left to the merge sort.  Both are stable, so the result
+ * is the same as the merge sort's.
+ *
+ * The merge sort takes linear time on data made of a few long runs, so the
+ * radix sort is only used if at least one in RADIX_SORT_RUNS neighbours is
+ * out of order in either direction.  It allocates with PyMem_RawMalloc(),
+ * since it runs without the GIL in a parallel sort, and leaves the list to
+ * the merge sort if that fails.
+ */
+
+/* The minimum number of entries sorted by a radix sort. */
+#define RADIX_SORT_CUTOFF 512
+#define RADIX_SORT_RUNS 32
+/* Strings: merge sort buckets smaller than this, or after this many bytes. */
+#define RADIX_SORT_BUCKET 64
+#define RADIX_SORT_MAX_DEPTH 32
+
+/* A float key and the index of its entry. */
+typedef struct {
+    uint64_t key;
+    Py_ssize_t index;
+} radix_item;
+
+/* Is lo[0:n] far enough from a few natural runs? */
+static int
+radix_sort_worthwhile(MergeState *ms, PyObject **keys, Py_ssize_t n)
+{
+    Py_ssize_t i, up = 0, down = 0;
+
+    for (i = 1; i < n; i++) {
+        if (ISLT(keys[i - 1], keys[i]))
+            up++;
+        else if (ISLT(keys[i], keys[i - 1]))
+            down++;
+    }
+    return Py_MIN(up, down) >= n / RADIX_SORT_RUNS;
+}
+
+/* Put the entries of lo[0:n] in the order of index(i), using tmp as room for
+ * n pointers.
+ */
+#define RADIX_SORT_GATHER(lo, n, tmp, index) \
+    do { \
+        Py_ssize_t _i; \
+        memcpy((tmp), (lo).keys, (n) * sizeof(PyObject *)); \
+        for (_i = 0; _i < (n); _i++) \
+            (lo).keys[_i] = (tmp)[index(_i)]; \
+        if ((lo).values != NULL) { \
+            memcpy((tmp), (lo).values, (n) * sizeof(PyObject *)); \
+            for (_i = 0; _i < (n); _i++) \
+                (lo).values[_i] = (tmp)[index(_i)]; \
+        } \
+    } while (0)
+
+/* Sort the small ints lo[0:n].  Each is sorted as a 32 bit key in the upper
+ * half of a 64 bit item, with the index of the entry in the lower half.
+ * Returns 1 on success and 0 if out of memory.
+ */
+static int
+radix_sort_long(sortslice lo, Py_ssize_t n)
+{
+    Py_ssize_t counts[4][256];
+    uint64_t *src, *dst, *tmp;
+    Py_ssize_t i;
+    int b;
+
+    if ((uint64_t)n > 0xffffffffU ||
+            (size_t)n > PY_SSIZE_T_MAX / sizeof(uint64_t) / 2)
+        return 0;
+    src = (uint64_t *)PyMem_RawMalloc(2 * n * sizeof(uint64_t));
+    if (src == NULL)
+        return 0;
+    dst = src + n;
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; i++) {
+        PyLongObject *v = (PyLongObject *)lo.keys[i];
+        sdigit d = Py_SIZE(v) == 0 ? 0 : (sdigit)v->ob_digit[0];
+        /* Flip the sign bit, so that negative ints come first. */
+        uint32_t key = (uint32_t)(int32_t)(Py_SIZE(v) < 0 ? -d : d) ^
+                       0x80000000U;
+        src[i] = (uint64_t)key << 32 | (uint64_t)i;
+        for (b = 0; b < 4; b++)
+            counts[b][(key >> (8 * b)) & 0xff]++;
+    }
+    for (b = 0; b < 4; b++) {
+        Py_ssize_t *count = counts[b];
+        Py_ssize_t sum = 0;
+        int shift = 32 + 8 * b;
+        int j;
+
+        if (count[(src[0] >> shift) & 0xff] == n)
+            continue;           /* all keys have the same byte */
+        for (j = 0; j < 256; j++) {
+            Py_ssize_t c = count[j];
+            count[j] = sum;
+            sum += c;
+        }
+        for (i = 0; i < n; i++)
+            dst[count[(src[i] >> shift) & 0xff]++] = src[i];
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+#define RADIX_SORT_LONG_INDEX(i) ((Py_ssize_t)(src[i] & 0xffffffffU))
+    RADIX_SORT_GATHER(lo, n, (PyObject **)dst, RADIX_SORT_LONG_INDEX);
+#undef RADIX_SORT_LONG_INDEX
+    PyMem_RawFree(Py_MIN(src, dst));
+    return 1;
+}
+
+/* Sort the floats lo[0:n].  Returns 1 on success and 0 if out of memory or
+ * if there is a NaN, which has no place in the order.
+ */
+static int
+radix_sort_float(sortslice lo, Py_ssize_t n)
+{
+    Py_ssize_t counts[8][256];
+    radix_item *src, *dst, *tmp;
+    Py_ssize_t i;
+    int b;
+
+    if ((size_t)n > PY_SSIZE_T_MAX / sizeof(radix_item) / 2)
+        return 0;
+    src = (radix_item *)PyMem_RawMalloc(2 * n * sizeof(radix_item));
+    if (src == NULL)
+        return 0;
+    dst = src + n;
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; i++) {
+        double d = PyFloat_AS_DOUBLE(lo.keys[i]);
+        uint64_t key;
+
+        if (Py_IS_NAN(d)) {
+            PyMem_RawFree(src);
+            return 0;
+        }
+        if (d == 0.0)
+            d = 0.0;            /* -0.0 and 0.0 are equal */
+        memcpy(&key, &d, sizeof(key));
+        /* Flip the sign bit of positive floats and all bits of negative
+         * ones, then the order is that of unsigned integers. */
+        key = key >> 63 ? ~key : key | (uint64_t)1 << 63;
+        src[i].key = key;
+        src[i].index = i;
+        for (b = 0; b < 8; b++)
+            counts[b][(key >> (8 * b)) & 0xff]++;
+    }
+    for (b = 0; b < 8; b++) {
+        Py_ssize_t *count = counts[b];
+        Py_ssize_t sum = 0;
+        int shift = 8 * b;
+        int j;
+
+        if (count[(src[0].key >> shift) & 0xff] == n)
+            continue;           /* all keys have the same byte */
+        for (j = 0; j < 256; j++) {
+            Py_ssize_t c = count[j];
+            count[j] = sum;
+            sum += c;
+        }
+        for (i = 0; i < n; i++)
+            dst[count[(src[i].key >> shift) & 0xff]++] = src[i];
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+#define RADIX_SORT_FLOAT_INDEX(i) (src[i].index)
+    RADIX_SORT_GATHER(lo, n, (PyObject **)dst, RADIX_SORT_FLOAT_INDEX);
+#undef RADIX_SORT_FLOAT_INDEX
+    PyMem_RawFree(Py_MIN(src, dst));
+    return 1;
+}
+
+/* The bucket of the latin string s after depth bytes: 0 for the strings
+ * that end there, else the next byte plus one.
+ */
+Py_LOCAL_INLINE(int)
+radix_latin_byte(PyObject *s, Py_ssize_t depth)
+{
+    return depth < PyUnicode_GET_LENGTH(s) ?
+           PyUnicode_1BYTE_DATA(s)[depth] + 1 : 0;
+}
+
+/* Sort the latin strings lo[0:n], which agree in their first depth bytes,
+ * using buf as room for n entries.  Returns 0 on success, -1 on error.
+ */
+static int
+radix_sort_latin_rec(MergeState *ms, sortslice lo, sortslice buf,
+                     Py_ssize_t n, Py_ssize_t depth)
+{
+    Py_ssize_t start[257 + 1];
+    Py_ssize_t i;
+    int j;
+
+    for (;;) {
+        if (n < RADIX_SORT_BUCKET || depth >= RADIX_SORT_MAX_DEPTH) {
+            ms->n = 0;
+            return mergesort_slice(ms, lo, n);
+        }
+        memset(start, 0, sizeof(start));
+        for (i = 0; i < n; i++)
+            start[radix_latin_byte(lo.keys[i], depth) + 1]++;
+        j = radix_latin_byte(lo.keys[0], depth);
+        if (start[j + 1] != n)
+            break;
+        /* All strings have the same next byte, or all of them end. */
+        if (j == 0)
+            return 0;
+        depth++;
+    }
+
+    for (j = 1; j <= 257; j++)
+        start[j] += start[j - 1];
+    for (i = 0; i < n; i++)
+        sortslice_copy(&buf, start[radix_latin_byte(lo.keys[i], depth)]++,
+                       &lo, i);
+    sortslice_memcpy(&lo, 0, &buf, 0, n);
+
+    /* start[j] is now the end of bucket j.  Bucket 0 holds equal strings. */
+    for (j = 1; j < 257; j++) {
+        Py_ssize_t lo_j = start[j - 1];
+        Py_ssize_t n_j = start[j] - lo_j;
+        if (n_j > 1) {
+            sortslice lo_s = lo, buf_s = buf;
+            sortslice_advance(&lo_s, lo_j);
+            sortslice_advance(&buf_s, lo_j);
+            if (radix_sort_latin_rec(ms, lo_s, buf_s, n_j, depth + 1) < 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+/* Sort the latin strings lo[0:n].  Returns 1 on success, 0 if out of memory
+ * and -1 on error.
+ */
+static int
+radix_sort_latin(MergeState *ms, sortslice lo, Py_ssize_t n)
+{
+    int multiplier = lo.values != NULL ? 2 : 1;
+    sortslice buf;
+    int res;
+
+    if ((size_t)n > PY_SSIZE_T_MAX / sizeof(PyObject *) / multiplier)
+        return 0;
+    buf.keys = (PyObject **)PyMem_RawMalloc(multiplier * n
+                                            * sizeof(PyObject *));
+    if (buf.keys == NULL)
+        return 0;
+    buf.values = lo.values != NULL ? &buf.keys[n] : NULL;
+    res = radix_sort_latin_rec(ms, lo, buf, n, 0);
+    PyMem_RawFree(buf.keys);
+    return res < 0 ? -1 : 1;
+}
+
+/* Sort lo[0:n] with a radix sort, if the keys allow it and it is worthwhile.
+ * Returns 1 if the slice was sorted, 0 if it is left to the merge sort and
+ * -1 on error.
+ */
+static int
+radix_sort(MergeState *ms, sortslice lo, Py_ssize_t n)
+{
+    if (n < RADIX_SORT_CUTOFF)
+        return 0;
+    if (ms->key_compare == unsafe_long_compare) {
+        if (radix_sort_worthwhile(ms, lo.keys, n))
+            return radix_sort_long(lo, n);
+    }
+    else if (ms->key_compare == unsafe_float_compare) {
+        if (radix_sort_worthwhile(ms, lo.keys, n))
+            return radix_sort_float(lo, n);
+    }
+    else if (ms->key_compare == unsafe_latin_compare) {
+        if (radix_sort_worthwhile(ms, lo.keys, n))
+            return radix_sort_latin(ms, lo, n);
+    }
+    return 0;
+}
+
+/* Sort the size > 0 entries of lo in place, with a radix sort if possible,
+ * else with the merge sort.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int
+sort_slice(MergeState *ms, sortslice lo, Py_ssize_t size)
+{
+    int res = radix_sort(ms, lo, size);
+
+    if (res != 0)
+        return res < 0 ? -1 : 0;
+    return mergesort_slice(ms, lo, size);
+}
+
+/* Parallel sort.
+ *
+ * The latin, long and float compares above neither run Python code nor touch
+ * reference counts, and they can't fail.  A huge list whose keys use one of
+ * them can therefore be sorted by several threads without holding the GIL.
+ * The list is cut into one chunk per thread and the chunks are sorted
+ * concurrently by sort_slice().  The sorted chunks are then merged pairwise
+ * in rounds, going back and forth between the list and a buffer of the same
+ * size.  In the last rounds there are fewer pairs than threads, so every
+ * merge is cut into pieces of about the same size: the split points are
+ * found by a binary search along the "merge path", and the pieces are merged
+ * independently.  The result is as stable as a serial sort.
+ */
+
+/* Each thread gets at least this many entries. */
+#define PARALLEL_SORT_CHUNK (1 << 15)
+#define PARALLEL_SORT_MAX_THREADS 64
+
+typedef struct {
+    /* If merge is 0, sort a[0:na] using dst as temp memory for na entries.
+     * Else merge a[0:na] and b[0:nb] into dst, but only produce dst[lo:hi].
+     */
+    int merge;
+    sortslice a, b, dst;
+    Py_ssize_t na, nb, lo, hi;
+} sort_task;
+
+typedef struct {
+    MergeState *ms;             /* provides the compare */
+    sort_task *tasks;
+    Py_ssize_t ntasks;
+    Py_ssize_t next;            /* the next task to run */
+    int running;                /* number of threads not yet finished */
+    PyThread_type_lock mutex;   /* protects next and running */
+    PyThread_type_lock done;    /* released by the last thread to finish */
+} sort_job;
+
+/* Return the number of threads used for list.sort(parallel=True). */
+static int
+parallel_sort_default_threads(void)
+{
+    long n = 1;
+#ifdef MS_WINDOWS
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    n = sysinfo.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (n < 1)
+        n = 1;
+    return (int)Py_MIN(n, PARALLEL_SORT_MAX_THREADS);
+}
+
+/* Can a list of n entries be sorted by parallel_sort()? */
+static int
+parallel_sort_eligible(MergeState *ms, Py_ssize_t n)
+{
+    return n >= 2 * PARALLEL_SORT_CHUNK &&
+           (ms->key_compare == unsafe_latin_compare ||
+            ms->key_compare == unsafe_long_compare ||
+            ms->key_compare == unsafe_float_compare);
+}
+
+/* Return the start of part i, if n entries are cut into k parts of about
+ * the same size. */
+Py_LOCAL_INLINE(Py_ssize_t)
+parallel_sort_bound(Py_ssize_t n, Py_ssize_t k, Py_ssize_t i)
+{
+    return i * (n / k) + Py_MIN(i, n % k);
+}
+
+/* Return the number of entries of a among the first t entries of the stable
+ * merge of a[0:na] and b[0:nb].
+ */
+static Py_ssize_t
+parallel_sort_split(MergeState *ms, sortslice a, Py_ssize_t na,
+                    sortslice b, Py_ssize_t nb, Py_ssize_t t)
+{
+    Py_ssize_t lo = Py_MAX(0, t - nb);
+    Py_ssize_t hi = Py_MIN(t, na);
+
+    while (lo < hi) {
+        Py_ssize_t mid = lo + ((hi - lo) >> 1);
+        /* a[mid] is among the first t entries unless b[t-mid-1] < a[mid],
+         * because a wins ties. */
+        if (ISLT(b.keys[t - mid - 1], a.keys[mid]))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+static void
+parallel_sort_run_task(MergeState *shared, sort_task *task)
+{
+    if (!task->merge) {
+        MergeState ms;
+        int res;
+
+        ms.key_compare = shared->key_compare;
+        ms.nogil = 1;
+        ms.min_gallop = MIN_GALLOP;
+        ms.n = 0;
+        /* Enough for any merge, so merge_getmem() never allocates. */
+        ms.a = task->dst;
+        ms.alloced = task->na;
+        res = sort_slice(&ms, task->a, task->na);
+        assert(res == 0);
+        (void)res;
+    }
+    else {
+        MergeState *ms = shared;
+        sortslice a = task->a, b = task->b, dst = task->dst;
+        Py_ssize_t ia, ib, na, nb;
+
+        ia = parallel_sort_split(ms, a, task->na, b, task->nb, task->lo);
+        ib = task->lo - ia;
+        na = parallel_sort_split(ms, a, task->na, b, task->nb, task->hi) - ia;
+        nb = task->hi - task->lo - na;
+        sortslice_advance(&a, ia);
+        sortslice_advance(&b, ib);
+        sortslice_advance(&dst, task->lo);
+        while (na > 0 && nb > 0) {
+            if (ISLT(*b.keys, *a.keys)) {
+                sortslice_copy_incr(&dst, &b);
+                --nb;
+            }
+            else {
+                sortslice_copy_incr(&dst, &a);
+                --na;
+            }
+        }
+        if (na)
+            sortslice_memcpy(&dst, 0, &a, 0, na);
+        if (nb)
+            sortslice_memcpy(&dst, 0, &b, 0, nb);
+    }
+}
+
+static void
+parallel_sort_worker(void *arg)
+{
+    sort_job *job = (sort_job *)arg;
+
+    for (;;) {
+        Py_ssize_t i;
+        int stop, last = 0;
+
+        /* Once the last worker released job->done, the caller may reuse
+         * or free job, so don't read it after leaving the lock. */
+        PyThread_acquire_lock(job->mutex, WAIT_LOCK);
+        i = job->next;
+        stop = i >= job->ntasks;
+        if (!stop)
+            job->next++;
+        else
+            last = --job->running == 0;
+        PyThread_release_lock(job->mutex);
+        if (stop) {
+            if (last)
+                PyThread_release_lock(job->done);
+            return;
+        }
+        parallel_sort_run_task(job->ms, &job->tasks[i]);
+    }
+}
+
+/* Run the tasks of job with nthreads threads, including the calling one,
+ * and wait until all of them are finished.
+ */
+static void
+parallel_sort_run_job(sort_job *job, int nthreads)
+{
+    int i;
+
+    job->next = 0;
+    job->running = nthreads;
+    PyThread_acquire_lock(job->done, WAIT_LOCK);
+    for (i = 1; i < nthreads; i++) {
+        if (PyThread_start_new_thread(parallel_sort_worker, job) ==
+                PYTHREAD_INVALID_THREAD_ID) {
+            /* The other threads do the work. */
+            PyThread_acquire_lock(job->mutex, WAIT_LOCK);
+            job->running--;
+            PyThread_release_lock(job->mutex);
+        }
+    }
+    parallel_sort_worker(job);
+    PyThread_acquire_lock(job->done, WAIT_LOCK);
+    PyThread_release_lock(job->done);
+}
+
+/* Sort the n entries of lo with nthreads threads.  The caller must have
+ * checked parallel_sort_eligible().
+ *
+ * Returns 0 on success, -1 on error.
+ */
+static int
+parallel_sort(MergeState *ms, sortslice lo, Py_ssize_t n, int nthreads)
+{
+    int multiplier = lo.values != NULL ? 2 : 1;
+    Py_ssize_t *bounds = NULL;
+    sortslice buf, src, dst, tmp;
+    sort_job job;
+    Py_ssize_t nruns, i, p;
+    int result = -1;
+
+    assert(parallel_sort_eligible(ms, n));
+    nthreads = (int)Py_MIN(nthreads, n / PARALLEL_SORT_CHUNK);
+    assert(nthreads > 1 && nthreads <= PARALLEL_SORT_MAX_THREADS);
+
+    job.ms = ms;
+    job.mutex = job.done = NULL;
+    buf.keys = NULL;
+    /* Every round has at most nthreads + nruns / 2 merge tasks. */
+    job.tasks = PyMem_New(sort_task, 2 * nthreads);
+    bounds = PyMem_New(Py_ssize_t, nthreads + 1);
+    if ((size_t)n <= PY_SSIZE_T_MAX / sizeof(PyObject *) / multiplier)
+        buf.keys = (PyObject **)PyMem_Malloc(multiplier * n
+                                             * sizeof(PyObject *));
+    if (job.tasks == NULL || bounds == NULL || buf.keys == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    buf.values = lo.values != NULL ? &buf.keys[n] : NULL;
+    job.mutex = PyThread_allocate_lock();
+    job.done = PyThread_allocate_lock();
+    if (job.mutex == NULL || job.done == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "can't allocate lock");
+        goto done;
+    }
+
+    ms->nogil = 1;
+    Py_BEGIN_ALLOW_THREADS
+
+    /* Sort one chunk per thread. */
+    nruns = nthreads;
+    for (i = 0; i < nruns; i++) {
+        sort_task *task = &job.tasks[i];
+        bounds[i] = parallel_sort_bound(n, nruns, i);
+        task->merge = 0;
+        task->na = parallel_sort_bound(n, nruns, i + 1) - bounds[i];
+        task->a = lo;
+        sortslice_advance(&task->a, bounds[i]);
+        task->dst = buf;
+        sortslice_advance(&task->dst, bounds[i]);
+    }
+    bounds[nruns] = n;
+    job.ntasks = nruns;
+    parallel_sort_run_job(&job, nthreads);
+
+    /* Merge pairs of runs until one is left. */
+    src = lo;
+    dst = buf;
+    while (nruns > 1) {
+        Py_ssize_t npairs = 0;
+
+        job.ntasks = 0;
+        for (i = 0; i < nruns; i += 2) {
+            Py_ssize_t start = bounds[i];
+            Py_ssize_t mid = bounds[Py_MIN(i + 1, nruns)];
+            Py_ssize_t end = bounds[Py_MIN(i + 2, nruns)];
+            /* About one piece per thread and chunk. */
+            Py_ssize_t npieces = (end - start) / (n / nthreads);
+
+            if (npieces < 1)
+                npieces = 1;
+            for (p = 0; p < npieces; p++) {
+                sort_task *task = &job.tasks[job.ntasks++];
+                task->merge = 1;
+                task->a = src;
+                sortslice_advance(&task->a, start);
+                task->na = mid - start;
+                task->b = src;
+                sortslice_advance(&task->b, mid);
+                task->nb = end - mid;
+                task->dst = dst;
+                sortslice_advance(&task->dst, start);
+                task->lo = parallel_sort_bound(end - start, npieces, p);
+                task->hi = parallel_sort_bound(end - start, npieces, p + 1);
+            }
+            bounds[npairs++] = start;
+        }
+        bounds[npairs] = n;
+        nruns = npairs;
+        parallel_sort_run_job(&job, nthreads);
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src.keys != lo.keys)
+        sortslice_memcpy(&lo, 0, &src, 0, n);
+
+    Py_END_ALLOW_THREADS
+    ms->nogil = 0;
+    result = 0;
+
+done:
+    if (job.mutex != NULL)
+        PyThread_free_lock(job.mutex);
+    if (job.done != NULL)
+        PyThread_free_lock(job.done);
+    PyMem_Free(buf.keys);
+    PyMem_Free(bounds);
+    PyMem_Free(job.tasks);
+    return result;
+}
+
+static PyObject *
+list_sort_internal(PyListObject *self, PyObject *keyfunc, PyObject *keylist,
+                   int reverse, int nthreads);
+
 /* An adaptive, stable, natural mergesort.  See listsort.txt.
  * Returns Py_None on success, NULL on error.  Even in case of error, the
  * list will be some permutation of its input state (nothing is lost or
@@ -2196,6 +2879,7 @@ list.sort
     *
     key as keyfunc: object = None
     reverse: bool(accept={int}) = False
+    parallel: object = False
 
 Sort the list in ascending order and return None.
 
@@ -2206,15 +2890,73 @@ If a key function is given, apply it once to each list item and sort them,
 ascending or descending, according to their function values.
 
 The reverse flag can be set to sort in descending order.
+
+If parallel is true, a huge list of ints, floats or Latin-1 strings, or one
+whose keys are such, is sorted by several threads.  An int gives the number
+of threads; True uses one thread per CPU.
 [clinic start generated code]*/
 
 static PyObject *
-list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
-/*[clinic end generated code: output=57b9f9c5e23fbe42 input=cb56cd179a713060]*/
+list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse,
+               PyObject *parallel)
+/*[clinic end generated code: output=98ae543521846ce1 input=15f8c13a9028e05f]*/
+{
+    int nthreads = 0;
+
+    if (parallel == Py_True) {
+        nthreads = parallel_sort_default_threads();
+    }
+    else if (parallel != Py_False) {
+        Py_ssize_t n = PyNumber_AsSsize_t(parallel, NULL);
+        if (n == -1 && PyErr_Occurred())
+            return NULL;
+        if (n < 0) {
+            PyErr_SetString(PyExc_ValueError,
+                            "parallel must be a bool or a non-negative int");
+            return NULL;
+        }
+        nthreads = (int)Py_MIN(n, PARALLEL_SORT_MAX_THREADS);
+    }
+    return list_sort_internal(self, keyfunc, NULL, reverse, nthreads);
+}
+
+#ifdef STACKLESS
+/* Sort the list using the precomputed keys in the list keylist.
+ * Used by a soft switchable sorted(), which calls the key function
+ * on its own.
+ */
+int
+slp_list_sort_with_keys(PyObject *list, PyObject *keylist, int reverse)
+{
+    PyObject *v;
+
+    if (list == NULL || !PyList_Check(list) ||
+            keylist == NULL || !PyList_Check(keylist)) {
+        PyErr_BadInternalCall();
+        return -1;
+    }
+    if (Py_SIZE(keylist) != Py_SIZE(list)) {
+        PyErr_SetString(PyExc_ValueError, "list modified during sort");
+        return -1;
+    }
+    v = list_sort_internal((PyListObject *)list, NULL, keylist, reverse, 0);
+    if (v == NULL)
+        return -1;
+    Py_DECREF(v);
+    return 0;
+}
+#endif
+
+/* If keylist is not NULL, it is a list containing the precomputed keys
+ * and keyfunc is ignored.  If nthreads > 1, a huge list may be sorted by
+ * that many threads.
+ */
+static PyObject *
+list_sort_internal(PyListObject *self, PyObject *keyfunc, PyObject *keylist,
+                   int reverse, int nthreads)
 {
     MergeState ms;
     Py_ssize_t nremaining;
-    Py_ssize_t minrun;
     sortslice lo;
     Py_ssize_t saved_ob_size, saved_allocated;
     PyObject **saved_ob_item;
@@ -2240,7 +2982,7 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
     self->ob_item = NULL;
     self->allocated = -1; /* any operation will reset it to >= 0 */
 
-    if (keyfunc == NULL) {
+    if (keyfunc == NULL && keylist == NULL) {
         keys = NULL;
         lo.keys = saved_ob_item;
         lo.values = NULL;
@@ -2257,7 +2999,14 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
             }
         }
 
-        for (i = 0; i < saved_ob_size ; i++) {
+        if (keylist != NULL) {
+            assert(Py_SIZE(keylist) == saved_ob_size);
+            for (i = 0; i < saved_ob_size ; i++) {
+                keys[i] = PyList_GET_ITEM(keylist, i);
+                Py_INCREF(keys[i]);
+            }
+        }
+        else for (i = 0; i < saved_ob_size ; i++) {
             keys[i] = PyObject_CallFunctionObjArgs(keyfunc, saved_ob_item[i],
                                                    NULL);
             if (keys[i] == NULL) {
@@ -2385,48 +3134,12 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
         reverse_slice(&saved_ob_item[0], &saved_ob_item[saved_ob_size]);
     }
 
-    /* March over the array once, left to right, finding natural runs,
-     * and extending short natural runs to minrun elements.
-     */
-    minrun = merge_compute_minrun(nremaining);
-    do {
-        int descending;
-        Py_ssize_t n;
-
-        /* Identify next run. */
-        n = count_run(&ms, lo.keys, lo.keys + nremaining, &descending);
-        if (n < 0)
+    if (nthreads > 1 && parallel_sort_eligible(&ms, nremaining)) {
+        if (parallel_sort(&ms, lo, nremaining, nthreads) < 0)
             goto fail;
-        if (descending)
-            reverse_sortslice(&lo, n);
-        /* If short, extend to min(minrun, nremaining). */
-        if (n < minrun) {
-            const Py_ssize_t force = nremaining <= minrun ?
-                              nremaining : minrun;
-            if (binarysort(&ms, lo, lo.keys + force, lo.keys + n) < 0)
-                goto fail;
-            n = force;
-        }
-        /* Push run onto pending-runs stack, and maybe merge. */
-        assert(ms.n < MAX_MERGE_PENDING);
-        ms.pending[ms.n].base = lo;
-        ms.pending[ms.n].len = n;
-        ++ms.n;
-        if (merge_collapse(&ms) < 0)
-            goto fail;
-        /* Advance to find next run. */
-        sortslice_advance(&lo, n);
-        nremaining -= n;
-    } while (nremaining);
-
-    if (merge_force_collapse(&ms) < 0)
+    }
+    else if (sort_slice(&ms, lo, nremaining) < 0)
         goto fail;
-    assert(ms.n == 1);
-    assert(keys == NULL
-           ? ms.pending[0].base.keys == saved_ob_item
-           : ms.pending[0].base.keys == &keys[0]);
-    assert(ms.pending[0].len == saved_ob_size);
-    lo = ms.pending[0].base;
 
 succeed:
     result = Py_None;
@@ -2478,7 +3191,7 @@ PyList_Sort(PyObject *v)
         PyErr_BadInternalCall();
         return -1;
     }
-    v = list_sort_impl((PyListObject *)v, NULL, 0);
+    v = list_sort_internal((PyListObject *)v, NULL, NULL, 0, 0);
     if (v == NULL)
         return -1;
     Py_DECREF(v);
@@ -106,6 +106,19 @@ _PyLong_Negate(PyLongObject **x_p)
 #define KARATSUBA_CUTOFF 70
 #define KARATSUBA_SQUARE_CUTOFF (2 * KARATSUBA_CUTOFF)
 
+/* Use Toom-Cook 3-way multiplication instead of Karatsuba when both
+ * operands contain more than TOOM3_CUTOFF digits and their sizes are
+ * within a factor of 1.5.
+ */
+#define TOOM3_CUTOFF 250
+#define TOOM3_SQUARE_CUTOFF (2 * TOOM3_CUTOFF)
+
+/* For int division, use the O(N**2) school algorithm unless both the
+ * divisor and the quotient contain more than BURNIKEL_ZIEGLER_CUTOFF
+ * digits.
+ */
+#define BURNIKEL_ZIEGLER_CUTOFF 100
+
 /* For exponentiation, use the binary left-to-right algorithm
  * unless the exponent contains more than FIVEARY_CUTOFF digits.
  * In that case, do 5 bits at a time.  The potential drawback is that
@@ -1738,6 +1751,68 @@ divrem1(PyLongObject *a, digit n, digit *prem)
     return long_normalize(z);
 }
 
+/* Convert the size_a digits at pin to base _PyLong_DECIMAL_BASE, following
+   Knuth (TAOCP, Volume 2 (3rd edn), section 4.4, Method 1b).  Store the
+   digits at pout, least significant first, and return their number, or -1
+   if an exception occurred. */
+static Py_ssize_t
+long_to_decimal_base(const digit *pin, Py_ssize_t size_a, digit *pout)
+{
+    Py_ssize_t size, i, j;
+
+    size = 0;
+    for (i = size_a; --i >= 0; ) {
+        digit hi = pin[i];
+        for (j = 0; j < size; j++) {
+            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
+            hi = (digit)(z / _PyLong_DECIMAL_BASE);
+            pout[j] = (digit)(z - (twodigits)hi *
+                              _PyLong_DECIMAL_BASE);
+        }
+        while (hi) {
+            pout[size++] = hi % _PyLong_DECIMAL_BASE;
+            hi /= _PyLong_DECIMAL_BASE;
+        }
+        /* check for keyboard interrupt */
+        SIGCHECK({
+                return -1;
+            });
+    }
+    return size;
+}
+
+/* Divide-and-conquer conversions between ints and decimal strings.
+
+   Ints with more than DECIMAL_DC_CUTOFF digits and strings with more than
+   DECIMAL_DC_CUTOFF * _PyLong_DECIMAL_SHIFT decimal digits are split at a
+   power
+
+       P[i] = _PyLong_DECIMAL_BASE ** (DECIMAL_DC_WIDTH << i)
+
+   near their square root, and both parts are converted recursively.  A
+   string is then the concatenation of the parts, and an int is
+   hi * P[i] + lo, so that the conversions take the time of a few
+   multiplications, which use Karatsuba's algorithm, instead of quadratic
+   time.
+
+   To convert an int to a string, it has to be divided by P[i].  This uses
+   Barrett reduction: with the reciprocal R[i] = 2**(2*n) // P[i], where n
+   is the number of bits of P[i], the quotient of x < P[i]**2 is at most 2
+   larger than ((x >> (n - 1)) * R[i]) >> (n + 1).  R[0] is computed by
+   long division.  The square of R[i-1] approximates R[i] to half of its
+   bits, a Newton iteration doubles them, and the remainder of
+   2**(2*n) - P[i] * R[i] corrects the last few units. */
+
+#define DECIMAL_DC_CUTOFF 300
+/* P[0] must have at most DECIMAL_DC_CUTOFF digits, also with 15-bit
+   digits */
+#define DECIMAL_DC_WIDTH 150
+#define DECIMAL_DC_LEVELS 64
+
+static PyLongObject *long_to_decimal_dc(PyLongObject *a, Py_ssize_t *psize);
+static PyLongObject *long_from_decimal_dc(const char *str, const char *end,
+                                          Py_ssize_t ndigits);
+
 /* Convert an integer to a base 10 string.  Returns a new non-shared
    string.  (Return value is non-shared so that callers can modify the
    returned value if necessary.) */
@@ -1752,7 +1827,7 @@ long_to_decimal_string_internal(PyObject *aa,
     PyLongObject *scratch, *a;
     PyObject *str = NULL;
     Py_ssize_t size, strlen, size_a, i, j;
-    digit *pout, *pin, rem, tenpow;
+    digit *pout, rem, tenpow;
     int negative;
     int d;
     enum PyUnicode_Kind kind;
@@ -1782,35 +1857,24 @@ long_to_decimal_string_internal(PyObject *aa,
     d = (33 * _PyLong_DECIMAL_SHIFT) /
         (10 * PyLong_SHIFT - 33 * _PyLong_DECIMAL_SHIFT);
     assert(size_a < PY_SSIZE_T_MAX/2);
-    size = 1 + size_a + size_a / d;
-    scratch = _PyLong_New(size);
-    if (scratch == NULL)
-        return -1;
-
-    /* convert array of base _PyLong_BASE digits in pin to an array of
-       base _PyLong_DECIMAL_BASE digits in pout, following Knuth (TAOCP,
-       Volume 2 (3rd edn), section 4.4, Method 1b). */
-    pin = a->ob_digit;
-    pout = scratch->ob_digit;
-    size = 0;
-    for (i = size_a; --i >= 0; ) {
-        digit hi = pin[i];
-        for (j = 0; j < size; j++) {
-            twodigits z = (twodigits)pout[j] << PyLong_SHIFT | hi;
-            hi = (digit)(z / _PyLong_DECIMAL_BASE);
-            pout[j] = (digit)(z - (twodigits)hi *
-                              _PyLong_DECIMAL_BASE);
-        }
-        while (hi) {
-            pout[size++] = hi % _PyLong_DECIMAL_BASE;
-            hi /= _PyLong_DECIMAL_BASE;
+    if (size_a > DECIMAL_DC_CUTOFF) {
+        /* subquadratic for large ints */
+        scratch = long_to_decimal_dc(a, &size);
+        if (scratch == NULL)
+            return -1;
+    }
+    else {
+        size = 1 + size_a + size_a / d;
+        scratch = _PyLong_New(size);
+        if (scratch == NULL)
+            return -1;
+        size = long_to_decimal_base(a->ob_digit, size_a, scratch->ob_digit);
+        if (size < 0) {
+            Py_DECREF(scratch);
+            return -1;
         }
-        /* check for keyboard interrupt */
-        SIGCHECK({
-                Py_DECREF(scratch);
-                return -1;
-            });
     }
+    pout = scratch->ob_digit;
     /* pout should have at least one digit, so that the case when a = 0
        works correctly */
     if (size == 0)
@@ -2500,6 +2564,12 @@ digit beyond the first.
                             "too many digits in integer");
             return NULL;
         }
+        if (base == 10 && digits > DECIMAL_DC_CUTOFF * _PyLong_DECIMAL_SHIFT) {
+            /* subquadratic for long decimal strings */
+            z = long_from_decimal_dc(str, scan, digits);
+            str = scan;
+            goto finish;
+        }
         size_z = (Py_ssize_t)fsize_z;
         /* Uncomment next line to test exceedingly rare copy code */
         /* size_z = 1; */
@@ -2580,6 +2650,7 @@ digit beyond the first.
             }
         }
     }
+  finish:
     if (z == NULL) {
         return NULL;
     }
@@ -2700,6 +2771,8 @@ PyLong_FromUnicodeObject(PyObject *u, int base)
 /* forward */
 static PyLongObject *x_divrem
     (PyLongObject *, PyLongObject *, PyLongObject **);
+static PyLongObject *bz_divrem
+    (PyLongObject *, PyLongObject *, PyLongObject **);
 static PyObject *long_long(PyObject *v);
 
 /* Int division with remainder, top-level routine */
@@ -2739,6 +2812,12 @@ long_divrem(PyLongObject *a, PyLongObject *b,
             return -1;
         }
     }
+    else if (size_b > BURNIKEL_ZIEGLER_CUTOFF &&
+             size_a - size_b > BURNIKEL_ZIEGLER_CUTOFF) {
+        z = bz_divrem(a, b, prem);
+        if (z == NULL)
+            return -1;
+    }
     else {
         z = x_divrem(a, b, prem);
         if (z == NULL)
@@ -3422,6 +3501,7 @@ kmul_split(PyLongObject *n,
 }
 
 static PyLongObject *k_lopsided_mul(PyLongObject *a, PyLongObject *b);
+static PyLongObject *t3_mul(PyLongObject *a, PyLongObject *b);
 
 /* Karatsuba multiplication.  Ignores the input signs, and returns the
  * absolute value of the product (or NULL if error).
@@ -3480,6 +3560,11 @@ k_mul(PyLongObject *a, PyLongObject *b)
     if (2 * asize <= bsize)
         return k_lopsided_mul(a, b);
 
+    /* Split in three for large balanced inputs. */
+    i = a == b ? TOOM3_SQUARE_CUTOFF : TOOM3_CUTOFF;
+    if (asize > i && 2 * bsize < 3 * asize)
+        return t3_mul(a, b);
+
     /* Split a & b into hi & lo pieces. */
     shift = bsize >> 1;
     if (kmul_split(a, shift, &ah, &al) < 0) goto fail;
@@ -3702,6 +3787,200 @@ k_lopsided_mul(PyLongObject *a, PyLongObject *b)
     return NULL;
 }
 
+/* A helper for Toom-Cook multiplication (t3_mul).  Split abs(n) into
+ * n2*X**2 + n1*X + n0, with X = BASE**shift, and set p[0] to p[4] to the
+ * values of this polynomial at 0, 1, -1, -2 and infinity.
+ * Returns 0 on success, -1 on failure.
+ */
+static int
+t3_evaluate(PyLongObject *n, Py_ssize_t shift, PyLongObject **p)
+{
+    PyLongObject *n0, *n1, *n2, *t, *s;
+    int i;
+
+    for (i = 0; i < 5; i++)
+        p[i] = NULL;
+    if (kmul_split(n, shift, &t, &n0) < 0)
+        return -1;
+    i = kmul_split(t, shift, &n2, &n1);
+    Py_DECREF(t);
+    if (i < 0) {
+        Py_DECREF(n0);
+        return -1;
+    }
+    p[0] = n0;
+    p[4] = n2;
+
+    s = (PyLongObject *)long_add(n0, n2);
+    if (s == NULL)
+        goto fail;
+    p[1] = (PyLongObject *)long_add(s, n1);
+    p[2] = (PyLongObject *)long_sub(s, n1);
+    Py_DECREF(s);
+    if (p[1] == NULL || p[2] == NULL)
+        goto fail;
+
+    /* p(-2) = 2*(p(-1) + n2) - n0 */
+    t = (PyLongObject *)long_add(p[2], n2);
+    if (t == NULL)
+        goto fail;
+    s = (PyLongObject *)long_add(t, t);
+    Py_DECREF(t);
+    if (s == NULL)
+        goto fail;
+    p[3] = (PyLongObject *)long_sub(s, n0);
+    Py_DECREF(s);
+    if (p[3] == NULL)
+        goto fail;
+    Py_DECREF(n1);
+    return 0;
+
+  fail:
+    Py_DECREF(n1);
+    for (i = 0; i < 5; i++)
+        Py_CLEAR(p[i]);
+    return -1;
+}
+
+/* Signed k_mul(), for the values of t3_mul(). */
+static PyLongObject *
+t3_signed_mul(PyLongObject *a, PyLongObject *b)
+{
+    PyLongObject *z = k_mul(a, b);
+
+    if (z != NULL && (Py_SIZE(a) ^ Py_SIZE(b)) < 0)
+        _PyLong_Negate(&z);
+    return z;
+}
+
+/* Divide a by the small n, which must divide it exactly. */
+static PyLongObject *
+t3_divexact(PyLongObject *a, digit n)
+{
+    PyLongObject *z;
+    digit rem;
+
+    if (a == NULL)
+        return NULL;
+    z = divrem1(a, n, &rem);
+    assert(rem == 0);
+    if (z != NULL && Py_SIZE(a) < 0)
+        Py_SIZE(z) = -Py_SIZE(z);
+    return z;
+}
+
+/* Toom-Cook 3-way multiplication.  Ignores the input signs, and returns
+ * the absolute value of the product (or NULL if error).
+ * See Knuth Vol. 2 Chapter 4.3.3 (Pp. 296-301).
+ */
+static PyLongObject *
+t3_mul(PyLongObject *a, PyLongObject *b)
+{
+    const Py_ssize_t asize = Py_ABS(Py_SIZE(a));
+    const Py_ssize_t bsize = Py_ABS(Py_SIZE(b));
+    PyLongObject *pa[5], *pb[5], *r[5] = {NULL, NULL, NULL, NULL, NULL};
+    PyLongObject *ret = NULL, *t;
+    Py_ssize_t shift;           /* the number of digits of each piece */
+    int i;
+
+    /* With a = a2*X**2 + a1*X + a0 and b likewise, the product is a
+     * polynomial of degree 4 in X.  Its values at 0, 1, -1, -2 and
+     * infinity take 5 multiplies on numbers a third of the size, and the
+     * coefficients are recovered with the interpolation sequence of
+     * M. Bodrato, "Towards Optimal Toom-Cook Multiplication for Univariate
+     * and Multivariate Polynomials in Characteristic 2 and 0" (2007).
+     */
+    assert(asize <= bsize && 2 * bsize < 3 * asize);
+    shift = (bsize + 2) / 3;
+    if (t3_evaluate(a, shift, pa) < 0)
+        return NULL;
+    if (a == b) {
+        for (i = 0; i < 5; i++) {
+            pb[i] = pa[i];
+            Py_INCREF(pb[i]);
+        }
+    }
+    else if (t3_evaluate(b, shift, pb) < 0) {
+        for (i = 0; i < 5; i++)
+            Py_DECREF(pa[i]);
+        return NULL;
+    }
+    for (i = 0; i < 5; i++) {
+        /* k_mul() squares if both arguments are the same object */
+        r[i] = t3_signed_mul(pa[i], a == b ? pa[i] : pb[i]);
+        if (r[i] == NULL)
+            break;
+    }
+    for (i = 0; i < 5; i++) {
+        Py_DECREF(pa[i]);
+        Py_DECREF(pb[i]);
+    }
+    if (r[4] == NULL)
+        goto fail;
+
+    /* r[3] <- (r(-2) - r(1)) / 3 */
+    t = (PyLongObject *)long_sub(r[3], r[1]);
+    Py_SETREF(r[3], t3_divexact(t, 3));
+    Py_XDECREF(t);
+    if (r[3] == NULL)
+        goto fail;
+    /* r[1] <- (r(1) - r(-1)) / 2 */
+    t = (PyLongObject *)long_sub(r[1], r[2]);
+    Py_SETREF(r[1], t3_divexact(t, 2));
+    Py_XDECREF(t);
+    if (r[1] == NULL)
+        goto fail;
+    /* r[2] <- r(-1) - r(0) */
+    Py_SETREF(r[2], (PyLongObject *)long_sub(r[2], r[0]));
+    if (r[2] == NULL)
+        goto fail;
+    /* r[3] <- (r[2] - r[3]) / 2 + 2*r(inf) */
+    t = (PyLongObject *)long_sub(r[2], r[3]);
+    Py_SETREF(r[3], t3_divexact(t, 2));
+    Py_XDECREF(t);
+    if (r[3] == NULL)
+        goto fail;
+    for (i = 0; i < 2; i++) {
+        Py_SETREF(r[3], (PyLongObject *)long_add(r[3], r[4]));
+        if (r[3] == NULL)
+            goto fail;
+    }
+    /* r[2] <- r[2] + r[1] - r(inf) */
+    Py_SETREF(r[2], (PyLongObject *)long_add(r[2], r[1]));
+    if (r[2] == NULL)
+        goto fail;
+    Py_SETREF(r[2], (PyLongObject *)long_sub(r[2], r[4]));
+    if (r[2] == NULL)
+        goto fail;
+    /* r[1] <- r[1] - r[3] */
+    Py_SETREF(r[1], (PyLongObject *)long_sub(r[1], r[3]));
+    if (r[1] == NULL)
+        goto fail;
+
+    /* The coefficients r[i] are >= 0, and the sum of r[i]*X**i fits in
+     * asize + bsize digits, so adding them never runs out of room.
+     */
+    ret = _PyLong_New(asize + bsize);
+    if (ret == NULL)
+        goto fail;
+    memset(ret->ob_digit, 0, Py_SIZE(ret) * sizeof(digit));
+    for (i = 0; i < 5; i++) {
+        assert(Py_SIZE(r[i]) >= 0);
+        if (Py_SIZE(r[i]) > 0) {
+            assert(i * shift + Py_SIZE(r[i]) <= Py_SIZE(ret));
+            (void)v_iadd(ret->ob_digit + i * shift, Py_SIZE(ret) - i * shift,
+                         r[i]->ob_digit, Py_SIZE(r[i]));
+        }
+        Py_CLEAR(r[i]);
+    }
+    return long_normalize(ret);
+
+  fail:
+    for (i = 0; i < 5; i++)
+        Py_XDECREF(r[i]);
+    return NULL;
+}
+
 static PyObject *
 long_mul(PyLongObject *a, PyLongObject *b)
 {
@@ -3856,6 +4135,708 @@ l_divmod(PyLongObject *v, PyLongObject *w,
     return 0;
 }
 
+/* Recursive division of Burnikel and Ziegler, "Fast Recursive Division"
+   (MPI-I-98-1-022, 1998), for large divisors.  Dividing a number of 2*n
+   digits by one of n digits is reduced to two divisions of 3*n/2 digits
+   by n digits, each of which takes a division of n digits by n/2 digits
+   and a multiplication of n/2 digits, so that division is about as fast
+   as multiplication. */
+
+/* Return the digits lo to hi - 1 of abs(a), as an int >= 0. */
+static PyLongObject *
+bz_slice(PyLongObject *a, Py_ssize_t lo, Py_ssize_t hi)
+{
+    PyLongObject *z;
+    Py_ssize_t size_a = Py_ABS(Py_SIZE(a));
+
+    hi = Py_MIN(hi, size_a);
+    lo = Py_MIN(lo, hi);
+    z = _PyLong_New(hi - lo);
+    if (z == NULL)
+        return NULL;
+    memcpy(z->ob_digit, a->ob_digit + lo, (hi - lo) * sizeof(digit));
+    return long_normalize(z);
+}
+
+/* Return hi * BASE**n + lo, for 0 <= hi and 0 <= lo < BASE**n. */
+static PyLongObject *
+bz_join(PyLongObject *hi, PyLongObject *lo, Py_ssize_t n)
+{
+    PyLongObject *z;
+    Py_ssize_t size_hi = Py_SIZE(hi), size_lo = Py_SIZE(lo);
+
+    assert(size_hi >= 0 && size_lo >= 0 && size_lo <= n);
+    if (size_hi == 0) {
+        Py_INCREF(lo);
+        return lo;
+    }
+    z = _PyLong_New(n + size_hi);
+    if (z == NULL)
+        return NULL;
+    memcpy(z->ob_digit, lo->ob_digit, size_lo * sizeof(digit));
+    memset(z->ob_digit + size_lo, 0, (n - size_lo) * sizeof(digit));
+    memcpy(z->ob_digit + n, hi->ob_digit, size_hi * sizeof(digit));
+    return z;
+}
+
+static int bz_div3n2n(PyLongObject *a12, PyLongObject *a3, PyLongObject *b,
+                      PyLongObject *b1, PyLongObject *b2, Py_ssize_t n,
+                      PyLongObject **pq, PyLongObject **pr);
+
+/* Divide 0 <= a < b * BASE**n by b, which has n digits and a top digit
+   >= BASE/2. */
+static int
+bz_div2n1n(PyLongObject *a, PyLongObject *b, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *b1 = NULL, *b2 = NULL, *a12 = NULL, *a3 = NULL;
+    PyLongObject *q1 = NULL, *q2 = NULL, *r = NULL;
+    Py_ssize_t half;
+    int pad, res = -1;
+
+    assert(Py_SIZE(b) == n);
+    if (Py_SIZE(a) - n <= BURNIKEL_ZIEGLER_CUTOFF)
+        return long_divrem(a, b, pq, pr);
+
+    /* make n even, by shifting a and b by one digit */
+    pad = n & 1;
+    if (pad) {
+        a = (PyLongObject *)_PyLong_Lshift((PyObject *)a, PyLong_SHIFT);
+        if (a == NULL)
+            return -1;
+        b = (PyLongObject *)_PyLong_Lshift((PyObject *)b, PyLong_SHIFT);
+        if (b == NULL) {
+            Py_DECREF(a);
+            return -1;
+        }
+        n++;
+    }
+    half = n >> 1;
+
+    /* b = b1 * BASE**half + b2 */
+    b1 = bz_slice(b, half, n);
+    b2 = bz_slice(b, 0, half);
+    a12 = bz_slice(a, n, PY_SSIZE_T_MAX);
+    a3 = bz_slice(a, half, n);
+    if (b1 == NULL || b2 == NULL || a12 == NULL || a3 == NULL)
+        goto done;
+    if (bz_div3n2n(a12, a3, b, b1, b2, half, &q1, &r) < 0)
+        goto done;
+    Py_SETREF(a3, bz_slice(a, 0, half));
+    if (a3 == NULL)
+        goto done;
+    Py_SETREF(a12, r);
+    r = NULL;
+    if (bz_div3n2n(a12, a3, b, b1, b2, half, &q2, &r) < 0)
+        goto done;
+    if (pad) {
+        /* the remainder was shifted too */
+        Py_SETREF(r, bz_slice(r, 1, PY_SSIZE_T_MAX));
+        if (r == NULL)
+            goto done;
+    }
+    *pq = bz_join(q1, q2, half);
+    if (*pq == NULL)
+        goto done;
+    *pr = r;
+    r = NULL;
+    res = 0;
+
+  done:
+    if (pad) {
+        Py_DECREF(a);
+        Py_DECREF(b);
+    }
+    Py_XDECREF(b1);
+    Py_XDECREF(b2);
+    Py_XDECREF(a12);
+    Py_XDECREF(a3);
+    Py_XDECREF(q1);
+    Py_XDECREF(q2);
+    Py_XDECREF(r);
+    return res;
+}
+
+/* Divide a12 * BASE**n + a3 < b * BASE**n by b = b1 * BASE**n + b2, with
+   0 <= a3 < BASE**n and b1 >= BASE**n / 2. */
+static int
+bz_div3n2n(PyLongObject *a12, PyLongObject *a3, PyLongObject *b,
+           PyLongObject *b1, PyLongObject *b2, Py_ssize_t n,
+           PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *q, *r, *t;
+    Py_ssize_t i;
+
+    /* estimate the quotient of a12 // b1, which is at most 2 too large */
+    t = bz_slice(a12, n, PY_SSIZE_T_MAX);
+    if (t == NULL)
+        return -1;
+    i = long_compare(t, b1);
+    Py_DECREF(t);
+    assert(i <= 0);
+    if (i == 0) {
+        /* q = BASE**n - 1, r = a12 - b1 * BASE**n + b1 */
+        q = _PyLong_New(n);
+        if (q == NULL)
+            return -1;
+        for (i = 0; i < n; i++)
+            q->ob_digit[i] = PyLong_MASK;
+        t = bz_join(b1, (PyLongObject *)_PyLong_Zero, n);
+        if (t == NULL) {
+            Py_DECREF(q);
+            return -1;
+        }
+        r = (PyLongObject *)long_sub(a12, t);
+        Py_DECREF(t);
+        if (r != NULL)
+            Py_SETREF(r, (PyLongObject *)long_add(r, b1));
+        if (r == NULL) {
+            Py_DECREF(q);
+            return -1;
+        }
+    }
+    else if (bz_div2n1n(a12, b1, n, &q, &r) < 0)
+        return -1;
+
+    /* r = r * BASE**n + a3 - q * b2 */
+    t = (PyLongObject *)long_mul(q, b2);
+    if (t == NULL)
+        goto error;
+    Py_SETREF(r, bz_join(r, a3, n));
+    if (r == NULL) {
+        Py_DECREF(t);
+        goto error;
+    }
+    Py_SETREF(r, (PyLongObject *)long_sub(r, t));
+    Py_DECREF(t);
+    if (r == NULL)
+        goto error;
+    while (Py_SIZE(r) < 0) {
+        Py_SETREF(q, (PyLongObject *)long_sub(q, (PyLongObject *)_PyLong_One));
+        if (q == NULL)
+            goto error;
+        Py_SETREF(r, (PyLongObject *)long_add(r, b));
+        if (r == NULL)
+            goto error;
+    }
+    *pq = q;
+    *pr = r;
+    return 0;
+
+  error:
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    return -1;
+}
+
+/* Unsigned int division with remainder, for large v1 and w1, with
+   Py_ABS(Py_SIZE(w1)) > BURNIKEL_ZIEGLER_CUTOFF. */
+static PyLongObject *
+bz_divrem(PyLongObject *v1, PyLongObject *w1, PyLongObject **prem)
+{
+    PyLongObject *v, *w, *a, *q, *r = NULL, *t;
+    Py_ssize_t i, k, n;
+    int d;
+
+    *prem = NULL;
+    /* normalize, as in x_divrem(), and split v in pieces of n digits */
+    n = Py_ABS(Py_SIZE(w1));
+    d = PyLong_SHIFT - bits_in_digit(w1->ob_digit[n - 1]);
+    w = bz_slice(w1, 0, n);
+    if (w == NULL)
+        return NULL;
+    Py_SETREF(w, (PyLongObject *)_PyLong_Lshift((PyObject *)w, d));
+    if (w == NULL)
+        return NULL;
+    v = bz_slice(v1, 0, PY_SSIZE_T_MAX);
+    if (v == NULL) {
+        Py_DECREF(w);
+        return NULL;
+    }
+    Py_SETREF(v, (PyLongObject *)_PyLong_Lshift((PyObject *)v, d));
+    if (v == NULL) {
+        Py_DECREF(w);
+        return NULL;
+    }
+    assert(Py_SIZE(w) == n);
+    k = (Py_SIZE(v) + n - 1) / n;
+    a = _PyLong_New(k * n);
+    if (a == NULL)
+        goto error;
+
+    /* long division in base BASE**n, from the top */
+    r = (PyLongObject *)_PyLong_Zero;
+    Py_INCREF(r);
+    for (i = k; --i >= 0; ) {
+        t = bz_slice(v, i * n, (i + 1) * n);
+        if (t == NULL)
+            goto error;
+        Py_SETREF(t, bz_join(r, t, n));
+        if (t == NULL)
+            goto error;
+        Py_CLEAR(r);
+        if (bz_div2n1n(t, w, n, &q, &r) < 0) {
+            Py_DECREF(t);
+            goto error;
+        }
+        Py_DECREF(t);
+        assert(Py_SIZE(q) <= n);
+        memcpy(a->ob_digit + i * n, q->ob_digit, Py_SIZE(q) * sizeof(digit));
+        memset(a->ob_digit + i * n + Py_SIZE(q), 0,
+               (n - Py_SIZE(q)) * sizeof(digit));
+        Py_DECREF(q);
+    }
+
+    /* unshift remainder */
+    *prem = (PyLongObject *)_PyLong_Rshift((PyObject *)r, d);
+    if (*prem == NULL)
+        goto error;
+    Py_DECREF(r);
+    Py_DECREF(v);
+    Py_DECREF(w);
+    return long_normalize(a);
+
+  error:
+    Py_XDECREF(a);
+    Py_XDECREF(r);
+    Py_DECREF(v);
+    Py_DECREF(w);
+    return NULL;
+}
+
+typedef struct {
+    int n;
+    PyLongObject *pow[DECIMAL_DC_LEVELS];
+    /* NULL unless computed */
+    PyLongObject *inv[DECIMAL_DC_LEVELS];
+    size_t bits[DECIMAL_DC_LEVELS];
+} decimal_powers;
+
+/* The powers with up to DECIMAL_DC_CACHE_SIZE digits and their reciprocals
+   are kept between conversions. */
+#define DECIMAL_DC_CACHE_SIZE 4096
+
+static decimal_powers decimal_powers_cache;
+
+/* Start with the cached powers. */
+static void
+decimal_powers_init(decimal_powers *dp)
+{
+    decimal_powers *cache = &decimal_powers_cache;
+    int i;
+
+    for (i = 0; i < cache->n; i++) {
+        dp->pow[i] = cache->pow[i];
+        Py_INCREF(dp->pow[i]);
+        dp->inv[i] = cache->inv[i];
+        Py_XINCREF(dp->inv[i]);
+        dp->bits[i] = cache->bits[i];
+    }
+    dp->n = cache->n;
+}
+
+static void
+decimal_powers_release(decimal_powers *dp)
+{
+    int i;
+
+    for (i = 0; i < dp->n; i++) {
+        Py_CLEAR(dp->pow[i]);
+        Py_CLEAR(dp->inv[i]);
+    }
+    dp->n = 0;
+}
+
+/* Add the small powers and the reciprocals computed since
+   decimal_powers_init() to the cache, and release dp. */
+static void
+decimal_powers_clear(decimal_powers *dp)
+{
+    decimal_powers *cache = &decimal_powers_cache;
+    int i;
+
+    for (i = 0; i < dp->n; i++) {
+        if (i == cache->n && Py_SIZE(dp->pow[i]) <= DECIMAL_DC_CACHE_SIZE) {
+            cache->pow[i] = dp->pow[i];
+            Py_INCREF(cache->pow[i]);
+            cache->inv[i] = NULL;
+            cache->bits[i] = dp->bits[i];
+            cache->n++;
+        }
+        if (i < cache->n && cache->inv[i] == NULL && dp->inv[i] != NULL) {
+            cache->inv[i] = dp->inv[i];
+            Py_INCREF(cache->inv[i]);
+        }
+    }
+    decimal_powers_release(dp);
+}
+
+/* Compute the next power P[dp->n]. */
+static int
+decimal_powers_add(decimal_powers *dp)
+{
+    PyLongObject *p, *base, *tmp;
+    int i;
+
+    assert(dp->n < DECIMAL_DC_LEVELS);
+    if (dp->n == 0) {
+        base = (PyLongObject *)PyLong_FromLong(_PyLong_DECIMAL_BASE);
+        if (base == NULL)
+            return -1;
+        p = base;
+        Py_INCREF(p);
+        for (i = 1; i < DECIMAL_DC_WIDTH; i++) {
+            tmp = (PyLongObject *)long_mul(p, base);
+            Py_DECREF(p);
+            p = tmp;
+            if (p == NULL)
+                break;
+        }
+        Py_DECREF(base);
+    }
+    else {
+        p = (PyLongObject *)long_mul(dp->pow[dp->n - 1],
+                                     dp->pow[dp->n - 1]);
+    }
+    if (p == NULL)
+        return -1;
+    dp->pow[dp->n] = p;
+    dp->inv[dp->n] = NULL;
+    dp->bits[dp->n] = _PyLong_NumBits((PyObject *)p);
+    dp->n++;
+    return 0;
+}
+
+/* Compute the reciprocal R[i], R[i-1] must be computed. */
+static int
+decimal_powers_inverse(decimal_powers *dp, int i)
+{
+    PyLongObject *p = dp->pow[i], *t, *r = NULL, *e = NULL, *tmp;
+    size_t n = dp->bits[i];
+
+    assert(dp->inv[i] == NULL);
+    t = (PyLongObject *)_PyLong_Lshift(_PyLong_One, 2 * n);
+    if (t == NULL)
+        return -1;
+    if (i == 0) {
+        if (l_divmod(t, p, &r, NULL) < 0)
+            goto error;
+        Py_DECREF(t);
+        dp->inv[i] = r;
+        return 0;
+    }
+
+    /* the square of R[i-1], scaled to 2**(2*n) */
+    assert(dp->inv[i - 1] != NULL);
+    tmp = (PyLongObject *)long_mul(dp->inv[i - 1], dp->inv[i - 1]);
+    if (tmp == NULL)
+        goto error;
+    r = (PyLongObject *)_PyLong_Rshift((PyObject *)tmp,
+                                       4 * dp->bits[i - 1] - 2 * n);
+    Py_DECREF(tmp);
+    if (r == NULL)
+        goto error;
+
+    /* r += (r * (2**(2*n) - p * r)) >> (2*n) */
+    tmp = (PyLongObject *)long_mul(p, r);
+    if (tmp == NULL)
+        goto error;
+    e = (PyLongObject *)long_sub(t, tmp);
+    Py_DECREF(tmp);
+    if (e == NULL)
+        goto error;
+    tmp = (PyLongObject *)long_mul(r, e);
+    Py_CLEAR(e);
+    if (tmp == NULL)
+        goto error;
+    Py_SETREF(tmp, (PyLongObject *)_PyLong_Rshift((PyObject *)tmp, 2 * n));
+    if (tmp == NULL)
+        goto error;
+    Py_SETREF(r, (PyLongObject *)long_add(r, tmp));
+    Py_DECREF(tmp);
+    if (r == NULL)
+        goto error;
+
+    /* make r exact, with the remainder 0 <= 2**(2*n) - p * r < p */
+    tmp = (PyLongObject *)long_mul(p, r);
+    if (tmp == NULL)
+        goto error;
+    e = (PyLongObject *)long_sub(t, tmp);
+    Py_DECREF(tmp);
+    if (e == NULL)
+        goto error;
+    while (Py_SIZE(e) < 0) {
+        Py_SETREF(e, (PyLongObject *)long_add(e, p));
+        if (e == NULL)
+            goto error;
+        Py_SETREF(r, (PyLongObject *)long_sub(r, (PyLongObject *)_PyLong_One));
+        if (r == NULL)
+            goto error;
+    }
+    while (long_compare(e, p) >= 0) {
+        Py_SETREF(e, (PyLongObject *)long_sub(e, p));
+        if (e == NULL)
+            goto error;
+        Py_SETREF(r, (PyLongObject *)long_add(r, (PyLongObject *)_PyLong_One));
+        if (r == NULL)
+            goto error;
+    }
+    Py_DECREF(e);
+    Py_DECREF(t);
+    dp->inv[i] = r;
+    return 0;
+
+  error:
+    Py_XDECREF(e);
+    Py_XDECREF(r);
+    Py_DECREF(t);
+    return -1;
+}
+
+/* Divide 0 <= x < P[i]**2 by P[i], using R[i]. */
+static int
+decimal_divmod(decimal_powers *dp, int i, PyLongObject *x,
+               PyLongObject **pq, PyLongObject **pr)
+{
+    PyLongObject *p = dp->pow[i], *q, *r, *tmp;
+    size_t n = dp->bits[i];
+
+    tmp = (PyLongObject *)_PyLong_Rshift((PyObject *)x, n - 1);
+    if (tmp == NULL)
+        return -1;
+    Py_SETREF(tmp, (PyLongObject *)long_mul(tmp, dp->inv[i]));
+    if (tmp == NULL)
+        return -1;
+    q = (PyLongObject *)_PyLong_Rshift((PyObject *)tmp, n + 1);
+    Py_DECREF(tmp);
+    if (q == NULL)
+        return -1;
+    tmp = (PyLongObject *)long_mul(q, p);
+    if (tmp == NULL) {
+        Py_DECREF(q);
+        return -1;
+    }
+    r = (PyLongObject *)long_sub(x, tmp);
+    Py_DECREF(tmp);
+    if (r == NULL) {
+        Py_DECREF(q);
+        return -1;
+    }
+    assert(Py_SIZE(r) >= 0);
+    while (long_compare(r, p) >= 0) {
+        Py_SETREF(r, (PyLongObject *)long_sub(r, p));
+        if (r == NULL) {
+            Py_DECREF(q);
+            return -1;
+        }
+        Py_SETREF(q, (PyLongObject *)long_add(q, (PyLongObject *)_PyLong_One));
+        if (q == NULL) {
+            Py_DECREF(r);
+            return -1;
+        }
+    }
+    *pq = q;
+    *pr = r;
+    return 0;
+}
+
+/* Store the DECIMAL_DC_WIDTH << i digits in base _PyLong_DECIMAL_BASE of
+   0 <= x < P[i] at pout, least significant first. */
+static int
+long_to_decimal_dc_rec(decimal_powers *dp, int i, PyLongObject *x,
+                       digit *pout)
+{
+    Py_ssize_t n = (Py_ssize_t)DECIMAL_DC_WIDTH << i, size;
+    PyLongObject *q, *r;
+    int res;
+
+    assert(Py_SIZE(x) >= 0);
+    if (Py_SIZE(x) <= DECIMAL_DC_CUTOFF) {
+        size = long_to_decimal_base(x->ob_digit, Py_SIZE(x), pout);
+        if (size < 0)
+            return -1;
+        assert(size <= n);
+        memset(pout + size, 0, (n - size) * sizeof(digit));
+        return 0;
+    }
+    assert(i > 0);
+    if (decimal_divmod(dp, i - 1, x, &q, &r) < 0)
+        return -1;
+    res = long_to_decimal_dc_rec(dp, i - 1, r, pout);
+    if (res == 0)
+        res = long_to_decimal_dc_rec(dp, i - 1, q, pout + n / 2);
+    Py_DECREF(q);
+    Py_DECREF(r);
+    return res;
+}
+
+/* Convert the absolute value of a to base _PyLong_DECIMAL_BASE, see
+   long_to_decimal_string_internal().  Return a new int, which holds the
+   digits, and set *psize to their number. */
+static PyLongObject *
+long_to_decimal_dc(PyLongObject *a, Py_ssize_t *psize)
+{
+    decimal_powers dp;
+    PyLongObject *x, *scratch = NULL;
+    size_t nbits = _PyLong_NumBits((PyObject *)a);
+    Py_ssize_t size;
+    int i, t;
+
+    if (nbits == (size_t)-1 && PyErr_Occurred())
+        return NULL;
+    if (Py_SIZE(a) < 0) {
+        x = (PyLongObject *)_PyLong_Copy(a);
+        if (x == NULL)
+            return NULL;
+        Py_SIZE(x) = -Py_SIZE(x);
+    }
+    else {
+        x = a;
+        Py_INCREF(x);
+    }
+
+    /* the powers up to P[t-1], so that x < P[t-1]**2 = P[t] */
+    decimal_powers_init(&dp);
+    t = 0;
+    do {
+        if (t == dp.n && decimal_powers_add(&dp) < 0)
+            goto error;
+        t++;
+    } while (nbits > 2 * (dp.bits[t - 1] - 1));
+    for (i = 0; i < t; i++) {
+        if (dp.inv[i] == NULL && decimal_powers_inverse(&dp, i) < 0)
+            goto error;
+    }
+
+    size = (Py_ssize_t)DECIMAL_DC_WIDTH << t;
+    scratch = _PyLong_New(size);
+    if (scratch == NULL)
+        goto error;
+    if (long_to_decimal_dc_rec(&dp, t, x, scratch->ob_digit) < 0)
+        goto error;
+    while (size > 1 && scratch->ob_digit[size - 1] == 0)
+        size--;
+    decimal_powers_clear(&dp);
+    Py_DECREF(x);
+    *psize = size;
+    return scratch;
+
+  error:
+    decimal_powers_clear(&dp);
+    Py_XDECREF(scratch);
+    Py_DECREF(x);
+    return NULL;
+}
+
+/* Convert the n decimal digits at s, which are values from 0 to 9, to an
+   int, with the quadratic algorithm of PyLong_FromString(). */
+static PyLongObject *
+long_from_decimal_digits(const char *s, Py_ssize_t n)
+{
+    PyLongObject *z;
+    digit *pz, *pzstop;
+    twodigits c, convmult;
+    Py_ssize_t i, k;
+
+    /* each group of _PyLong_DECIMAL_SHIFT decimal digits adds less than
+       one digit */
+    z = _PyLong_New(n / _PyLong_DECIMAL_SHIFT + 1);
+    if (z == NULL)
+        return NULL;
+    Py_SIZE(z) = 0;
+    k = (n - 1) % _PyLong_DECIMAL_SHIFT + 1;
+    while (n > 0) {
+        c = 0;
+        convmult = 1;
+        for (i = 0; i < k; i++) {
+            c = c * 10 + *s++;
+            convmult *= 10;
+        }
+        n -= k;
+        k = _PyLong_DECIMAL_SHIFT;
+
+        /* Multiply z by convmult, and add c. */
+        pz = z->ob_digit;
+        pzstop = pz + Py_SIZE(z);
+        for (; pz < pzstop; ++pz) {
+            c += (twodigits)*pz * convmult;
+            *pz = (digit)(c & PyLong_MASK);
+            c >>= PyLong_SHIFT;
+        }
+        if (c) {
+            assert(c < PyLong_BASE);
+            *pz = (digit)c;
+            ++Py_SIZE(z);
+        }
+    }
+    return z;
+}
+
+static PyLongObject *
+long_from_decimal_dc_rec(decimal_powers *dp, const char *s, Py_ssize_t n)
+{
+    PyLongObject *hi, *lo, *z;
+    Py_ssize_t m;
+    int i;
+
+    if (n <= DECIMAL_DC_CUTOFF * _PyLong_DECIMAL_SHIFT)
+        return long_from_decimal_digits(s, n);
+    /* the largest P[i] = 10**m with m < n */
+    for (i = 0;
+         ((Py_ssize_t)DECIMAL_DC_WIDTH * _PyLong_DECIMAL_SHIFT << (i + 1)) < n;
+         i++)
+        ;
+    m = (Py_ssize_t)DECIMAL_DC_WIDTH * _PyLong_DECIMAL_SHIFT << i;
+    assert(m < n);
+    while (dp->n <= i) {
+        if (decimal_powers_add(dp) < 0)
+            return NULL;
+    }
+    hi = long_from_decimal_dc_rec(dp, s, n - m);
+    if (hi == NULL)
+        return NULL;
+    lo = long_from_decimal_dc_rec(dp, s + n - m, m);
+    if (lo == NULL) {
+        Py_DECREF(hi);
+        return NULL;
+    }
+    Py_SETREF(hi, (PyLongObject *)long_mul(hi, dp->pow[i]));
+    if (hi == NULL) {
+        Py_DECREF(lo);
+        return NULL;
+    }
+    z = (PyLongObject *)long_add(hi, lo);
+    Py_DECREF(hi);
+    Py_DECREF(lo);
+    return z;
+}
+
+/* Convert the digits from str to end, which has ndigits decimal digits and
+   single underscores between them, to an int. */
+static PyLongObject *
+long_from_decimal_dc(const char *str, const char *end, Py_ssize_t ndigits)
+{
+    decimal_powers dp;
+    PyLongObject *z;
+    char *digits, *p;
+
+    digits = PyMem_Malloc(ndigits);
+    if (digits == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (p = digits; str < end; str++) {
+        if (*str != '_')
+            *p++ = (char)_PyLong_DigitValue[Py_CHARMASK(*str)];
+    }
+    assert(p == digits + ndigits);
+    decimal_powers_init(&dp);
+    z = long_from_decimal_dc_rec(&dp, digits, ndigits);
+    decimal_powers_clear(&dp);
+    PyMem_Free(digits);
+    return z;
+}
+
 static PyObject *
 long_div(PyObject *a, PyObject *b)
 {
@@ -5863,6 +6844,7 @@ PyLong_Fini(void)
        reinitializations will fail. */
     Py_CLEAR(_PyLong_One);
     Py_CLEAR(_PyLong_Zero);
+    decimal_powers_release(&decimal_powers_cache);
 #if NSMALLNEGINTS + NSMALLPOSINTS > 0
     int i;
     PyLongObject *v = small_ints;
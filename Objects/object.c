@@ -1072,10 +1072,11 @@ PyObject_SetAttr(PyObject *v, PyObject *name, PyObject *value)
     return -1;
 }
 
-/* Helper to get a pointer to an object's __dict__ slot, if any */
+/* Helper to get a pointer to an object's __dict__ slot, if any.
+   The slot may hold inline values, see Objects/dictobject.c. */
 
 PyObject **
-_PyObject_GetDictPtr(PyObject *obj)
+_PyObject_GetDictSlot(PyObject *obj)
 {
     Py_ssize_t dictoffset;
     PyTypeObject *tp = Py_TYPE(obj);
@@ -1099,6 +1100,22 @@ _PyObject_GetDictPtr(PyObject *obj)
     return (PyObject **) ((char *)obj + dictoffset);
 }
 
+/* Helper to get a pointer to an object's __dict__ slot, if any.
+   Inline values are replaced by a dict.  Return NULL with an exception
+   set, if that fails. */
+
+PyObject **
+_PyObject_GetDictPtr(PyObject *obj)
+{
+    PyObject **dictptr = _PyObject_GetDictSlot(obj);
+
+    if (dictptr != NULL && _PyDict_IS_INLINE_VALUES(*dictptr) &&
+        _PyObject_MaterializeDict(dictptr) == NULL) {
+        return NULL;
+    }
+    return dictptr;
+}
+
 PyObject *
 PyObject_SelfIter(PyObject *obj)
 {
@@ -1167,7 +1184,24 @@ _PyObject_GetMethod(PyObject *obj, PyObject *name, PyObject **method)
         }
     }
 
-    dictptr = _PyObject_GetDictPtr(obj);
+    dictptr = _PyObject_GetDictSlot(obj);
+    if (dictptr != NULL && _PyDict_IS_INLINE_VALUES(*dictptr)) {
+        if (PyUnicode_CheckExact(name)) {
+            attr = NULL;
+            (void)_PyInlineValues_GetItemHint(*dictptr, name, -1, &attr);
+            if (attr != NULL) {
+                Py_INCREF(attr);
+                *method = attr;
+                Py_XDECREF(descr);
+                return 0;
+            }
+            dictptr = NULL;
+        }
+        else if (_PyObject_MaterializeDict(dictptr) == NULL) {
+            Py_XDECREF(descr);
+            return 0;
+        }
+    }
     if (dictptr != NULL && (dict = *dictptr) != NULL) {
         Py_INCREF(dict);
         attr = PyDict_GetItemWithError(dict, name);
@@ -1277,6 +1311,19 @@ _PyObject_GenericGetAttrWithDict(PyObject *obj, PyObject *name,
             }
             dictptr = (PyObject **) ((char *)obj + dictoffset);
             dict = *dictptr;
+            if (dict != NULL && _PyDict_IS_INLINE_VALUES(dict)) {
+                if (PyUnicode_CheckExact(name)) {
+                    (void)_PyInlineValues_GetItemHint(dict, name, -1, &res);
+                    if (res != NULL) {
+                        Py_INCREF(res);
+                        goto done;
+                    }
+                    dict = NULL;
+                }
+                else if ((dict = _PyObject_MaterializeDict(dictptr)) == NULL) {
+                    goto done;
+                }
+            }
         }
     }
     if (dict != NULL) {
@@ -1374,7 +1421,7 @@ _PyObject_GenericSetAttrWithDict(PyObject *obj, PyObject *name,
     }*/
 
     if (dict == NULL) {
-        dictptr = _PyObject_GetDictPtr(obj);
+        dictptr = _PyObject_GetDictSlot(obj);
         if (dictptr == NULL) {
             if (descr == NULL) {
                 PyErr_Format(PyExc_AttributeError,
@@ -1416,7 +1463,7 @@ PyObject_GenericSetAttr(PyObject *obj, PyObject *name, PyObject *value)
 int
 PyObject_GenericSetDict(PyObject *obj, PyObject *value, void *context)
 {
-    PyObject **dictptr = _PyObject_GetDictPtr(obj);
+    PyObject *olddict, **dictptr = _PyObject_GetDictSlot(obj);
     if (dictptr == NULL) {
         PyErr_SetString(PyExc_AttributeError,
                         "This object has no __dict__");
@@ -1433,7 +1480,14 @@ PyObject_GenericSetDict(PyObject *obj, PyObject *value, void *context)
         return -1;
     }
     Py_INCREF(value);
-    Py_XSETREF(*dictptr, value);
+    olddict = *dictptr;
+    *dictptr = value;
+    if (olddict != NULL && _PyDict_IS_INLINE_VALUES(olddict)) {
+        _PyInlineValues_Free(olddict);
+    }
+    else {
+        Py_XDECREF(olddict);
+    }
     return 0;
 }
 
@@ -1792,6 +1846,7 @@ _PyTypes_Init(void)
     INIT_TYPE(&PySuper_Type, "super");
     INIT_TYPE(&PyRange_Type, "range");
     INIT_TYPE(&PyDict_Type, "dict");
+    INIT_TYPE(&PyFrozenDict_Type, "FrozenDict");
     INIT_TYPE(&PyDictKeys_Type, "dict keys");
     INIT_TYPE(&PyDictValues_Type, "dict values");
     INIT_TYPE(&PyDictItems_Type, "dict items");
@@ -143,16 +143,46 @@ _PyObject_ArenaVirtualFree(void *ctx, void *ptr, size_t size)
 }
 
 #elif defined(ARENAS_USE_MMAP)
+/* Arenas of at least this size are mapped aligned to it, so that the kernel
+   can back them by transparent huge pages. */
+#define HUGE_PAGE_SIZE (2 << 20)
+
 static void *
 _PyObject_ArenaMmap(void *ctx, size_t size)
 {
     void *ptr;
-    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+    uintptr_t aligned;
+    size_t head;
+
+    if (size < HUGE_PAGE_SIZE || size % HUGE_PAGE_SIZE != 0) {
+        ptr = mmap(NULL, size, PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            return NULL;
+        assert(ptr != NULL);
+        return ptr;
+    }
+
+    /* Map one huge page more than requested and unmap the unaligned head
+       and the tail of the mapping. */
+    ptr = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ|PROT_WRITE,
                MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
     if (ptr == MAP_FAILED)
         return NULL;
     assert(ptr != NULL);
-    return ptr;
+    aligned = _Py_SIZE_ROUND_UP((uintptr_t)ptr, HUGE_PAGE_SIZE);
+    head = aligned - (uintptr_t)ptr;
+    if (head != 0) {
+        munmap(ptr, head);
+    }
+    if (head != HUGE_PAGE_SIZE) {
+        munmap((void *)(aligned + size), HUGE_PAGE_SIZE - head);
+    }
+#ifdef MADV_HUGEPAGE
+    /* Only a hint: the arena works without huge pages as well */
+    (void)madvise((void *)aligned, size, MADV_HUGEPAGE);
+#endif
+    return (void *)aligned;
 }
 
 static void
@@ -904,11 +934,20 @@ static int running_on_valgrind = -1;
  *
  * Arenas are allocated with mmap() on systems supporting anonymous memory
  * mappings to reduce heap fragmentation.
+ *
+ * The arena size can be raised at startup with the PYTHONMALLOC_ARENA_SIZE
+ * environment variable or the -X arena_size option, see
+ * _PyObject_SetArenaSize().  Large arenas reduce the number of memory
+ * mappings of big heaps, arenas of 2 MB and more are mapped aligned to 2 MB
+ * and advised to use transparent huge pages, which saves TLB misses.
  */
-#define ARENA_SIZE              (256 << 10)     /* 256KB */
+#define DEFAULT_ARENA_SIZE      (256 << 10)     /* 256KB */
+#define MAX_ARENA_SIZE          (32 << 20)      /* 32MB */
+
+static size_t arena_size = DEFAULT_ARENA_SIZE;
 
 #ifdef WITH_MEMORY_LIMITS
-#define MAX_ARENAS              (SMALL_MEMORY_LIMIT / ARENA_SIZE)
+#define MAX_ARENAS              (SMALL_MEMORY_LIMIT / arena_size)
 #endif
 
 /*
@@ -918,11 +957,13 @@ static int running_on_valgrind = -1;
 #define POOL_SIZE               SYSTEM_PAGE_SIZE        /* must be 2^N */
 #define POOL_SIZE_MASK          SYSTEM_PAGE_SIZE_MASK
 
-#define MAX_POOLS_IN_ARENA  (ARENA_SIZE / POOL_SIZE)
-#if MAX_POOLS_IN_ARENA * POOL_SIZE != ARENA_SIZE
+#define MAX_POOLS_IN_ARENA  (MAX_ARENA_SIZE / POOL_SIZE)
+#if DEFAULT_ARENA_SIZE % POOL_SIZE != 0
 #   error "arena size not an exact multiple of pool size"
 #endif
 
+static uint pools_in_arena = DEFAULT_ARENA_SIZE / POOL_SIZE;
+
 /*
  * -- End of tunable settings section --
  */
@@ -1099,7 +1140,9 @@ the prevpool member.
 #define PTA(x)  ((poolp )((uint8_t *)&(usedpools[2*(x)]) - 2*sizeof(block *)))
 #define PT(x)   PTA(x), PTA(x)
 
-static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
+#define USEDPOOLS_SIZE (2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8)
+
+static poolp usedpools[USEDPOOLS_SIZE] = {
     PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
 #if NB_SMALL_SIZE_CLASSES > 8
     , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
@@ -1127,6 +1170,51 @@ static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
 #endif /* NB_SMALL_SIZE_CLASSES >  8 */
 };
 
+/*==========================================================================
+Thread pool caches.
+
+Every thread state gets its own usedpools table, the thread pool cache.
+Blocks are only allocated while the GIL is held, so there is never more than
+one allocating thread at a time:  take_gil() makes the table of the thread
+that acquired the GIL the current one, and pymalloc_alloc() serves requests
+from current_usedpools.  As a consequence, the blocks a thread allocates come
+from pools that are private to that thread, which keeps its objects close
+together and avoids sharing cache lines with the objects of other threads.
+
+Blocks may be freed by any thread.  A pool that was full is linked back into
+the current table, a pool that becomes empty goes back to its arena as usual.
+The static usedpools table above holds the shared lists.  It is current while
+no thread cache exists (e.g. before the GIL is created, or if the cache could
+not be allocated) and it receives the partially used pools of a thread cache
+when its thread state is cleared.  The pools of the caches of all threads but
+the current one are also returned to the shared lists after each collection
+of the oldest generation, so that the pools of idle threads don't sit around
+unused.  If a size class list of a thread cache is empty, a pool is adopted
+from the shared lists before a free pool is taken from an arena.
+*/
+
+typedef struct thread_pool_cache {
+    poolp usedpools[USEDPOOLS_SIZE];
+    struct thread_pool_cache *prevcache;
+    struct thread_pool_cache *nextcache;
+} thread_pool_cache;
+
+/* The head of the list of pools of size class x in the table t */
+#define POOL_LIST(t, x) ((poolp )((uint8_t *)&((t)[2*(x)]) - 2*sizeof(block *)))
+
+/* The usedpools table of the thread which holds the GIL */
+static poolp *current_usedpools = usedpools;
+
+/* Doubly linked list of all thread pool caches */
+static thread_pool_cache *thread_pool_caches = NULL;
+
+/* Statistics, see _PyObject_DebugMallocStats() */
+static size_t nthread_pool_caches = 0;
+static size_t ntimes_thread_pool_cache_created = 0;
+static size_t ntimes_thread_pool_cache_switched = 0;
+static size_t npools_adopted = 0;
+static size_t npools_returned = 0;
+
 /*==========================================================================
 Arena management.
 
@@ -1193,7 +1281,7 @@ static struct arena_object* usable_arenas = NULL;
 static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
 
 /* How many arena_objects do we initially allocate?
- * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
+ * 16 = can allocate 16 arenas = 16 * arena_size = 4MB before growing the
  * `arenas` vector.
  */
 #define INITIAL_ARENA_OBJECTS 16
@@ -1214,6 +1302,29 @@ _Py_GetAllocatedBlocks(void)
     return _Py_AllocatedBlocks;
 }
 
+int
+_PyObject_SetArenaSize(size_t size)
+{
+    if (size == 0) {
+        size = DEFAULT_ARENA_SIZE;
+    }
+    if (size < DEFAULT_ARENA_SIZE || size > MAX_ARENA_SIZE
+        || (size & (size - 1)) != 0)
+    {
+        return -1;
+    }
+    if (size == arena_size) {
+        return 0;
+    }
+    if (narenas_currently_allocated != 0) {
+        /* address_in_range() requires all arenas to have the same size */
+        return -2;
+    }
+    arena_size = size;
+    pools_in_arena = (uint)(size / POOL_SIZE);
+    return 0;
+}
+
 
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
@@ -1282,7 +1393,7 @@ new_arena(void)
     arenaobj = unused_arena_objects;
     unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
-    address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
+    address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, arena_size);
     if (address == NULL) {
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
@@ -1301,7 +1412,7 @@ new_arena(void)
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
     arenaobj->pool_address = (block*)arenaobj->address;
-    arenaobj->nfreepools = MAX_POOLS_IN_ARENA;
+    arenaobj->nfreepools = pools_in_arena;
     excess = (uint)(arenaobj->address & POOL_SIZE_MASK);
     if (excess != 0) {
         --arenaobj->nfreepools;
@@ -1326,13 +1437,15 @@ called on every alloc/realloc/free, micro-efficiency is important here).
 Tricky:  Let B be the arena base address associated with the pool, B =
 arenas[(POOL)->arenaindex].address.  Then P belongs to the arena if and only if
 
-    B <= P < B + ARENA_SIZE
+    B <= P < B + arena_size
 
 Subtracting B throughout, this is true iff
 
-    0 <= P-B < ARENA_SIZE
+    0 <= P-B < arena_size
 
 By using unsigned arithmetic, the "0 <=" half of the test can be skipped.
+The arena size can only be changed before the first arena is allocated, so
+all arenas have the same size arena_size.
 
 Obscure:  A PyMem "free memory" function can call the pymalloc free or realloc
 before the first arena has been allocated.  `arenas` is still NULL in that
@@ -1343,7 +1456,7 @@ into a NULL arenas.
 Details:  given P and POOL, the arena_object corresponding to P is AO =
 arenas[(POOL)->arenaindex].  Suppose obmalloc controls P.  Then (barring wild
 stores, etc), POOL is the correct address of P's pool, AO.address is the
-correct base address of the pool's arena, and P must be within ARENA_SIZE of
+correct base address of the pool's arena, and P must be within arena_size of
 AO.address.  In addition, AO.address is not 0 (no arena can start at address 0
 (NULL)).  Therefore address_in_range correctly reports that obmalloc
 controls P.
@@ -1356,7 +1469,7 @@ control P.
 
 Else arenaindex is < maxarena, and AO is read up.  If AO corresponds to an
 allocated arena, obmalloc controls all the memory in slice AO.address :
-AO.address+ARENA_SIZE.  By case assumption, P is not controlled by obmalloc,
+AO.address+arena_size.  By case assumption, P is not controlled by obmalloc,
 so P doesn't lie in that slice, so the macro correctly reports that P is not
 controlled by obmalloc.
 
@@ -1364,19 +1477,19 @@ Finally, if P is not controlled by obmalloc and AO corresponds to an unused
 arena_object (one not currently associated with an allocated arena),
 AO.address is 0, and the second test in the macro reduces to:
 
-    P < ARENA_SIZE
+    P < arena_size
 
-If P >= ARENA_SIZE (extremely likely), the macro again correctly concludes
-that P is not controlled by obmalloc.  However, if P < ARENA_SIZE, this part
+If P >= arena_size (extremely likely), the macro again correctly concludes
+that P is not controlled by obmalloc.  However, if P < arena_size, this part
 of the test still passes, and the third clause (AO.address != 0) is necessary
 to get the correct result:  AO.address is 0 in this case, so the macro
 correctly reports that P is not controlled by obmalloc (despite that P lies in
-slice AO.address : AO.address + ARENA_SIZE).
+slice AO.address : AO.address + arena_size).
 
 Note:  The third (AO.address != 0) clause was added in Python 2.5.  Before
 2.5, arenas were never free()'ed, and an arenaindex < maxarena always
 corresponded to a currently-allocated arena, so the "P is not controlled by
-obmalloc, AO corresponds to an unused arena_object, and P < ARENA_SIZE" case
+obmalloc, AO corresponds to an unused arena_object, and P < arena_size" case
 was impossible.
 
 Note that the logic is excruciating, and reading up possibly uninitialized
@@ -1400,7 +1513,7 @@ address_in_range(void *p, poolp pool)
     // only once.
     uint arenaindex = *((volatile uint *)&pool->arenaindex);
     return arenaindex < maxarenas &&
-        (uintptr_t)p - arenas[arenaindex].address < ARENA_SIZE &&
+        (uintptr_t)p - arenas[arenaindex].address < arena_size &&
         arenas[arenaindex].address != 0;
 }
 
@@ -1448,7 +1561,8 @@ pymalloc_alloc(void *ctx, void **ptr_p, size_t nbytes)
      * Most frequent paths first
      */
     size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
-    pool = usedpools[size + size];
+  lookup:
+    pool = current_usedpools[size + size];
     if (pool != pool->nextpool) {
         /*
          * There is a used pool for this size class.
@@ -1481,6 +1595,27 @@ pymalloc_alloc(void *ctx, void **ptr_p, size_t nbytes)
         goto success;
     }
 
+    /* The thread pool cache has no pool of the right size class:
+     * adopt a partially used pool from the shared lists.
+     */
+    if (current_usedpools != usedpools) {
+        pool = usedpools[size + size];
+        if (pool != pool->nextpool) {
+            /* Unlink from the shared list ... */
+            next = pool->nextpool;
+            pool->prevpool->nextpool = next;
+            next->prevpool = pool->prevpool;
+            /* ... and frontlink to the (empty) list of the cache. */
+            next = current_usedpools[size + size];
+            pool->nextpool = next;
+            pool->prevpool = next;
+            next->nextpool = pool;
+            next->prevpool = pool;
+            ++npools_adopted;
+            goto lookup;
+        }
+    }
+
     /* There isn't a pool of the right size class immediately
      * available:  use a free pool.
      */
@@ -1545,12 +1680,12 @@ pymalloc_alloc(void *ctx, void **ptr_p, size_t nbytes)
             assert(usable_arenas->freepools != NULL ||
                    usable_arenas->pool_address <=
                    (block*)usable_arenas->address +
-                       ARENA_SIZE - POOL_SIZE);
+                       arena_size - POOL_SIZE);
         }
 
     init_pool:
         /* Frontlink to used pools. */
-        next = usedpools[size + size]; /* == prev */
+        next = current_usedpools[size + size]; /* == prev */
         pool->nextpool = next;
         pool->prevpool = next;
         next->nextpool = pool;
@@ -1586,7 +1721,7 @@ pymalloc_alloc(void *ctx, void **ptr_p, size_t nbytes)
     assert(usable_arenas->freepools == NULL);
     pool = (poolp)usable_arenas->pool_address;
     assert((block*)pool <= (block*)usable_arenas->address +
-                             ARENA_SIZE - POOL_SIZE);
+                             arena_size - POOL_SIZE);
     pool->arenaindex = (uint)(usable_arenas - arenas);
     assert(&arenas[pool->arenaindex] == usable_arenas);
     pool->szidx = DUMMY_SIZE_IDX;
@@ -1700,7 +1835,7 @@ pymalloc_free(void *ctx, void *p)
         --pool->ref.count;
         assert(pool->ref.count > 0);            /* else the pool is empty */
         size = pool->szidx;
-        next = usedpools[size + size];
+        next = current_usedpools[size + size];
         prev = next->prevpool;
 
         /* insert pool before next:   prev <-> pool <-> next */
@@ -1802,7 +1937,7 @@ pymalloc_free(void *ctx, void *p)
 
         /* Free the entire arena. */
         _PyObject_Arena.free(_PyObject_Arena.ctx,
-                             (void *)ao->address, ARENA_SIZE);
+                             (void *)ao->address, arena_size);
         ao->address = 0;                        /* mark unassociated */
         --narenas_currently_allocated;
 
@@ -1988,6 +2123,117 @@ _PyObject_Realloc(void *ctx, void *ptr, size_t nbytes)
     return PyMem_RawRealloc(ptr, nbytes);
 }
 
+/* Append the pools of all size class lists of the usedpools table 'from' to
+ * the lists of the table 'to'.  Return the number of pools moved.
+ */
+static size_t
+move_used_pools(poolp *from, poolp *to)
+{
+    size_t npools = 0;
+    uint i;
+
+    for (i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        poolp head = POOL_LIST(from, i);
+        poolp first = head->nextpool;
+        poolp last = head->prevpool;
+        poolp tail;
+        poolp pool;
+
+        if (first == head) {
+            continue;
+        }
+        for (pool = first; pool != head; pool = pool->nextpool) {
+            npools++;
+        }
+        /* Link the pools in after the tail of the list of 'to' ... */
+        head = POOL_LIST(to, i);
+        tail = head->prevpool;
+        tail->nextpool = first;
+        first->prevpool = tail;
+        last->nextpool = head;
+        head->prevpool = last;
+        /* ... and leave the list of 'from' empty. */
+        from[i + i] = from[i + i + 1] = POOL_LIST(from, i);
+    }
+    return npools;
+}
+
+void
+_PyObject_SwitchThreadPools(void **cache_p)
+{
+    thread_pool_cache *cache = (thread_pool_cache *)*cache_p;
+
+    if (cache == NULL) {
+        uint i;
+
+        if (!_PyMem_PymallocEnabled()) {
+            return;
+        }
+        cache = (thread_pool_cache *)PyMem_RawMalloc(sizeof(*cache));
+        if (cache == NULL) {
+            /* Not fatal:  allocate from the shared lists instead */
+            current_usedpools = usedpools;
+            return;
+        }
+        for (i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+            cache->usedpools[i + i] = cache->usedpools[i + i + 1] =
+                POOL_LIST(cache->usedpools, i);
+        }
+        cache->prevcache = NULL;
+        cache->nextcache = thread_pool_caches;
+        if (thread_pool_caches != NULL) {
+            thread_pool_caches->prevcache = cache;
+        }
+        thread_pool_caches = cache;
+        ++nthread_pool_caches;
+        ++ntimes_thread_pool_cache_created;
+        *cache_p = cache;
+    }
+    if (current_usedpools != cache->usedpools) {
+        current_usedpools = cache->usedpools;
+        ++ntimes_thread_pool_cache_switched;
+    }
+}
+
+void
+_PyObject_ClearThreadPools(void **cache_p)
+{
+    thread_pool_cache *cache = (thread_pool_cache *)*cache_p;
+
+    if (cache == NULL) {
+        return;
+    }
+    *cache_p = NULL;
+    if (current_usedpools == cache->usedpools) {
+        current_usedpools = usedpools;
+    }
+    npools_returned += move_used_pools(cache->usedpools, usedpools);
+
+    if (cache->prevcache != NULL) {
+        cache->prevcache->nextcache = cache->nextcache;
+    }
+    else {
+        thread_pool_caches = cache->nextcache;
+    }
+    if (cache->nextcache != NULL) {
+        cache->nextcache->prevcache = cache->prevcache;
+    }
+    --nthread_pool_caches;
+    PyMem_RawFree(cache);
+}
+
+void
+_PyObject_ReturnIdleThreadPools(void)
+{
+    thread_pool_cache *cache;
+
+    for (cache = thread_pool_caches; cache != NULL; cache = cache->nextcache) {
+        if (cache->usedpools != current_usedpools) {
+            npools_returned += move_used_pools(cache->usedpools, usedpools);
+        }
+    }
+}
+
 #else   /* ! WITH_PYMALLOC */
 
 /*==========================================================================*/
@@ -2000,6 +2246,27 @@ _Py_GetAllocatedBlocks(void)
     return 0;
 }
 
+int
+_PyObject_SetArenaSize(size_t size)
+{
+    return 0;
+}
+
+void
+_PyObject_SwitchThreadPools(void **cache_p)
+{
+}
+
+void
+_PyObject_ClearThreadPools(void **cache_p)
+{
+}
+
+void
+_PyObject_ReturnIdleThreadPools(void)
+{
+}
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2580,6 +2847,23 @@ pool_is_in_list(const poolp target, poolp list)
     } while (list != NULL && list != origlist);
     return 0;
 }
+
+/* Is target in the list of size class sz of the shared usedpools table or of
+ * a thread pool cache?  Return 1 if so, else 0.
+ */
+static int
+pool_is_in_used_pools(const poolp target, uint sz)
+{
+    thread_pool_cache *cache;
+
+    if (pool_is_in_list(target, usedpools[sz + sz]))
+        return 1;
+    for (cache = thread_pool_caches; cache != NULL; cache = cache->nextcache) {
+        if (pool_is_in_list(target, cache->usedpools[sz + sz]))
+            return 1;
+    }
+    return 0;
+}
 #endif
 
 /* Print summary info to "out" about the state of pymalloc's structures.
@@ -2619,7 +2903,7 @@ _PyObject_DebugMallocStats(FILE *out)
     size_t quantization = 0;
     /* # of arenas actually allocated. */
     size_t narenas = 0;
-    /* running total -- should equal narenas * ARENA_SIZE */
+    /* running total -- should equal narenas * arena_size */
     size_t total;
     char buf[128];
 
@@ -2672,7 +2956,7 @@ _PyObject_DebugMallocStats(FILE *out)
             numfreeblocks[sz] += freeblocks;
 #ifdef Py_DEBUG
             if (freeblocks > 0)
-                assert(pool_is_in_list(p, usedpools[sz + sz]));
+                assert(pool_is_in_used_pools(p, sz));
 #endif
         }
     }
@@ -2714,9 +2998,19 @@ _PyObject_DebugMallocStats(FILE *out)
     (void)printone(out, "# arenas allocated current", narenas);
 
     PyOS_snprintf(buf, sizeof(buf),
-        "%" PY_FORMAT_SIZE_T "u arenas * %d bytes/arena",
-        narenas, ARENA_SIZE);
-    (void)printone(out, buf, narenas * ARENA_SIZE);
+        "%" PY_FORMAT_SIZE_T "u arenas * %" PY_FORMAT_SIZE_T "u bytes/arena",
+        narenas, arena_size);
+    (void)printone(out, buf, narenas * arena_size);
+
+    fputc('\n', out);
+
+    (void)printone(out, "# thread pool caches current", nthread_pool_caches);
+    (void)printone(out, "# thread pool caches created",
+                   ntimes_thread_pool_cache_created);
+    (void)printone(out, "# thread pool cache switches",
+                   ntimes_thread_pool_cache_switched);
+    (void)printone(out, "# pools adopted from shared lists", npools_adopted);
+    (void)printone(out, "# pools returned to shared lists", npools_returned);
 
     fputc('\n', out);
 
@@ -17,6 +17,205 @@
 /* 10xxxxxx */
 #define IS_CONTINUATION_BYTE(ch) ((ch) >= 0x80 && (ch) < 0xC0)
 
+#ifdef HAVE_UTF8_SSSE3
+/* Store 16 ASCII characters */
+__attribute__((target("ssse3")))
+Py_LOCAL_INLINE(void)
+STRINGLIB(utf8_store_ascii)(STRINGLIB_CHAR *p, __m128i in)
+{
+#if STRINGLIB_SIZEOF_CHAR == 1
+    _mm_storeu_si128((__m128i *)p, in);
+#else
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(in, zero);
+    __m128i hi = _mm_unpackhi_epi8(in, zero);
+# if STRINGLIB_SIZEOF_CHAR == 2
+    _mm_storeu_si128((__m128i *)p, lo);
+    _mm_storeu_si128((__m128i *)(p + 8), hi);
+# else
+    _mm_storeu_si128((__m128i *)p, _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i *)(p + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i *)(p + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i *)(p + 12), _mm_unpackhi_epi16(hi, zero));
+# endif
+#endif
+}
+
+/* Store the 16-bit lanes of chars selected by the 8 bits of mask, see
+   utf8_simd_pack16 in unicodeobject.c.  Return the number of characters. */
+__attribute__((target("ssse3")))
+Py_LOCAL_INLINE(int)
+STRINGLIB(utf8_store_pack16)(STRINGLIB_CHAR *p, __m128i chars, int mask)
+{
+    chars = _mm_shuffle_epi8(chars, _mm_loadu_si128(
+        (const __m128i *)utf8_simd_pack16[mask]));
+#if STRINGLIB_SIZEOF_CHAR == 1
+    _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(chars, chars));
+#elif STRINGLIB_SIZEOF_CHAR == 2
+    _mm_storeu_si128((__m128i *)p, chars);
+#else
+    _mm_storeu_si128((__m128i *)p,
+                     _mm_unpacklo_epi16(chars, _mm_setzero_si128()));
+    _mm_storeu_si128((__m128i *)(p + 4),
+                     _mm_unpackhi_epi16(chars, _mm_setzero_si128()));
+#endif
+    return utf8_simd_count[mask];
+}
+
+#if STRINGLIB_SIZEOF_CHAR == 4
+/* Store the 32-bit lanes of chars selected by the 4 bits of mask. */
+__attribute__((target("ssse3")))
+Py_LOCAL_INLINE(int)
+STRINGLIB(utf8_store_pack32)(STRINGLIB_CHAR *p, __m128i chars, int mask)
+{
+    _mm_storeu_si128((__m128i *)p, _mm_shuffle_epi8(chars, _mm_loadu_si128(
+        (const __m128i *)utf8_simd_pack32[mask])));
+    return utf8_simd_count[mask];
+}
+#endif
+
+/* Decode blocks of 16 bytes with SSSE3 instructions, as long as more than
+   16 bytes remain.  A block is validated as a whole.  Then the code point
+   of every character is computed in the lane of its last byte, from this
+   byte and the up to three bytes before it, and the lanes of the last bytes
+   are packed and stored.  A character that doesn't end in a block is
+   stored with the next one, so that the blocks don't depend on each other,
+   except for the output position.
+   The decoder stops at the first block that contains invalid data or a
+   character greater than STRINGLIB_MAX_CHAR, and leaves it to
+   STRINGLIB(utf8_decode) from the start of the first character that it
+   didn't store.  It writes up to 16 characters beyond the decoded ones,
+   but never more than bytes remain, which the output buffer has room
+   for. */
+__attribute__((target("ssse3")))
+static void
+STRINGLIB(utf8_decode_ssse3)(const char **inptr, const char *end,
+                             STRINGLIB_CHAR **outptr)
+{
+    const char *s = *inptr;
+    STRINGLIB_CHAR *p = *outptr;
+    /* 10xxxxxx, compared as signed bytes */
+    const __m128i cont_limit = _mm_set1_epi8(-0x40);
+    const __m128i zero = _mm_setzero_si128();
+    /* the greatest bytes that complete a character at the end of a block */
+    const __m128i incomplete = _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)0xEF, (char)0xDF, (char)0xBF);
+    /* multipliers of _mm_maddubs_epi16(): x + (y << 6) */
+    const __m128i shift6 = _mm_set1_epi16(0x4001);
+    /* the 16 bytes before s */
+    __m128i prev = zero;
+    /* the number of bytes of an incomplete character before s */
+    int tail = 0;
+
+    while (end - s > 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)s);
+        __m128i prev1, prev2, cont, cont1, c0, c1, c2, lo, hi;
+        int ends;
+
+        if (_mm_movemask_epi8(in) == 0) {
+            if (tail)
+                break;
+            STRINGLIB(utf8_store_ascii)(p, in);
+            s += 16;
+            p += 16;
+            prev = in;
+            continue;
+        }
+        if (STRINGLIB_MAX_CHAR <= 0x7F)
+            break;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(utf8_simd_check(in, prev),
+                                             zero)) != 0xFFFF)
+            break;
+        /* a character ends before a byte that is not a continuation byte;
+           the block always contains the end of one */
+        cont = _mm_cmplt_epi8(in, cont_limit);
+        if (IS_CONTINUATION_BYTE((unsigned char)s[16]))
+            ends = ~(_mm_movemask_epi8(cont) >> 1) & 0x7FFF;
+        else {
+            /* the check only covers the continuation bytes in the block:
+               a lead byte in the last three bytes needs more than remain */
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(in, incomplete),
+                                                 zero)) != 0xFFFF)
+                break;
+            ends = ~(_mm_movemask_epi8(cont) >> 1) & 0xFFFF;
+        }
+        prev1 = _mm_alignr_epi8(in, prev, 15);
+        prev2 = _mm_alignr_epi8(in, prev, 14);
+        cont1 = _mm_cmplt_epi8(prev1, cont_limit);
+        c0 = _mm_and_si128(in, _mm_set1_epi8(0x7F));
+        c1 = _mm_and_si128(_mm_and_si128(prev1, _mm_set1_epi8(0x3F)), cont);
+        cont1 = _mm_and_si128(cont1, cont);
+#if STRINGLIB_SIZEOF_CHAR < 4
+        /* a lead byte of four bytes */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_max_epu8(in, _mm_set1_epi8(-0x10)), in)))
+            break;
+#else
+        {
+            /* a character of four bytes that ends in this block */
+            __m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_max_epu8(prev3, _mm_set1_epi8(-0x10)), prev3)) &
+                    _mm_movemask_epi8(cont1)) {
+                __m128i cont2 = _mm_and_si128(
+                    _mm_cmplt_epi8(prev2, cont_limit), cont1);
+                __m128i c3, lo32, hi32;
+                /* 1110xxxx or 10xxxxxx */
+                c2 = _mm_and_si128(_mm_and_si128(prev2, _mm_or_si128(
+                    _mm_set1_epi8(0x0F),
+                    _mm_and_si128(cont2, _mm_set1_epi8(0x30)))), cont1);
+                c3 = _mm_and_si128(_mm_and_si128(prev3, _mm_set1_epi8(0x07)),
+                                   cont2);
+                lo = _mm_maddubs_epi16(_mm_unpacklo_epi8(c0, c1), shift6);
+                hi = _mm_maddubs_epi16(_mm_unpackhi_epi8(c0, c1), shift6);
+                lo32 = _mm_maddubs_epi16(_mm_unpacklo_epi8(c2, c3), shift6);
+                hi32 = _mm_maddubs_epi16(_mm_unpackhi_epi8(c2, c3), shift6);
+                /* x + (y << 12) */
+                p += STRINGLIB(utf8_store_pack32)(p, _mm_madd_epi16(
+                    _mm_unpacklo_epi16(lo, lo32), _mm_set1_epi32(0x10000001)),
+                    ends & 0xF);
+                p += STRINGLIB(utf8_store_pack32)(p, _mm_madd_epi16(
+                    _mm_unpackhi_epi16(lo, lo32), _mm_set1_epi32(0x10000001)),
+                    (ends >> 4) & 0xF);
+                p += STRINGLIB(utf8_store_pack32)(p, _mm_madd_epi16(
+                    _mm_unpacklo_epi16(hi, hi32), _mm_set1_epi32(0x10000001)),
+                    (ends >> 8) & 0xF);
+                p += STRINGLIB(utf8_store_pack32)(p, _mm_madd_epi16(
+                    _mm_unpackhi_epi16(hi, hi32), _mm_set1_epi32(0x10000001)),
+                    ends >> 12);
+                goto next;
+            }
+        }
+#endif
+        c2 = _mm_and_si128(_mm_and_si128(prev2, _mm_set1_epi8(0x0F)), cont1);
+        lo = _mm_or_si128(
+            _mm_maddubs_epi16(_mm_unpacklo_epi8(c0, c1), shift6),
+            _mm_slli_epi16(_mm_unpacklo_epi8(zero, c2), 4));
+        hi = _mm_or_si128(
+            _mm_maddubs_epi16(_mm_unpackhi_epi8(c0, c1), shift6),
+            _mm_slli_epi16(_mm_unpackhi_epi8(zero, c2), 4));
+#if STRINGLIB_SIZEOF_CHAR == 1
+        /* the lanes of other bytes only exceed 0xFF in characters which
+           exceed it too */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_srli_epi16(_mm_or_si128(lo, hi), 8), zero)) != 0xFFFF)
+            break;
+#endif
+        p += STRINGLIB(utf8_store_pack16)(p, lo, ends & 0xFF);
+        p += STRINGLIB(utf8_store_pack16)(p, hi, ends >> 8);
+#if STRINGLIB_SIZEOF_CHAR == 4
+      next:
+#endif
+        tail = __builtin_clz(ends) - 16;
+        s += 16;
+        prev = in;
+    }
+    *inptr = s - tail;
+    *outptr = p;
+}
+#endif
+
 Py_LOCAL_INLINE(Py_UCS4)
 STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                        STRINGLIB_CHAR *dest,
@@ -26,8 +225,23 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
     const char *s = *inptr;
     const char *aligned_end = (const char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
     STRINGLIB_CHAR *p = dest + *outpos;
+#ifdef HAVE_UTF8_SSSE3
+    /* where to try the SSSE3 decoder next */
+    const char *simd_start = s;
+#endif
 
     while (s < end) {
+#ifdef HAVE_UTF8_SSSE3
+        if (s >= simd_start && end - s > 16 && utf8_simd_enabled) {
+            const char *start = s;
+            STRINGLIB(utf8_decode_ssse3)(&s, end, &p);
+            if (s == end)
+                break;
+            /* don't retry a block the SSSE3 decoder couldn't handle */
+            if (s == start)
+                simd_start = s + 16;
+        }
+#endif
         ch = (unsigned char)*s;
 
         if (ch < 0x80) {
@@ -0,0 +1,36 @@
+/* Fast copy of short strings optimized for str.join() and bytes.join() */
+
+/* Copy n bytes from source to dest and return dest + n.  The pieces of a
+ * join are often only a few bytes long, so up to 16 bytes are copied with
+ * two loads and two stores, which may overlap, instead of calling memcpy().
+ */
+Py_LOCAL_INLINE(void *)
+short_copy(void *dest, const void *source, Py_ssize_t n)
+{
+    char *dst = (char *)dest;
+    const char *src = (const char *)source;
+
+    if (n > 16) {
+        memcpy(dst, src, n);
+    }
+    else if (n >= 8) {
+        uint64_t head, tail;
+        memcpy(&head, src, 8);
+        memcpy(&tail, src + n - 8, 8);
+        memcpy(dst, &head, 8);
+        memcpy(dst + n - 8, &tail, 8);
+    }
+    else if (n >= 4) {
+        uint32_t head, tail;
+        memcpy(&head, src, 4);
+        memcpy(&tail, src + n - 4, 4);
+        memcpy(dst, &head, 4);
+        memcpy(dst + n - 4, &tail, 4);
+    }
+    else if (n > 0) {
+        dst[0] = src[0];
+        dst[n >> 1] = src[n >> 1];
+        dst[n - 1] = src[n - 1];
+    }
+    return dst + n;
+}
@@ -160,6 +160,98 @@ STRINGLIB(rfind_char)(const STRINGLIB_CHAR* s, Py_ssize_t n, STRINGLIB_CHAR ch)
 
 #undef MEMCHR_CUT_OFF
 
+#if STRINGLIB_SIZEOF_CHAR == 1 && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define STRINGLIB_SEARCH_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifdef STRINGLIB_SEARCH_SSE2
+/* For long haystacks the first and the last character of the pattern are
+   compared with 16 positions of the haystack at a time, and only positions
+   where both match are compared in full.  This is much faster than the loop
+   below unless these two characters are very common. */
+
+/* Return a mask of the positions i..i+15 of s where p[0] and p[mlast]
+   match. */
+Py_LOCAL_INLINE(unsigned int)
+STRINGLIB(sse2_candidates)(const STRINGLIB_CHAR* s, Py_ssize_t i,
+                           Py_ssize_t mlast, __m128i first, __m128i last)
+{
+    return (unsigned int)_mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i *)(s + i))),
+        _mm_cmpeq_epi8(last,
+                       _mm_loadu_si128((const __m128i *)(s + i + mlast)))));
+}
+
+/* Search s from the position *pi up to the last block of 16 positions
+   before w.  Return the position of the first match and store it in *pi, or
+   return -1 and store the first position which has not been searched. */
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(sse2_search)(const STRINGLIB_CHAR* s, Py_ssize_t w,
+                       const STRINGLIB_CHAR* p, Py_ssize_t m,
+                       Py_ssize_t *pi)
+{
+    const __m128i first = _mm_set1_epi8((char)p[0]);
+    const __m128i last = _mm_set1_epi8((char)p[m - 1]);
+    Py_ssize_t i = *pi;
+
+    for (; i + 15 <= w; i += 16) {
+        unsigned int bits = STRINGLIB(sse2_candidates)(s, i, m - 1,
+                                                       first, last);
+        while (bits) {
+            unsigned int j;
+#if defined(__GNUC__) || defined(__clang__)
+            j = (unsigned int)__builtin_ctz(bits);
+#else
+            for (j = 0; !(bits & (1U << j)); j++)
+                ;
+#endif
+            if (memcmp(s + i + j + 1, p + 1, m - 2) == 0) {
+                *pi = i + j;
+                return i + j;
+            }
+            bits &= bits - 1;
+        }
+    }
+    *pi = i;
+    return -1;
+}
+
+/* Like sse2_search(), but search backwards from the position *pi, and
+   store the last position which has not been searched. */
+Py_LOCAL_INLINE(Py_ssize_t)
+STRINGLIB(sse2_rsearch)(const STRINGLIB_CHAR* s,
+                        const STRINGLIB_CHAR* p, Py_ssize_t m,
+                        Py_ssize_t *pi)
+{
+    const __m128i first = _mm_set1_epi8((char)p[0]);
+    const __m128i last = _mm_set1_epi8((char)p[m - 1]);
+    Py_ssize_t i = *pi;
+
+    for (; i >= 15; i -= 16) {
+        unsigned int bits = STRINGLIB(sse2_candidates)(s, i - 15, m - 1,
+                                                       first, last);
+        while (bits) {
+            unsigned int j;
+#if defined(__GNUC__) || defined(__clang__)
+            j = 31 - (unsigned int)__builtin_clz(bits);
+#else
+            for (j = 15; !(bits & (1U << j)); j--)
+                ;
+#endif
+            if (memcmp(s + i - 15 + j + 1, p + 1, m - 2) == 0) {
+                *pi = i - 15 + j;
+                return i - 15 + j;
+            }
+            bits &= ~(1U << j);
+        }
+    }
+    *pi = i;
+    return -1;
+}
+#endif
+
 Py_LOCAL_INLINE(Py_ssize_t)
 FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
            const STRINGLIB_CHAR* p, Py_ssize_t m,
@@ -213,7 +305,18 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
         /* process pattern[-1] outside the loop */
         STRINGLIB_BLOOM_ADD(mask, p[mlast]);
 
-        for (i = 0; i <= w; i++) {
+        i = 0;
+#ifdef STRINGLIB_SEARCH_SSE2
+        while (STRINGLIB(sse2_search)(s, w, p, m, &i) >= 0) {
+            if (mode != FAST_COUNT)
+                return i;
+            count++;
+            if (count == maxcount)
+                return maxcount;
+            i = i + m;
+        }
+#endif
+        for (; i <= w; i++) {
             /* note: using mlast in the skip path slows things down on x86 */
             if (ss[i] == pp[0]) {
                 /* candidate match */
@@ -254,7 +357,12 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
                 skip = i - 1;
         }
 
-        for (i = w; i >= 0; i--) {
+        i = w;
+#ifdef STRINGLIB_SEARCH_SSE2
+        if (STRINGLIB(sse2_rsearch)(s, p, m, &i) >= 0)
+            return i;
+#endif
+        for (; i >= 0; i--) {
             if (s[i] == p[0]) {
                 /* candidate match */
                 for (j = mlast; j > 0; j--)
@@ -281,3 +389,4 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     return count;
 }
 
+#undef STRINGLIB_SEARCH_SSE2
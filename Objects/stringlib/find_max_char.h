@@ -23,6 +23,18 @@ STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
     const unsigned char *aligned_end =
             (const unsigned char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
 
+#ifdef HAVE_UNICODE_SSE2
+    /* 64 bytes at a time, the sign bits are the non-ASCII bytes */
+    while (end - p >= 64) {
+        const __m128i *v = (const __m128i *) p;
+        if (_mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_loadu_si128(v), _mm_loadu_si128(v + 1)),
+                _mm_or_si128(_mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3)))))
+            return 255;
+        p += 64;
+    }
+#endif
+
     while (p < end) {
         if (_Py_IS_ALIGNED(p, SIZEOF_LONG)) {
             /* Help register allocation */
@@ -56,6 +68,60 @@ STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
 #define MAX_CHAR_UCS2  0xffff
 #define MAX_CHAR_UCS4  0x10ffff
 
+#ifdef HAVE_UNICODE_SSE2
+
+/* Or all characters together, 64 bytes at a time, and stop as soon as
+   the bits of the widest kind are set. */
+Py_LOCAL_INLINE(Py_UCS4)
+STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
+{
+#if STRINGLIB_SIZEOF_CHAR == 2
+    const Py_UCS4 mask_limit = MASK_UCS1;
+    const Py_UCS4 max_char_limit = MAX_CHAR_UCS2;
+    const __m128i limit = _mm_set1_epi16((short)MASK_UCS1);
+#elif STRINGLIB_SIZEOF_CHAR == 4
+    const Py_UCS4 mask_limit = MASK_UCS2;
+    const Py_UCS4 max_char_limit = MAX_CHAR_UCS4;
+    const __m128i limit = _mm_set1_epi32((int)MASK_UCS2);
+#else
+#error Invalid STRINGLIB_SIZEOF_CHAR (must be 1, 2 or 4)
+#endif
+    const Py_ssize_t step = 64 / STRINGLIB_SIZEOF_CHAR;
+    const __m128i zero = _mm_setzero_si128();
+    const STRINGLIB_CHAR *p = begin;
+    __m128i vbits = zero;
+    Py_UCS4 bits;
+
+    while (end - p >= step) {
+        const __m128i *v = (const __m128i *) p;
+        vbits = _mm_or_si128(vbits, _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128(v), _mm_loadu_si128(v + 1)),
+            _mm_or_si128(_mm_loadu_si128(v + 2), _mm_loadu_si128(v + 3))));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(vbits, limit),
+                                             zero)) != 0xFFFF)
+            return max_char_limit;
+        p += step;
+    }
+    vbits = _mm_or_si128(vbits, _mm_srli_si128(vbits, 8));
+    vbits = _mm_or_si128(vbits, _mm_srli_si128(vbits, 4));
+    bits = (Py_UCS4) _mm_cvtsi128_si32(vbits);
+#if STRINGLIB_SIZEOF_CHAR == 2
+    bits = (bits | (bits >> 16)) & 0xFFFF;
+#endif
+    while (p < end)
+        bits |= *p++;
+
+    if (bits & mask_limit)
+        return max_char_limit;
+    if (bits & MASK_UCS1)
+        return MAX_CHAR_UCS2;
+    if (bits & MASK_ASCII)
+        return MAX_CHAR_UCS1;
+    return MAX_CHAR_ASCII;
+}
+
+#else /* HAVE_UNICODE_SSE2 */
+
 Py_LOCAL_INLINE(Py_UCS4)
 STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
 {
@@ -122,6 +188,8 @@ STRINGLIB(find_max_char)(const STRINGLIB_CHAR *begin, const STRINGLIB_CHAR *end)
     return max_char;
 }
 
+#endif /* HAVE_UNICODE_SSE2 */
+
 #undef MASK_ASCII
 #undef MASK_UCS1
 #undef MASK_UCS2
@@ -14,7 +14,7 @@ STRINGLIB(bytes_join)(PyObject *sep, PyObject *iterable)
     Py_ssize_t seqlen = 0;
     Py_ssize_t sz = 0;
     Py_ssize_t i, nbufs;
-    PyObject *seq, *item;
+    PyObject *seq, *item, **items;
     Py_buffer *buffers = NULL;
 #define NB_STATIC_BUFFERS 10
     Py_buffer static_buffers[NB_STATIC_BUFFERS];
@@ -39,6 +39,43 @@ STRINGLIB(bytes_join)(PyObject *sep, PyObject *iterable)
         }
     }
 #endif
+
+    /* Fast path for a sequence of bytes objects: size the result and copy
+     * the items directly, without getting a buffer of each item.  This
+     * doesn't call back into Python code, so the sequence can't change.
+     */
+    items = PySequence_Fast_ITEMS(seq);
+    for (i = 0; i < seqlen; i++) {
+        Py_ssize_t itemlen;
+        if (!PyBytes_CheckExact(items[i]))
+            break;
+        itemlen = PyBytes_GET_SIZE(items[i]);
+        if (itemlen > PY_SSIZE_T_MAX - sz ||
+                (i != 0 && seplen > PY_SSIZE_T_MAX - sz - itemlen)) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "join() result is too long");
+            Py_DECREF(seq);
+            return NULL;
+        }
+        sz += itemlen + (i != 0 ? seplen : 0);
+    }
+    if (i == seqlen) {
+        res = STRINGLIB_NEW(NULL, sz);
+        if (res != NULL) {
+            p = STRINGLIB_STR(res);
+            for (i = 0; i < seqlen; i++) {
+                if (i && seplen)
+                    p = short_copy(p, sepstr, seplen);
+                p = short_copy(p, PyBytes_AS_STRING(items[i]),
+                               PyBytes_GET_SIZE(items[i]));
+            }
+            assert(p == STRINGLIB_STR(res) + sz);
+        }
+        Py_DECREF(seq);
+        return res;
+    }
+    sz = 0;
+
     if (seqlen > NB_STATIC_BUFFERS) {
         buffers = PyMem_NEW(Py_buffer, seqlen);
         if (buffers == NULL) {
@@ -104,25 +141,14 @@ STRINGLIB(bytes_join)(PyObject *sep, PyObject *iterable)
     p = STRINGLIB_STR(res);
     if (!seplen) {
         /* fast path */
-        for (i = 0; i < nbufs; i++) {
-            Py_ssize_t n = buffers[i].len;
-            char *q = buffers[i].buf;
-            memcpy(p, q, n);
-            p += n;
-        }
+        for (i = 0; i < nbufs; i++)
+            p = short_copy(p, buffers[i].buf, buffers[i].len);
         goto done;
     }
     for (i = 0; i < nbufs; i++) {
-        Py_ssize_t n;
-        char *q;
-        if (i) {
-            memcpy(p, sepstr, seplen);
-            p += seplen;
-        }
-        n = buffers[i].len;
-        q = buffers[i].buf;
-        memcpy(p, q, n);
-        p += n;
+        if (i)
+            p = short_copy(p, sepstr, seplen);
+        p = short_copy(p, buffers[i].buf, buffers[i].len);
     }
     goto done;
 
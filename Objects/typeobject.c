@@ -1099,9 +1099,16 @@ subtype_traverse(PyObject *self, visitproc visit, void *arg)
     }
 
     if (type->tp_dictoffset != base->tp_dictoffset) {
-        PyObject **dictptr = _PyObject_GetDictPtr(self);
-        if (dictptr && *dictptr)
-            Py_VISIT(*dictptr);
+        PyObject **dictptr = _PyObject_GetDictSlot(self);
+        if (dictptr && *dictptr) {
+            if (_PyDict_IS_INLINE_VALUES(*dictptr)) {
+                int err = _PyInlineValues_Traverse(*dictptr, visit, arg);
+                if (err)
+                    return err;
+            }
+            else
+                Py_VISIT(*dictptr);
+        }
     }
 
     if (type->tp_flags & Py_TPFLAGS_HEAPTYPE)
@@ -1155,9 +1162,15 @@ subtype_clear(PyObject *self)
     /* Clear the instance dict (if any), to break cycles involving only
        __dict__ slots (as in the case 'self.__dict__ is self'). */
     if (type->tp_dictoffset != base->tp_dictoffset) {
-        PyObject **dictptr = _PyObject_GetDictPtr(self);
-        if (dictptr && *dictptr)
-            Py_CLEAR(*dictptr);
+        PyObject **dictptr = _PyObject_GetDictSlot(self);
+        if (dictptr && *dictptr) {
+            PyObject *dict = *dictptr;
+            *dictptr = NULL;
+            if (_PyDict_IS_INLINE_VALUES(dict))
+                _PyInlineValues_Free(dict);
+            else
+                Py_DECREF(dict);
+        }
     }
 
     if (baseclear)
@@ -1288,11 +1301,14 @@ subtype_dealloc(PyObject *self)
 
     /* If we added a dict, DECREF it */
     if (type->tp_dictoffset && !base->tp_dictoffset) {
-        PyObject **dictptr = _PyObject_GetDictPtr(self);
+        PyObject **dictptr = _PyObject_GetDictSlot(self);
         if (dictptr != NULL) {
             PyObject *dict = *dictptr;
             if (dict != NULL) {
-                Py_DECREF(dict);
+                if (_PyDict_IS_INLINE_VALUES(dict))
+                    _PyInlineValues_Free(dict);
+                else
+                    Py_DECREF(dict);
                 *dictptr = NULL;
             }
         }
@@ -2162,7 +2178,7 @@ subtype_dict(PyObject *obj, void *context)
 static int
 subtype_setdict(PyObject *obj, PyObject *value, void *context)
 {
-    PyObject **dictptr;
+    PyObject **dictptr, *olddict;
     PyTypeObject *base;
 
     base = get_builtin_base_with_dict(Py_TYPE(obj));
@@ -2181,7 +2197,7 @@ subtype_setdict(PyObject *obj, PyObject *value, void *context)
         return func(descr, obj, value);
     }
     /* Almost like PyObject_GenericSetDict, but allow __dict__ to be deleted. */
-    dictptr = _PyObject_GetDictPtr(obj);
+    dictptr = _PyObject_GetDictSlot(obj);
     if (dictptr == NULL) {
         PyErr_SetString(PyExc_AttributeError,
                         "This object has no __dict__");
@@ -2194,7 +2210,12 @@ subtype_setdict(PyObject *obj, PyObject *value, void *context)
         return -1;
     }
     Py_XINCREF(value);
-    Py_XSETREF(*dictptr, value);
+    olddict = *dictptr;
+    *dictptr = value;
+    if (olddict != NULL && _PyDict_IS_INLINE_VALUES(olddict))
+        _PyInlineValues_Free(olddict);
+    else
+        Py_XDECREF(olddict);
     return 0;
 }
 
@@ -2771,10 +2792,17 @@ type_new(PyTypeObject *metatype, PyObject *args, PyObject *kwds)
     if (add_dict) {
         if (base->tp_itemsize)
             type->tp_dictoffset = -(long)sizeof(PyObject *);
-        else
+        else {
             type->tp_dictoffset = slotoffset;
+            /* Only the generic code accesses the slot */
+            type->tp_flags |= Py_TPFLAGS_INLINE_VALUES;
+        }
         slotoffset += sizeof(PyObject *);
     }
+    else if (base->tp_flags & Py_TPFLAGS_INLINE_VALUES) {
+        /* The slot gets inherited */
+        type->tp_flags |= Py_TPFLAGS_INLINE_VALUES;
+    }
     if (add_weak) {
         assert(!base->tp_itemsize);
         type->tp_weaklistoffset = slotoffset;
@@ -4120,6 +4148,12 @@ object_set_class(PyObject *self, PyObject *value, void *closure)
     }
 
     if (compatible_for_assignment(oldto, newto, "__class__")) {
+        /* Only types with the flag know about inline values */
+        if ((oldto->tp_flags & Py_TPFLAGS_INLINE_VALUES) &&
+            !(newto->tp_flags & Py_TPFLAGS_INLINE_VALUES) &&
+            _PyObject_GetDictPtr(self) == NULL && PyErr_Occurred()) {
+            return -1;
+        }
         if (newto->tp_flags & Py_TPFLAGS_HEAPTYPE)
             Py_INCREF(newto);
         Py_TYPE(self) = newto;
@@ -4247,19 +4281,35 @@ _PyObject_GetState(PyObject *obj, int required)
 
         {
             PyObject **dict;
-            dict = _PyObject_GetDictPtr(obj);
+            dict = _PyObject_GetDictSlot(obj);
             /* It is possible that the object's dict is not initialized
                yet. In this case, we will return None for the state.
                We also return None if the dict is empty to make the behavior
                consistent regardless whether the dict was initialized or not.
-               This make unit testing easier. */
-            if (dict != NULL && *dict != NULL && PyDict_GET_SIZE(*dict)) {
-                state = *dict;
+               This make unit testing easier.
+               Inline values are copied into a new dict, to keep them. */
+            if (dict != NULL && *dict != NULL &&
+                _PyDict_IS_INLINE_VALUES(*dict)) {
+                if (_PyInlineValues_Size(*dict)) {
+                    state = _PyInlineValues_AsDict(*dict);
+                    if (state == NULL) {
+                        return NULL;
+                    }
+                }
+                else {
+                    state = Py_None;
+                    Py_INCREF(state);
+                }
             }
             else {
-                state = Py_None;
+                if (dict != NULL && *dict != NULL && PyDict_GET_SIZE(*dict)) {
+                    state = *dict;
+                }
+                else {
+                    state = Py_None;
+                }
+                Py_INCREF(state);
             }
-            Py_INCREF(state);
         }
 
         slotnames = _PyType_GetSlotNames(Py_TYPE(obj));
@@ -48,11 +48,27 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "ucnhash.h"
 #include "bytes_methods.h"
 #include "stringlib/eq.h"
+#include "stringlib/copy.h"
 
 #ifdef MS_WINDOWS
 #include <windows.h>
 #endif
 
+/* SSE2 is part of the x86-64 baseline and can be used unconditionally.  The
+   SSSE3 UTF-8 decoder is compiled with a function attribute and is only used
+   if the CPU supports SSSE3, which is checked at run time. */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HAVE_UNICODE_SSE2
+#  include <emmintrin.h>
+#endif
+#if defined(HAVE_UNICODE_SSE2) && \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#  define HAVE_UTF8_SSSE3
+#  include <tmmintrin.h>
+#endif
+
 /* Uncomment to display statistics on interned strings at exit when
    using Valgrind or Insecure++. */
 /* #define INTERNED_STATS 1 */
@@ -187,6 +203,92 @@ extern "C" {
             *_to++ = (to_type) *_iter++;                \
     } while (0)
 
+/* Copy the characters from begin to end to a narrower kind, as long as
+   they are not greater than max_char, which is 0x7F or 0xFF for Py_UCS1.
+   Return the number of characters copied. */
+static Py_ssize_t
+narrow_ucs2_to_ucs1(const Py_UCS2 *begin, const Py_UCS2 *end, Py_UCS1 *to,
+                    Py_UCS4 max_char)
+{
+    const Py_UCS2 *p = begin;
+#ifdef HAVE_UNICODE_SSE2
+    const __m128i mask = _mm_set1_epi16((short)~max_char);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (end - p >= 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 8));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_and_si128(_mm_or_si128(a, b), mask), zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128((__m128i *)to, _mm_packus_epi16(a, b));
+        p += 16;
+        to += 16;
+    }
+#endif
+    for (; p < end && *p <= max_char; p++)
+        *to++ = (Py_UCS1)*p;
+    return p - begin;
+}
+
+static Py_ssize_t
+narrow_ucs4_to_ucs1(const Py_UCS4 *begin, const Py_UCS4 *end, Py_UCS1 *to,
+                    Py_UCS4 max_char)
+{
+    const Py_UCS4 *p = begin;
+#ifdef HAVE_UNICODE_SSE2
+    const __m128i mask = _mm_set1_epi32((int)~max_char);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (end - p >= 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 4));
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 8));
+        __m128i d = _mm_loadu_si128((const __m128i *)(p + 12));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b),
+                                           _mm_or_si128(c, d)), mask),
+                zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128((__m128i *)to,
+                         _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                          _mm_packs_epi32(c, d)));
+        p += 16;
+        to += 16;
+    }
+#endif
+    for (; p < end && *p <= max_char; p++)
+        *to++ = (Py_UCS1)*p;
+    return p - begin;
+}
+
+static Py_ssize_t
+narrow_ucs4_to_ucs2(const Py_UCS4 *begin, const Py_UCS4 *end, Py_UCS2 *to)
+{
+    const Py_UCS4 *p = begin;
+#ifdef HAVE_UNICODE_SSE2
+    const __m128i mask = _mm_set1_epi32(~0xFFFF);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (end - p >= 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)p);
+        __m128i b = _mm_loadu_si128((const __m128i *)(p + 4));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_and_si128(_mm_or_si128(a, b), mask), zero)) != 0xFFFF)
+            break;
+        /* sign extend, so that the signed saturation keeps the values */
+        a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+        b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+        _mm_storeu_si128((__m128i *)to, _mm_packs_epi32(a, b));
+        p += 8;
+        to += 8;
+    }
+#endif
+    for (; p < end && *p <= 0xFFFF; p++)
+        *to++ = (Py_UCS2)*p;
+    return p - begin;
+}
+
 #ifdef MS_WINDOWS
    /* On Windows, overallocate by 50% is the best factor */
 #  define OVERALLOCATE_FACTOR 2
@@ -1508,8 +1610,9 @@ _copy_characters(PyObject *to, Py_ssize_t to_start,
             /* Writing Latin-1 characters into an ASCII string requires to
                check that all written characters are pure ASCII */
             Py_UCS4 max_char;
-            max_char = ucs1lib_find_max_char(from_data,
-                                             (Py_UCS1*)from_data + how_many);
+            max_char = ucs1lib_find_max_char(
+                (Py_UCS1*)from_data + from_start,
+                (Py_UCS1*)from_data + from_start + how_many);
             if (max_char >= 128)
                 return -1;
         }
@@ -1548,54 +1651,44 @@ _copy_characters(PyObject *to, Py_ssize_t to_start,
             );
     }
     else {
-        assert (PyUnicode_MAX_CHAR_VALUE(from) > PyUnicode_MAX_CHAR_VALUE(to));
+        const Py_UCS4 to_maxchar = PyUnicode_MAX_CHAR_VALUE(to);
+        Py_ssize_t copied;
 
-        if (!check_maxchar) {
-            if (from_kind == PyUnicode_2BYTE_KIND
-                && to_kind == PyUnicode_1BYTE_KIND)
-            {
-                _PyUnicode_CONVERT_BYTES(
-                    Py_UCS2, Py_UCS1,
-                    PyUnicode_2BYTE_DATA(from) + from_start,
-                    PyUnicode_2BYTE_DATA(from) + from_start + how_many,
-                    PyUnicode_1BYTE_DATA(to) + to_start
-                    );
-            }
-            else if (from_kind == PyUnicode_4BYTE_KIND
-                     && to_kind == PyUnicode_1BYTE_KIND)
-            {
-                _PyUnicode_CONVERT_BYTES(
-                    Py_UCS4, Py_UCS1,
-                    PyUnicode_4BYTE_DATA(from) + from_start,
-                    PyUnicode_4BYTE_DATA(from) + from_start + how_many,
-                    PyUnicode_1BYTE_DATA(to) + to_start
-                    );
-            }
-            else if (from_kind == PyUnicode_4BYTE_KIND
-                     && to_kind == PyUnicode_2BYTE_KIND)
-            {
-                _PyUnicode_CONVERT_BYTES(
-                    Py_UCS4, Py_UCS2,
-                    PyUnicode_4BYTE_DATA(from) + from_start,
-                    PyUnicode_4BYTE_DATA(from) + from_start + how_many,
-                    PyUnicode_2BYTE_DATA(to) + to_start
-                    );
-            }
-            else {
-                Py_UNREACHABLE();
-            }
+        assert (PyUnicode_MAX_CHAR_VALUE(from) > to_maxchar);
+
+        /* the characters are checked while they are copied */
+        if (from_kind == PyUnicode_2BYTE_KIND
+            && to_kind == PyUnicode_1BYTE_KIND)
+        {
+            copied = narrow_ucs2_to_ucs1(
+                PyUnicode_2BYTE_DATA(from) + from_start,
+                PyUnicode_2BYTE_DATA(from) + from_start + how_many,
+                PyUnicode_1BYTE_DATA(to) + to_start,
+                to_maxchar);
+        }
+        else if (from_kind == PyUnicode_4BYTE_KIND
+                 && to_kind == PyUnicode_1BYTE_KIND)
+        {
+            copied = narrow_ucs4_to_ucs1(
+                PyUnicode_4BYTE_DATA(from) + from_start,
+                PyUnicode_4BYTE_DATA(from) + from_start + how_many,
+                PyUnicode_1BYTE_DATA(to) + to_start,
+                to_maxchar);
+        }
+        else if (from_kind == PyUnicode_4BYTE_KIND
+                 && to_kind == PyUnicode_2BYTE_KIND)
+        {
+            copied = narrow_ucs4_to_ucs2(
+                PyUnicode_4BYTE_DATA(from) + from_start,
+                PyUnicode_4BYTE_DATA(from) + from_start + how_many,
+                PyUnicode_2BYTE_DATA(to) + to_start);
         }
         else {
-            const Py_UCS4 to_maxchar = PyUnicode_MAX_CHAR_VALUE(to);
-            Py_UCS4 ch;
-            Py_ssize_t i;
-
-            for (i=0; i < how_many; i++) {
-                ch = PyUnicode_READ(from_kind, from_data, from_start + i);
-                if (ch > to_maxchar)
-                    return -1;
-                PyUnicode_WRITE(to_kind, to_data, to_start + i, ch);
-            }
+            Py_UNREACHABLE();
+        }
+        if (copied < how_many) {
+            assert(check_maxchar);
+            return -1;
         }
     }
     return 0;
@@ -2276,10 +2369,8 @@ _PyUnicode_FromUCS2(const Py_UCS2 *u, Py_ssize_t size)
         return NULL;
     if (max_char >= 256)
         memcpy(PyUnicode_2BYTE_DATA(res), u, sizeof(Py_UCS2)*size);
-    else {
-        _PyUnicode_CONVERT_BYTES(
-            Py_UCS2, Py_UCS1, u, u + size, PyUnicode_1BYTE_DATA(res));
-    }
+    else
+        narrow_ucs2_to_ucs1(u, u + size, PyUnicode_1BYTE_DATA(res), max_char);
     assert(_PyUnicode_CheckConsistency(res, 1));
     return res;
 }
@@ -2301,11 +2392,9 @@ _PyUnicode_FromUCS4(const Py_UCS4 *u, Py_ssize_t size)
     if (!res)
         return NULL;
     if (max_char < 256)
-        _PyUnicode_CONVERT_BYTES(Py_UCS4, Py_UCS1, u, u + size,
-                                 PyUnicode_1BYTE_DATA(res));
+        narrow_ucs4_to_ucs1(u, u + size, PyUnicode_1BYTE_DATA(res), max_char);
     else if (max_char < 0x10000)
-        _PyUnicode_CONVERT_BYTES(Py_UCS4, Py_UCS2, u, u + size,
-                                 PyUnicode_2BYTE_DATA(res));
+        narrow_ucs4_to_ucs2(u, u + size, PyUnicode_2BYTE_DATA(res));
     else
         memcpy(PyUnicode_4BYTE_DATA(res), u, sizeof(Py_UCS4)*size);
     assert(_PyUnicode_CheckConsistency(res, 1));
@@ -4782,6 +4871,150 @@ PyUnicode_DecodeUTF8(const char *s,
     return PyUnicode_DecodeUTF8Stateful(s, size, errors, NULL);
 }
 
+#ifdef HAVE_UTF8_SSSE3
+/* Tables of the SSSE3 UTF-8 decoder STRINGLIB(utf8_decode_ssse3).
+
+   The decoder computes the code point of every character at the position
+   of its last byte and moves these lanes to the front of a vector, dropping
+   the others.  The entry of utf8_simd_pack16 for a mask of 8 bits is the
+   shuffle pattern that gathers the selected 16-bit lanes of a vector,
+   utf8_simd_pack32 is the same for 4 bits and 32-bit lanes.  The entry of
+   utf8_simd_count is the number of bits of a mask.
+
+   The tables are computed by _PyUnicode_Init(), if the CPU supports
+   SSSE3, before utf8_simd_enabled is set. */
+static int utf8_simd_enabled = 0;
+static unsigned char utf8_simd_pack16[256][16];
+static unsigned char utf8_simd_pack32[16][16];
+static unsigned char utf8_simd_count[256];
+
+static void
+init_utf8_simd(void)
+{
+    int mask, i, j, n;
+
+    if (utf8_simd_enabled || !__builtin_cpu_supports("ssse3"))
+        return;
+    for (mask = 0; mask < 256; mask++) {
+        memset(utf8_simd_pack16[mask], 0x80, 16);
+        for (i = 0, n = 0; i < 8; i++) {
+            if (mask & (1 << i)) {
+                for (j = 0; j < 2; j++)
+                    utf8_simd_pack16[mask][2 * n + j] = (unsigned char)(2 * i + j);
+                n++;
+            }
+        }
+        utf8_simd_count[mask] = (unsigned char)n;
+    }
+    for (mask = 0; mask < 16; mask++) {
+        memset(utf8_simd_pack32[mask], 0x80, 16);
+        for (i = 0, n = 0; i < 4; i++) {
+            if (mask & (1 << i)) {
+                for (j = 0; j < 4; j++)
+                    utf8_simd_pack32[mask][4 * n + j] = (unsigned char)(4 * i + j);
+                n++;
+            }
+        }
+    }
+    utf8_simd_enabled = 1;
+}
+
+/* Check the UTF-8 data in the 16 bytes "in", preceded by the 16 bytes
+   "prev", and return non-zero bytes at errors.  This is the algorithm of
+   Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+   Byte" (2021): three table lookups by the nibbles of a byte and of its
+   predecessor classify the errors of byte pairs, the remaining errors are
+   continuation bytes that don't belong to a three or four byte sequence.
+   A sequence truncated at the end of "in" isn't an error. */
+
+#define TOO_SHORT   0x01  /* 11______ 0_______, 11______ 11______ */
+#define TOO_LONG    0x02  /* 0_______ 10______ */
+#define OVERLONG_3  0x04  /* 11100000 100_____ */
+#define TOO_LARGE   0x08  /* 11110100 1001____, 11110100 101_____, ... */
+#define SURROGATE   0x10  /* 11101101 101_____ */
+#define OVERLONG_2  0x20  /* 1100000_ 10______ */
+#define TOO_LARGE_1000 0x40  /* 11110101 1000____, ... */
+#define OVERLONG_4  0x40  /* 11110000 1000____ */
+#define TWO_CONTS   0x80  /* 10______ 10______ */
+#define CARRY (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+__attribute__((target("ssse3")))
+Py_LOCAL_INLINE(__m128i)
+utf8_simd_check(__m128i in, __m128i prev)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+    __m128i prev2 = _mm_alignr_epi8(in, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+    __m128i byte_1_high, byte_1_low, byte_2_high, must23;
+
+    byte_1_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        /* 0_______ ________, ASCII */
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        /* 10______ ________, continuation */
+        (char)TWO_CONTS, (char)TWO_CONTS, (char)TWO_CONTS, (char)TWO_CONTS,
+        /* 1100____ ________, 1101____ ________, two byte lead */
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        /* 1110____ ________, three byte lead */
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        /* 1111____ ________, four byte lead */
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    byte_1_low = _mm_shuffle_epi8(_mm_setr_epi8(
+        (char)(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),  /* ____0000 */
+        (char)(CARRY | OVERLONG_2),                            /* ____0001 */
+        (char)CARRY, (char)CARRY,                              /* ____001_ */
+        (char)(CARRY | TOO_LARGE),                             /* ____0100 */
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),            /* ____0101 */
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),            /* ____011_ */
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),            /* ____1___ */
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),  /* ____1101 */
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000),
+        (char)(CARRY | TOO_LARGE | TOO_LARGE_1000)),
+        _mm_and_si128(prev1, nibble));
+    byte_2_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        /* ________ 0_______, ASCII */
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        /* ________ 1000____ */
+        (char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 |
+               TOO_LARGE_1000 | OVERLONG_4),
+        /* ________ 1001____ */
+        (char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+        /* ________ 101_____ */
+        (char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+        (char)(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+        /* ________ 11______, lead byte */
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT),
+        _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+    /* the third and fourth bytes after 111_____ and 1111____ leads, whose
+       TWO_CONTS flags are expected */
+    must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+                          _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80)));
+    return _mm_xor_si128(
+        _mm_and_si128(must23, _mm_set1_epi8((char)0x80)),
+        _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high));
+}
+
+#undef TOO_SHORT
+#undef TOO_LONG
+#undef OVERLONG_3
+#undef TOO_LARGE
+#undef SURROGATE
+#undef OVERLONG_2
+#undef TOO_LARGE_1000
+#undef OVERLONG_4
+#undef TWO_CONTS
+#undef CARRY
+#endif
+
 #include "stringlib/asciilib.h"
 #include "stringlib/codecs.h"
 #include "stringlib/undef.h"
@@ -4812,6 +5045,23 @@ static Py_ssize_t
 ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
 {
     const char *p = start;
+
+#ifdef HAVE_UNICODE_SSE2
+    /* Check and copy 16 bytes at a time, unaligned loads and stores are as
+       fast as aligned ones on current CPUs. */
+    while (end - p >= 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)p);
+        if (_mm_movemask_epi8(value))
+            break;
+        _mm_storeu_si128((__m128i *)(dest + (p - start)), value);
+        p += 16;
+    }
+    while (p < end && !((unsigned char)*p & 0x80)) {
+        dest[p - start] = *p;
+        p++;
+    }
+    return p - start;
+#else
     const char *aligned_end = (const char *) _Py_ALIGN_DOWN(end, SIZEOF_LONG);
 
     /*
@@ -4870,6 +5120,7 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
     }
     memcpy(dest, start, p - start);
     return p - start;
+#endif
 }
 
 static PyObject *
@@ -9892,10 +10143,10 @@ case_operation(PyObject *self,
     outkind = PyUnicode_KIND(res);
     switch (outkind) {
     case PyUnicode_1BYTE_KIND:
-        _PyUnicode_CONVERT_BYTES(Py_UCS4, Py_UCS1, tmp, tmpend, outdata);
+        narrow_ucs4_to_ucs1(tmp, tmpend, outdata, 0xFF);
         break;
     case PyUnicode_2BYTE_KIND:
-        _PyUnicode_CONVERT_BYTES(Py_UCS4, Py_UCS2, tmp, tmpend, outdata);
+        narrow_ucs4_to_ucs2(tmp, tmpend, outdata);
         break;
     case PyUnicode_4BYTE_KIND:
         memcpy(outdata, tmp, sizeof(Py_UCS4) * newlength);
@@ -10056,20 +10307,12 @@ _PyUnicode_JoinArray(PyObject *separator, PyObject *const *items, Py_ssize_t seq
             item = items[i];
 
             /* Copy item, and maybe the separator. */
-            if (i && seplen != 0) {
-                memcpy(res_data,
-                          sep_data,
-                          kind * seplen);
-                res_data += kind * seplen;
-            }
+            if (i && seplen != 0)
+                res_data = short_copy(res_data, sep_data, kind * seplen);
 
             itemlen = PyUnicode_GET_LENGTH(item);
-            if (itemlen != 0) {
-                memcpy(res_data,
-                          PyUnicode_DATA(item),
-                          kind * itemlen);
-                res_data += kind * itemlen;
-            }
+            res_data = short_copy(res_data, PyUnicode_DATA(item),
+                                  kind * itemlen);
         }
         assert(res_data == PyUnicode_1BYTE_DATA(res)
                            + kind * PyUnicode_GET_LENGTH(res));
@@ -15225,6 +15468,10 @@ _PyUnicode_Init(void)
         PyUnicode_2BYTE_KIND, linebreak,
         Py_ARRAY_LENGTH(linebreak));
 
+#ifdef HAVE_UTF8_SSSE3
+    init_utf8_simd();
+#endif
+
     if (PyType_Ready(&EncodingMapType) < 0) {
          return _PyStatus_ERR("Can't initialize encoding map type");
     }
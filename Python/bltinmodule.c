@@ -551,15 +551,97 @@ filter_traverse(filterobject *lz, visitproc visit, void *arg)
     return 0;
 }
 
+#ifdef STACKLESS
+/*
+ * Soft switchable variant of filter_next(). It is used, if the predicate
+ * is a Python function. The predicate gets called with the stackless
+ * protocol, therefore a tasklet switch within the predicate does not
+ * require a hard switch.
+ *
+ * *ob1: the filter object
+ * *ob2: the item, that has been passed to the predicate
+ * *step: 0 on the first call, 1 if retval is the value of the predicate
+ */
+static PyObject *
+filter_next_stackless(PyObject *retval, long *step, PyObject **ob1,
+                      PyObject **ob2, PyObject **ob3, long *n, void **any)
+{
+    STACKLESS_GETARG();
+    filterobject *lz = (filterobject *)*ob1;
+    PyObject *it = lz->it;
+    PyObject *item, *good;
+    int ok;
+
+    if (*step == 0) {
+        *step = 1;
+        good = NULL;
+        item = NULL;
+    }
+    else {
+        /* we now own the references to retval and to the item */
+        Py_XINCREF(retval);
+        good = retval;
+        item = *ob2;
+        *ob2 = NULL;
+        assert(item != NULL);
+    }
+
+    for (;;) {
+        if (item != NULL) {
+            if (good == NULL) {
+                Py_DECREF(item);
+                return NULL;
+            }
+            ok = PyObject_IsTrue(good);
+            Py_DECREF(good);
+            if (ok > 0)
+                return item;
+            Py_DECREF(item);
+            if (ok < 0)
+                return NULL;
+        }
+
+        item = Py_TYPE(it)->tp_iternext(it);
+        if (item == NULL)
+            return NULL;
+
+        STACKLESS_PROMOTE_ALL();
+        good = _PyObject_FastCall(lz->func, &item, 1);
+        STACKLESS_ASSERT();
+        if (STACKLESS_UNWINDING(good)) {
+            *ob2 = item;
+            return good;
+        }
+    }
+}
+
+static PyStacklessFunctionDeclarationObject filter_next_declaration = {
+    PyObject_HEAD_INIT(NULL)
+    filter_next_stackless,
+    "_filter_next_stackless"
+};
+#endif
+
 static PyObject *
 filter_next(filterobject *lz)
 {
+    STACKLESS_GETARG();
     PyObject *item;
     PyObject *it = lz->it;
     long ok;
     PyObject *(*iternext)(PyObject *);
     int checktrue = lz->func == Py_None || lz->func == (PyObject *)&PyBool_Type;
 
+#ifdef STACKLESS
+    if (stackless && (PyFunction_Check(lz->func) || PyMethod_Check(lz->func))) {
+        STACKLESS_PROMOTE_ALL();
+        item = PyStackless_CallFunction(&filter_next_declaration, Py_None,
+                                        (PyObject *)lz, NULL, NULL, 0, NULL);
+        STACKLESS_ASSERT();
+        return item;
+    }
+#endif
+
     iternext = *Py_TYPE(it)->tp_iternext;
     for (;;) {
         item = iternext(it);
@@ -605,6 +687,12 @@ PyDoc_STRVAR(filter_doc,
 Return an iterator yielding those items of iterable for which function(item)\n\
 is true. If function is None, return the items that are true.");
 
+#ifdef STACKLESS
+static PyMappingMethods filter_as_mapping = {
+    .slpflags.tp_iternext = -1,
+};
+#endif
+
 PyTypeObject PyFilter_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "filter",                           /* tp_name */
@@ -619,7 +707,7 @@ PyTypeObject PyFilter_Type = {
     0,                                  /* tp_repr */
     0,                                  /* tp_as_number */
     0,                                  /* tp_as_sequence */
-    0,                                  /* tp_as_mapping */
+    SLP_TP_AS_MAPPING(filter_as_mapping),/* tp_as_mapping */
     0,                                  /* tp_hash */
     0,                                  /* tp_call */
     0,                                  /* tp_str */
@@ -627,7 +715,8 @@ PyTypeObject PyFilter_Type = {
     0,                                  /* tp_setattro */
     0,                                  /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
-        Py_TPFLAGS_BASETYPE,            /* tp_flags */
+        Py_TPFLAGS_BASETYPE |
+        Py_TPFLAGS_HAVE_STACKLESS_EXTENSION,    /* tp_flags */
     filter_doc,                         /* tp_doc */
     (traverseproc)filter_traverse,      /* tp_traverse */
     0,                                  /* tp_clear */
@@ -1266,6 +1355,7 @@ map_traverse(mapobject *lz, visitproc visit, void *arg)
 static PyObject *
 map_next(mapobject *lz)
 {
+    STACKLESS_GETARG();
     PyObject *small_stack[_PY_FASTCALL_SMALL_STACK];
     PyObject **stack;
     Py_ssize_t niters, nargs, i;
@@ -1294,7 +1384,9 @@ map_next(mapobject *lz)
         nargs++;
     }
 
+    STACKLESS_PROMOTE_ALL();
     result = _PyObject_FastCall(lz->func, stack, nargs);
+    STACKLESS_ASSERT();
 
 exit:
     for (i=0; i < nargs; i++) {
@@ -1337,6 +1429,12 @@ PyDoc_STRVAR(map_doc,
 Make an iterator that computes the function using arguments from\n\
 each of the iterables.  Stops when the shortest iterable is exhausted.");
 
+#ifdef STACKLESS
+static PyMappingMethods map_as_mapping = {
+    .slpflags.tp_iternext = -1,
+};
+#endif
+
 PyTypeObject PyMap_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "map",                              /* tp_name */
@@ -1351,7 +1449,7 @@ PyTypeObject PyMap_Type = {
     0,                                  /* tp_repr */
     0,                                  /* tp_as_number */
     0,                                  /* tp_as_sequence */
-    0,                                  /* tp_as_mapping */
+    SLP_TP_AS_MAPPING(map_as_mapping),  /* tp_as_mapping */
     0,                                  /* tp_hash */
     0,                                  /* tp_call */
     0,                                  /* tp_str */
@@ -1359,7 +1457,8 @@ PyTypeObject PyMap_Type = {
     0,                                  /* tp_setattro */
     0,                                  /* tp_as_buffer */
     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC |
-        Py_TPFLAGS_BASETYPE,            /* tp_flags */
+        Py_TPFLAGS_BASETYPE |
+        Py_TPFLAGS_HAVE_STACKLESS_EXTENSION,    /* tp_flags */
     map_doc,                            /* tp_doc */
     (traverseproc)map_traverse,         /* tp_traverse */
     0,                                  /* tp_clear */
@@ -2224,11 +2323,120 @@ PyDoc_STRVAR(builtin_sorted__doc__,
 "reverse flag can be set to request the result in descending order.");
 
 #define BUILTIN_SORTED_METHODDEF    \
-    {"sorted", (PyCFunction)(void(*)(void))builtin_sorted, METH_FASTCALL | METH_KEYWORDS, builtin_sorted__doc__},
+    {"sorted", (PyCFunction)(void(*)(void))builtin_sorted, METH_FASTCALL | METH_KEYWORDS | METH_STACKLESS, builtin_sorted__doc__},
+
+#ifdef STACKLESS
+/*
+ * Soft switchable part of sorted(). It is used, if the key function is a
+ * Python function. It calls the key function using the stackless protocol
+ * and sorts the list using the computed keys.
+ *
+ * *ob1: the new list
+ * *ob2: the key function
+ * *ob3: the list of the keys computed so far
+ * *n: the reverse flag
+ * *step: 0 on the first call, 1 if retval is the next key
+ */
+static PyObject *
+sorted_stackless(PyObject *retval, long *step, PyObject **ob1,
+                 PyObject **ob2, PyObject **ob3, long *n, void **any)
+{
+    STACKLESS_GETARG();
+    PyObject *newlist = *ob1, *keyfunc = *ob2, *keys = *ob3;
+    PyObject *item, *key;
+    int err;
+
+    if (*step == 0) {
+        *step = 1;
+    }
+    else {
+        if (retval == NULL)
+            return NULL;
+        if (PyList_Append(keys, retval) < 0)
+            return NULL;
+    }
+
+    while (PyList_GET_SIZE(keys) < PyList_GET_SIZE(newlist)) {
+        item = PyList_GET_ITEM(newlist, PyList_GET_SIZE(keys));
+        Py_INCREF(item);
+        STACKLESS_PROMOTE_ALL();
+        key = _PyObject_FastCall(keyfunc, &item, 1);
+        STACKLESS_ASSERT();
+        Py_DECREF(item);
+        if (key == NULL)
+            return NULL;
+        if (STACKLESS_UNWINDING(key))
+            return key;
+        err = PyList_Append(keys, key);
+        Py_DECREF(key);
+        if (err < 0)
+            return NULL;
+    }
+
+    if (slp_list_sort_with_keys(newlist, keys, *n != 0) < 0)
+        return NULL;
+    Py_INCREF(newlist);
+    return newlist;
+}
+
+static PyStacklessFunctionDeclarationObject sorted_declaration = {
+    PyObject_HEAD_INIT(NULL)
+    sorted_stackless,
+    "_sorted_stackless"
+};
+
+/* Returns a new reference to the sorted list, NULL on error or
+ * Py_NotImplemented, if the arguments do not permit a soft switchable
+ * call of the key function.
+ */
+static PyObject *
+builtin_sorted_stackless(PyObject *newlist, PyObject *const *args,
+                         Py_ssize_t nargs, PyObject *kwnames)
+{
+    STACKLESS_GETARG();
+    PyObject *keyfunc = NULL, *keys, *v;
+    Py_ssize_t i;
+    int reverse = 0;
+
+    if (kwnames == NULL)
+        Py_RETURN_NOTIMPLEMENTED;
+    for (i = 0; i < PyTuple_GET_SIZE(kwnames); i++) {
+        PyObject *name = PyTuple_GET_ITEM(kwnames, i);
+        PyObject *value = args[nargs + i];
+        if (_PyUnicode_EqualToASCIIString(name, "key")) {
+            keyfunc = value;
+        }
+        else if (_PyUnicode_EqualToASCIIString(name, "reverse") &&
+                 PyLong_Check(value)) {
+            reverse = _PyLong_AsInt(value);
+            if (reverse == -1 && PyErr_Occurred())
+                return NULL;
+        }
+        else {
+            /* let list.sort() complain */
+            Py_RETURN_NOTIMPLEMENTED;
+        }
+    }
+    if (keyfunc == NULL ||
+            !(PyFunction_Check(keyfunc) || PyMethod_Check(keyfunc)))
+        Py_RETURN_NOTIMPLEMENTED;
+
+    keys = PyList_New(0);
+    if (keys == NULL)
+        return NULL;
+    STACKLESS_PROMOTE_ALL();
+    v = PyStackless_CallFunction(&sorted_declaration, Py_None,
+                                 newlist, keyfunc, keys, reverse != 0, NULL);
+    STACKLESS_ASSERT();
+    Py_DECREF(keys);
+    return v;
+}
+#endif
 
 static PyObject *
 builtin_sorted(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
+    STACKLESS_GETARG();
     PyObject *newlist, *v, *seq, *callable;
 
     /* Keyword arguments are passed through list.sort() which will check
@@ -2240,6 +2448,20 @@ builtin_sorted(PyObject *self, PyObject *const *args, Py_ssize_t nargs, PyObject
     if (newlist == NULL)
         return NULL;
 
+#ifdef STACKLESS
+    if (stackless) {
+        assert(nargs == 1);
+        STACKLESS_PROMOTE_ALL();
+        v = builtin_sorted_stackless(newlist, args + 1, nargs - 1, kwnames);
+        STACKLESS_ASSERT();
+        if (v != Py_NotImplemented) {
+            Py_DECREF(newlist);
+            return v;
+        }
+        Py_DECREF(v);
+    }
+#endif
+
     callable = _PyObject_GetAttrId(newlist, &PyId_sort);
     if (callable == NULL) {
         Py_DECREF(newlist);
@@ -2785,6 +3007,18 @@ static struct PyModuleDef builtinsmodule = {
     NULL
 };
 
+#ifdef STACKLESS
+/* The soft switchable functions of this module are attributes of the module
+ * _stackless, because pickle looks them up by module and name. */
+int
+slp_init_bltin_declarations(PyObject *module, PyModuleDef *module_def)
+{
+    if (PyStackless_InitFunctionDeclaration(&filter_next_declaration, module, module_def) < 0 ||
+        PyStackless_InitFunctionDeclaration(&sorted_declaration, module, module_def) < 0)
+        return -1;
+    return 0;
+}
+#endif
 
 PyObject *
 _PyBuiltin_Init(void)
@@ -26,6 +26,7 @@
 #include "setobject.h"
 #include "structmember.h"
 #include "pycore_stackless.h"
+#include "../Modules/hashtable.h"
 
 #include <ctype.h>
 
@@ -121,6 +122,18 @@ static size_t opcache_code_objects_extra_mem = 0;
 static size_t opcache_global_opts = 0;
 static size_t opcache_global_hits = 0;
 static size_t opcache_global_misses = 0;
+
+static size_t opcache_attr_opts = 0;
+static size_t opcache_attr_hits = 0;
+static size_t opcache_attr_misses = 0;
+static size_t opcache_attr_deopts = 0;
+static size_t opcache_attr_total = 0;
+
+static size_t opcache_method_opts = 0;
+static size_t opcache_method_hits = 0;
+static size_t opcache_method_misses = 0;
+static size_t opcache_method_deopts = 0;
+static size_t opcache_method_total = 0;
 #endif
 
 #define GIL_REQUEST _Py_atomic_load_relaxed(&ceval->gil_drop_request)
@@ -128,12 +141,20 @@ static size_t opcache_global_misses = 0;
 /* This can set eval_breaker to 0 even though gil_drop_request became
    1.  We believe this is all right because the eval loop will release
    the GIL eventually anyway. */
+#ifdef STACKLESS
+#define PROFILER_SAMPLE_PENDING(ceval) \
+    _Py_atomic_load_relaxed(&(ceval)->profiler_sample_pending)
+#else
+#define PROFILER_SAMPLE_PENDING(ceval) 0
+#endif
+
 #define COMPUTE_EVAL_BREAKER(ceval) \
     _Py_atomic_store_relaxed( \
         &(ceval)->eval_breaker, \
         GIL_REQUEST | \
         _Py_atomic_load_relaxed(&(ceval)->signals_pending) | \
         _Py_atomic_load_relaxed(&(ceval)->pending.calls_to_do) | \
+        PROFILER_SAMPLE_PENDING(ceval) | \
         (ceval)->pending.async_exc)
 
 #define SET_GIL_DROP_REQUEST(ceval) \
@@ -185,6 +206,14 @@ static size_t opcache_global_misses = 0;
         COMPUTE_EVAL_BREAKER(ceval); \
     } while (0)
 
+#ifdef STACKLESS
+#define UNSIGNAL_PROFILER_SAMPLE(ceval) \
+    do { \
+        _Py_atomic_store_relaxed(&(ceval)->profiler_sample_pending, 0); \
+        COMPUTE_EVAL_BREAKER(ceval); \
+    } while (0)
+#endif
+
 
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
@@ -274,6 +303,48 @@ _PyEval_Fini(void)
             opcache_global_opts);
 
     fprintf(stderr, "\n");
+
+    fprintf(stderr, "-- Opcode cache LOAD_ATTR hits     = %zd (%d%%)\n",
+            opcache_attr_hits,
+            (int) (100.0 * opcache_attr_hits /
+                (opcache_attr_total ? opcache_attr_total : 1)));
+
+    fprintf(stderr, "-- Opcode cache LOAD_ATTR misses   = %zd (%d%%)\n",
+            opcache_attr_misses,
+            (int) (100.0 * opcache_attr_misses /
+                (opcache_attr_total ? opcache_attr_total : 1)));
+
+    fprintf(stderr, "-- Opcode cache LOAD_ATTR opts     = %zd\n",
+            opcache_attr_opts);
+
+    fprintf(stderr, "-- Opcode cache LOAD_ATTR deopts   = %zd\n",
+            opcache_attr_deopts);
+
+    fprintf(stderr, "-- Opcode cache LOAD_ATTR total    = %zd\n",
+            opcache_attr_total);
+
+    fprintf(stderr, "\n");
+
+    fprintf(stderr, "-- Opcode cache LOAD_METHOD hits   = %zd (%d%%)\n",
+            opcache_method_hits,
+            (int) (100.0 * opcache_method_hits /
+                (opcache_method_total ? opcache_method_total : 1)));
+
+    fprintf(stderr, "-- Opcode cache LOAD_METHOD misses = %zd (%d%%)\n",
+            opcache_method_misses,
+            (int) (100.0 * opcache_method_misses /
+                (opcache_method_total ? opcache_method_total : 1)));
+
+    fprintf(stderr, "-- Opcode cache LOAD_METHOD opts   = %zd\n",
+            opcache_method_opts);
+
+    fprintf(stderr, "-- Opcode cache LOAD_METHOD deopts = %zd\n",
+            opcache_method_deopts);
+
+    fprintf(stderr, "-- Opcode cache LOAD_METHOD total  = %zd\n",
+            opcache_method_total);
+
+    fprintf(stderr, "\n");
 #endif
 }
 
@@ -1037,6 +1108,35 @@ _PyEval_EvalFrameDefault(PyFrameObject *f, int throwflag)
 #endif
 #define PREDICTED(op)           PRED_##op:
 
+/* Superinstructions
+    The interpreter fuses some frequent pairs of instructions into
+    superinstructions, see _PyCode_FuseSuperinstructions(). The handler of
+    a superinstruction executes the first instruction of the pair and then
+    jumps directly to the handler of the second instruction, that follows
+    unchanged in the bytecode. Unlike a successful PREDICT() it updates
+    f->f_lasti. Tracing requires the regular dispatch, because the second
+    instruction may start a new line.
+*/
+
+#ifdef LLTRACE
+#define SUPERINSTRUCTION_FAST_PATH_OK() \
+    (!lltrace && !_Py_TracingPossible(ceval) && !PyDTrace_LINE_ENABLED())
+#else
+#define SUPERINSTRUCTION_FAST_PATH_OK() \
+    (!_Py_TracingPossible(ceval) && !PyDTrace_LINE_ENABLED())
+#endif
+
+#define SUPERINSTRUCTION_DISPATCH(op) \
+    { \
+        if (SUPERINSTRUCTION_FAST_PATH_OK()) { \
+            f->f_lasti = INSTR_OFFSET(); \
+            NEXTOPARG(); \
+            assert(opcode == op); \
+            goto PRED_##op; \
+        } \
+        goto fast_next_opcode; \
+    }
+
 
 /* Stack manipulation macros */
 
@@ -1144,6 +1244,47 @@ _PyEval_EvalFrameDefault(PyFrameObject *f, int throwflag)
         } \
     } while (0)
 
+/* Number of misses, before a LOAD_ATTR or LOAD_METHOD cache entry gets
+   disabled for good. */
+#define OPCACHE_MAX_TRIES 20
+
+#define OPCACHE_DEOPT() \
+    do { \
+        co_opcache->optimized = -1; \
+        co->co_opcache_map[next_instr - first_instr] = 0; \
+        co_opcache = NULL; \
+    } while (0)
+
+#define OPCACHE_DEOPT_LOAD_ATTR() \
+    do { \
+        if (co_opcache != NULL) { \
+            OPCACHE_STAT_ATTR_DEOPT(); \
+            OPCACHE_DEOPT(); \
+        } \
+    } while (0)
+
+#define OPCACHE_MAYBE_DEOPT_LOAD_ATTR() \
+    do { \
+        if (co_opcache != NULL && --co_opcache->optimized <= 0) { \
+            OPCACHE_DEOPT_LOAD_ATTR(); \
+        } \
+    } while (0)
+
+#define OPCACHE_DEOPT_LOAD_METHOD() \
+    do { \
+        if (co_opcache != NULL) { \
+            OPCACHE_STAT_METHOD_DEOPT(); \
+            OPCACHE_DEOPT(); \
+        } \
+    } while (0)
+
+#define OPCACHE_MAYBE_DEOPT_LOAD_METHOD() \
+    do { \
+        if (co_opcache != NULL && --co_opcache->optimized <= 0) { \
+            OPCACHE_DEOPT_LOAD_METHOD(); \
+        } \
+    } while (0)
+
 #if OPCACHE_STATS
 
 #define OPCACHE_STAT_GLOBAL_HIT() \
@@ -1161,12 +1302,74 @@ _PyEval_EvalFrameDefault(PyFrameObject *f, int throwflag)
         if (co->co_opcache != NULL) opcache_global_opts++; \
     } while (0)
 
+#define OPCACHE_STAT_ATTR_HIT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_attr_hits++; \
+    } while (0)
+
+#define OPCACHE_STAT_ATTR_MISS() \
+    do { \
+        if (co->co_opcache != NULL) opcache_attr_misses++; \
+    } while (0)
+
+#define OPCACHE_STAT_ATTR_OPT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_attr_opts++; \
+    } while (0)
+
+#define OPCACHE_STAT_ATTR_DEOPT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_attr_deopts++; \
+    } while (0)
+
+#define OPCACHE_STAT_ATTR_TOTAL() \
+    do { \
+        if (co->co_opcache != NULL) opcache_attr_total++; \
+    } while (0)
+
+#define OPCACHE_STAT_METHOD_HIT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_method_hits++; \
+    } while (0)
+
+#define OPCACHE_STAT_METHOD_MISS() \
+    do { \
+        if (co->co_opcache != NULL) opcache_method_misses++; \
+    } while (0)
+
+#define OPCACHE_STAT_METHOD_OPT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_method_opts++; \
+    } while (0)
+
+#define OPCACHE_STAT_METHOD_DEOPT() \
+    do { \
+        if (co->co_opcache != NULL) opcache_method_deopts++; \
+    } while (0)
+
+#define OPCACHE_STAT_METHOD_TOTAL() \
+    do { \
+        if (co->co_opcache != NULL) opcache_method_total++; \
+    } while (0)
+
 #else /* OPCACHE_STATS */
 
 #define OPCACHE_STAT_GLOBAL_HIT()
 #define OPCACHE_STAT_GLOBAL_MISS()
 #define OPCACHE_STAT_GLOBAL_OPT()
 
+#define OPCACHE_STAT_ATTR_HIT()
+#define OPCACHE_STAT_ATTR_MISS()
+#define OPCACHE_STAT_ATTR_OPT()
+#define OPCACHE_STAT_ATTR_DEOPT()
+#define OPCACHE_STAT_ATTR_TOTAL()
+
+#define OPCACHE_STAT_METHOD_HIT()
+#define OPCACHE_STAT_METHOD_MISS()
+#define OPCACHE_STAT_METHOD_OPT()
+#define OPCACHE_STAT_METHOD_DEOPT()
+#define OPCACHE_STAT_METHOD_TOTAL()
+
 #endif
 
 /* Stackless specific macros and code start here. */
@@ -1263,7 +1466,9 @@ slp_setup_completed:
     assert(PyBytes_GET_SIZE(co->co_code) <= INT_MAX);
     assert(PyBytes_GET_SIZE(co->co_code) % sizeof(_Py_CODEUNIT) == 0);
     assert(_Py_IS_ALIGNED(PyBytes_AS_STRING(co->co_code), sizeof(_Py_CODEUNIT)));
-    first_instr = (_Py_CODEUNIT *) PyBytes_AS_STRING(co->co_code);
+    if (co->co_quickened == NULL)
+        _PyCode_Quicken(co);
+    first_instr = co->co_quickened;
     /*
        f->f_lasti refers to the index of the last instruction,
        unless it's -1 in which case next_instr should be first_instr.
@@ -1414,6 +1619,12 @@ main_loop:
                     goto error;
                 }
             }
+#ifdef STACKLESS
+            if (_Py_atomic_load_relaxed(&ceval->profiler_sample_pending)) {
+                UNSIGNAL_PROFILER_SAMPLE(ceval);
+                slp_profiler_take_sample(tstate);
+            }
+#endif
 
             if (_Py_atomic_load_relaxed(&ceval->gil_drop_request)) {
                 /* Give another thread a chance */
@@ -1485,6 +1696,8 @@ main_loop:
 #endif
         dxp[opcode]++;
 #endif
+        if (_Py_TracingPossible(ceval) && ceval->opcode_profile)
+            _PyEval_CountOpcode(tstate, co, opcode);
 
 #ifdef LLTRACE
         /* Instruction tracing */
@@ -1512,6 +1725,7 @@ main_loop:
         }
 
         case TARGET(LOAD_FAST): {
+            PREDICTED(LOAD_FAST);
             PyObject *value = GETLOCAL(oparg);
             if (value == NULL) {
                 format_exc_check_arg(tstate, PyExc_UnboundLocalError,
@@ -1539,6 +1753,38 @@ main_loop:
             FAST_DISPATCH();
         }
 
+        case TARGET(LOAD_FAST_LOAD_FAST): {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                format_exc_check_arg(tstate, PyExc_UnboundLocalError,
+                                     UNBOUNDLOCAL_ERROR_MSG,
+                                     PyTuple_GetItem(co->co_varnames, oparg));
+                goto error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            SUPERINSTRUCTION_DISPATCH(LOAD_FAST);
+        }
+
+        case TARGET(LOAD_FAST_LOAD_ATTR): {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                format_exc_check_arg(tstate, PyExc_UnboundLocalError,
+                                     UNBOUNDLOCAL_ERROR_MSG,
+                                     PyTuple_GetItem(co->co_varnames, oparg));
+                goto error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            SUPERINSTRUCTION_DISPATCH(LOAD_ATTR);
+        }
+
+        case TARGET(STORE_FAST_LOAD_FAST): {
+            PyObject *value = POP();
+            SETLOCAL(oparg, value);
+            SUPERINSTRUCTION_DISPATCH(LOAD_FAST);
+        }
+
         case TARGET(POP_TOP): {
             PyObject *value = POP();
             Py_DECREF(value);
@@ -3162,9 +3408,222 @@ slp_continue_slp_eval_frame_yield_from:
         }
 
         case TARGET(LOAD_ATTR): {
+            PREDICTED(LOAD_ATTR);
             PyObject *name = GETITEM(names, oparg);
             PyObject *owner = TOP();
-            PyObject *res = PyObject_GetAttr(owner, name);
+            PyTypeObject *type = Py_TYPE(owner);
+            PyObject *res;
+            PyObject **dictptr;
+            PyObject *dict;
+            _PyOpcache_LoadAttr *la;
+
+            OPCACHE_STAT_ATTR_TOTAL();
+
+            OPCACHE_CHECK();
+            if (co_opcache != NULL &&
+                PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+            {
+                if (co_opcache->optimized > 0) {
+                    /* Fast path: the type is unchanged since the last
+                       lookup, therefore the attribute is still either
+                       a slot or an item of the instance dict. */
+                    la = &co_opcache->u.la;
+                    if (la->type == type &&
+                        la->tp_version_tag == type->tp_version_tag)
+                    {
+                        if (la->hint < -1) {
+                            /* the inverted offset of a slot */
+                            res = *(PyObject **)((char *)owner + ~la->hint);
+                            if (res != NULL) {
+                                OPCACHE_STAT_ATTR_HIT();
+                                Py_INCREF(res);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                DISPATCH();
+                            }
+                            /* An unset slot: the slow path raises
+                               AttributeError. */
+                            goto load_attr_slow_path;
+                        }
+                        assert(type->tp_dictoffset > 0);
+                        dictptr = (PyObject **)
+                            ((char *)owner + type->tp_dictoffset);
+                        dict = *dictptr;
+                        if (dict != NULL && _PyDict_IS_INLINE_VALUES(dict)) {
+                            /* The hint is the index into the inline values.
+                               The lookup doesn't run any code. */
+                            Py_ssize_t hint = la->hint, newhint;
+                            res = NULL;
+                            newhint = _PyInlineValues_GetItemHint(
+                                dict, name, hint, &res);
+                            if (res != NULL) {
+                                if (newhint == hint) {
+                                    OPCACHE_STAT_ATTR_HIT();
+                                }
+                                else {
+                                    la->hint = newhint;
+                                    OPCACHE_STAT_ATTR_MISS();
+                                    OPCACHE_MAYBE_DEOPT_LOAD_ATTR();
+                                }
+                                Py_INCREF(res);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                DISPATCH();
+                            }
+                        }
+                        else if (dict != NULL && PyDict_CheckExact(dict)) {
+                            Py_ssize_t hint = la->hint, newhint;
+                            Py_INCREF(dict);
+                            res = NULL;
+                            assert(!_PyErr_Occurred(tstate));
+                            newhint = _PyDict_GetItemHint(
+                                (PyDictObject *)dict, name, hint, &res);
+                            if (res != NULL) {
+                                assert(newhint >= 0);
+                                if (newhint == hint) {
+                                    OPCACHE_STAT_ATTR_HIT();
+                                }
+                                else if (la->type == type &&
+                                         la->tp_version_tag == type->tp_version_tag)
+                                {
+                                    /* The hint didn't work, maybe the
+                                       next one does. */
+                                    la->hint = newhint;
+                                    OPCACHE_STAT_ATTR_MISS();
+                                    OPCACHE_MAYBE_DEOPT_LOAD_ATTR();
+                                }
+                                Py_INCREF(res);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                Py_DECREF(dict);
+                                DISPATCH();
+                            }
+                            /* The attribute is missing sometimes,
+                               don't optimize this lookup. */
+                            _PyErr_Clear(tstate);
+                            Py_DECREF(dict);
+                        }
+                        OPCACHE_DEOPT_LOAD_ATTR();
+                    }
+                    else {
+                        /* The type is different or has been modified.
+                           Maybe it stabilizes. */
+                        OPCACHE_MAYBE_DEOPT_LOAD_ATTR();
+                    }
+                    OPCACHE_STAT_ATTR_MISS();
+                }
+
+                /* co_opcache is NULL after a deoptimization */
+                if (co_opcache != NULL && type->tp_dict != NULL &&
+                    (type->tp_getattro == PyObject_GenericGetAttr ||
+                     type == &PyModule_Type))
+                {
+                    /* If the type gets modified during the lookups, the
+                       cache entry never matches. */
+                    unsigned int tp_version_tag = type->tp_version_tag;
+                    PyObject *descr = _PyType_Lookup(type, name);
+                    if (descr != NULL) {
+                        /* Only slots are cached, the module type has none */
+                        if (Py_TYPE(descr) == &PyMemberDescr_Type &&
+                            type->tp_getattro == PyObject_GenericGetAttr &&
+                            PyType_IsSubtype(type, PyDescr_TYPE(descr)))
+                        {
+                            PyMemberDef *dmem =
+                                ((PyMemberDescrObject *)descr)->d_member;
+                            if (dmem->type == T_OBJECT_EX &&
+                                !(dmem->flags & READ_RESTRICTED))
+                            {
+                                Py_ssize_t offset = dmem->offset;
+                                assert(offset > 0);
+                                if (co_opcache->optimized == 0) {
+                                    OPCACHE_STAT_ATTR_OPT();
+                                    co_opcache->optimized = OPCACHE_MAX_TRIES;
+                                }
+                                la = &co_opcache->u.la;
+                                la->type = type;
+                                la->tp_version_tag = tp_version_tag;
+                                la->hint = ~offset;
+                                res = *(PyObject **)((char *)owner + offset);
+                                if (res != NULL) {
+                                    Py_INCREF(res);
+                                    SET_TOP(res);
+                                    Py_DECREF(owner);
+                                    DISPATCH();
+                                }
+                                goto load_attr_slow_path;
+                            }
+                        }
+                        /* some other descriptor or class attribute */
+                        OPCACHE_DEOPT_LOAD_ATTR();
+                    }
+                    else if (type->tp_dictoffset > 0) {
+                        dictptr = (PyObject **)
+                            ((char *)owner + type->tp_dictoffset);
+                        dict = *dictptr;
+                        if (dict != NULL && _PyDict_IS_INLINE_VALUES(dict)) {
+                            Py_ssize_t hint;
+                            res = NULL;
+                            hint = _PyInlineValues_GetItemHint(dict, name,
+                                                               -1, &res);
+                            if (res != NULL) {
+                                assert(hint >= 0);
+                                Py_INCREF(res);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                if (co_opcache->optimized == 0) {
+                                    OPCACHE_STAT_ATTR_OPT();
+                                    co_opcache->optimized = OPCACHE_MAX_TRIES;
+                                }
+                                la = &co_opcache->u.la;
+                                la->type = type;
+                                la->tp_version_tag = tp_version_tag;
+                                la->hint = hint;
+                                DISPATCH();
+                            }
+                        }
+                        else if (dict != NULL && PyDict_CheckExact(dict)) {
+                            Py_ssize_t hint;
+                            Py_INCREF(dict);
+                            res = NULL;
+                            assert(!_PyErr_Occurred(tstate));
+                            hint = _PyDict_GetItemHint((PyDictObject *)dict,
+                                                       name, -1, &res);
+                            if (res != NULL) {
+                                assert(hint >= 0);
+                                Py_INCREF(res);
+                                Py_DECREF(dict);
+                                SET_TOP(res);
+                                Py_DECREF(owner);
+                                if (co_opcache->optimized == 0) {
+                                    OPCACHE_STAT_ATTR_OPT();
+                                    co_opcache->optimized = OPCACHE_MAX_TRIES;
+                                }
+                                la = &co_opcache->u.la;
+                                la->type = type;
+                                la->tp_version_tag = tp_version_tag;
+                                la->hint = hint;
+                                DISPATCH();
+                            }
+                            _PyErr_Clear(tstate);
+                            Py_DECREF(dict);
+                        }
+                        else {
+                            OPCACHE_DEOPT_LOAD_ATTR();
+                        }
+                    }
+                    else {
+                        /* no instance dict we can use */
+                        OPCACHE_DEOPT_LOAD_ATTR();
+                    }
+                }
+                else if (co_opcache != NULL) {
+                    /* a custom tp_getattro */
+                    OPCACHE_DEOPT_LOAD_ATTR();
+                }
+            }
+
+          load_attr_slow_path:
+            res = PyObject_GetAttr(owner, name);
             Py_DECREF(owner);
             SET_TOP(res);
             if (res == NULL)
@@ -3186,6 +3645,18 @@ slp_continue_slp_eval_frame_yield_from:
             DISPATCH();
         }
 
+        case TARGET(COMPARE_AND_BRANCH): {
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *res = cmp_outcome(tstate, oparg, left, right);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            SUPERINSTRUCTION_DISPATCH(POP_JUMP_IF_FALSE);
+        }
+
         case TARGET(IMPORT_NAME): {
             PyObject *name = GETITEM(names, oparg);
             PyObject *fromlist = POP();
@@ -3665,9 +4136,86 @@ slp_continue_slp_eval_frame_with_cleanup:
             /* Designed to work in tandem with CALL_METHOD. */
             PyObject *name = GETITEM(names, oparg);
             PyObject *obj = TOP();
+            PyTypeObject *type = Py_TYPE(obj);
             PyObject *meth = NULL;
+            int meth_found;
 
-            int meth_found = _PyObject_GetMethod(obj, name, &meth);
+            OPCACHE_STAT_METHOD_TOTAL();
+
+            OPCACHE_CHECK();
+            if (co_opcache != NULL && co_opcache->optimized > 0) {
+                _PyOpcache_LoadMethod *lm = &co_opcache->u.lm;
+                if (lm->type == type &&
+                    lm->tp_version_tag == type->tp_version_tag &&
+                    PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG))
+                {
+                    /* The type is unchanged since the last lookup. The
+                       method is valid, unless the instance dict shadows it. */
+                    int shadowed = 0;
+                    PyObject *dict = NULL;
+                    if (type->tp_dictoffset > 0) {
+                        dict = *(PyObject **)((char *)obj + type->tp_dictoffset);
+                    }
+                    if (dict != NULL && _PyDict_IS_INLINE_VALUES(dict)) {
+                        PyObject *attr = NULL;
+                        (void)_PyInlineValues_GetItemHint(dict, name,
+                                                          -1, &attr);
+                        shadowed = attr != NULL;
+                    }
+                    else if (dict != NULL && !PyDict_CheckExact(dict)) {
+                        shadowed = 1;
+                    }
+                    else if (dict != NULL && PyDict_GET_SIZE(dict) > 0) {
+                        PyObject *attr = NULL;
+                        Py_INCREF(dict);
+                        (void)_PyDict_GetItemHint((PyDictObject *)dict,
+                                                  name, -1, &attr);
+                        Py_DECREF(dict);
+                        if (attr != NULL || _PyErr_Occurred(tstate)) {
+                            _PyErr_Clear(tstate);
+                            shadowed = 1;
+                        }
+                        else if (lm->type != type ||
+                                 lm->tp_version_tag != type->tp_version_tag) {
+                            /* the dict lookup modified the type */
+                            shadowed = 1;
+                        }
+                    }
+                    if (!shadowed) {
+                        OPCACHE_STAT_METHOD_HIT();
+                        meth = lm->meth;
+                        Py_INCREF(meth);
+                        SET_TOP(meth);
+                        PUSH(obj);  // self
+                        DISPATCH();
+                    }
+                }
+                OPCACHE_MAYBE_DEOPT_LOAD_METHOD();
+                OPCACHE_STAT_METHOD_MISS();
+            }
+
+            meth_found = _PyObject_GetMethod(obj, name, &meth);
+
+            if (co_opcache != NULL && meth != NULL) {
+                if (meth_found &&
+                    type->tp_getattro == PyObject_GenericGetAttr &&
+                    type->tp_dictoffset >= 0 &&
+                    PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) &&
+                    _PyType_Lookup(type, name) == meth)
+                {
+                    _PyOpcache_LoadMethod *lm = &co_opcache->u.lm;
+                    if (co_opcache->optimized == 0) {
+                        OPCACHE_STAT_METHOD_OPT();
+                        co_opcache->optimized = OPCACHE_MAX_TRIES;
+                    }
+                    lm->type = type;
+                    lm->tp_version_tag = type->tp_version_tag;
+                    lm->meth = meth;  /* borrowed, owned by the type */
+                }
+                else {
+                    OPCACHE_DEOPT_LOAD_METHOD();
+                }
+            }
 
             if (meth == NULL) {
                 /* Most likely attribute wasn't found. */
@@ -6235,3 +6783,364 @@ maybe_dtrace_line(PyFrameObject *frame,
     }
     *instr_prev = frame->f_lasti;
 }
+
+/* The runtime opcode profiler, see sys._opcode_profile().
+ *
+ * Each thread counts into its own struct _opcode_profile, that is
+ * allocated with the first counted instruction. The counts of all threads
+ * get merged, when the profile is read. Threads, that terminate while the
+ * profiler is on, add their counts to ceval->opcode_profile_exited.
+ *
+ * A running profiler holds one count of ceval->tracing_possible. Therefore
+ * the eval loop leaves its fast path only while the profiler is on and a
+ * stopped profiler costs a single, well predicted branch. Without computed
+ * gotos, instructions reached by PREDICT() bypass the counter.
+ */
+
+struct _opcode_profile {
+    uint64_t opcodes[256];
+    /* pairs[a][b] counts opcode b executed right after opcode a,
+       pairs[256][b] counts b executed as the first opcode */
+    uint64_t pairs[257][256];
+    int lastopcode;
+    /* maps PyCodeObject * (a strong reference) to uint64_t[256] */
+    _Py_hashtable_t *codes;
+    /* the entry of the last counted code object */
+    PyCodeObject *last_code;
+    uint64_t *last_counts;
+    /* used by opcode_profile_clear_all() */
+    struct _opcode_profile *next;
+};
+
+#define OPCODE_PROFILE_HEAD_LOCK(runtime) \
+    PyThread_acquire_lock((runtime)->interpreters.mutex, WAIT_LOCK)
+#define OPCODE_PROFILE_HEAD_UNLOCK(runtime) \
+    PyThread_release_lock((runtime)->interpreters.mutex)
+
+static struct _opcode_profile *
+opcode_profile_new(void)
+{
+    struct _opcode_profile *prof;
+
+    prof = PyMem_RawCalloc(1, sizeof(struct _opcode_profile));
+    if (prof == NULL)
+        return NULL;
+    prof->codes = _Py_hashtable_new(sizeof(PyCodeObject *),
+                                    sizeof(uint64_t *),
+                                    _Py_hashtable_hash_ptr,
+                                    _Py_hashtable_compare_direct);
+    if (prof->codes == NULL) {
+        PyMem_RawFree(prof);
+        return NULL;
+    }
+    prof->lastopcode = 256;
+    return prof;
+}
+
+static int
+opcode_profile_free_entry(_Py_hashtable_t *ht, _Py_hashtable_entry_t *entry,
+                          void *arg)
+{
+    PyCodeObject *co;
+    uint64_t *counts;
+
+    _Py_HASHTABLE_ENTRY_READ_KEY(ht, entry, co);
+    _Py_HASHTABLE_ENTRY_READ_DATA(ht, entry, counts);
+    PyMem_RawFree(counts);
+    Py_DECREF(co);
+    return 0;
+}
+
+static void
+opcode_profile_free(struct _opcode_profile *prof)
+{
+    if (prof == NULL)
+        return;
+    _Py_hashtable_foreach(prof->codes, opcode_profile_free_entry, NULL);
+    _Py_hashtable_destroy(prof->codes);
+    PyMem_RawFree(prof);
+}
+
+/* Return the counters of code object co, NULL on a memory error */
+static uint64_t *
+opcode_profile_code_counts(struct _opcode_profile *prof, PyCodeObject *co)
+{
+    uint64_t *counts;
+
+    if (_Py_HASHTABLE_GET(prof->codes, co, counts))
+        return counts;
+    counts = PyMem_RawCalloc(256, sizeof(uint64_t));
+    if (counts == NULL)
+        return NULL;
+    if (_Py_HASHTABLE_SET(prof->codes, co, counts) < 0) {
+        PyMem_RawFree(counts);
+        return NULL;
+    }
+    Py_INCREF(co);
+    return counts;
+}
+
+static int
+opcode_profile_merge_entry(_Py_hashtable_t *ht, _Py_hashtable_entry_t *entry,
+                           void *arg)
+{
+    struct _opcode_profile *dst = (struct _opcode_profile *)arg;
+    PyCodeObject *co;
+    uint64_t *counts, *dst_counts;
+    int i;
+
+    _Py_HASHTABLE_ENTRY_READ_KEY(ht, entry, co);
+    _Py_HASHTABLE_ENTRY_READ_DATA(ht, entry, counts);
+    dst_counts = opcode_profile_code_counts(dst, co);
+    if (dst_counts == NULL)
+        return -1;
+    for (i = 0; i < 256; i++)
+        dst_counts[i] += counts[i];
+    return 0;
+}
+
+/* Add the counts of src to dst. Return -1 on a memory error */
+static int
+opcode_profile_merge(struct _opcode_profile *dst, struct _opcode_profile *src)
+{
+    int i, j;
+
+    if (src == NULL)
+        return 0;
+    for (i = 0; i < 256; i++)
+        dst->opcodes[i] += src->opcodes[i];
+    for (i = 0; i < 257; i++)
+        for (j = 0; j < 256; j++)
+            dst->pairs[i][j] += src->pairs[i][j];
+    return _Py_hashtable_foreach(src->codes, opcode_profile_merge_entry, dst);
+}
+
+void
+_PyEval_CountOpcode(PyThreadState *tstate, PyCodeObject *co, int opcode)
+{
+    struct _opcode_profile *prof = tstate->opcode_profile;
+
+    if (prof == NULL) {
+        /* On a memory error the instruction is not counted. We must not
+           raise an exception from the middle of the eval loop. */
+        prof = tstate->opcode_profile = opcode_profile_new();
+        if (prof == NULL)
+            return;
+    }
+    prof->opcodes[opcode]++;
+    prof->pairs[prof->lastopcode][opcode]++;
+    prof->lastopcode = opcode;
+    if (co != prof->last_code) {
+        prof->last_counts = opcode_profile_code_counts(prof, co);
+        prof->last_code = prof->last_counts != NULL ? co : NULL;
+        if (prof->last_counts == NULL)
+            return;
+    }
+    prof->last_counts[opcode]++;
+}
+
+void
+_PyEval_ClearOpcodeProfile(PyThreadState *tstate)
+{
+    struct _ceval_runtime_state *ceval = &_PyRuntime.ceval;
+    struct _opcode_profile *prof = tstate->opcode_profile;
+
+    if (prof == NULL)
+        return;
+    tstate->opcode_profile = NULL;
+    if (ceval->opcode_profile) {
+        if (ceval->opcode_profile_exited == NULL) {
+            ceval->opcode_profile_exited = prof;
+            prof->last_code = NULL;
+            return;
+        }
+        /* ignore a memory error, the counts of this thread get lost */
+        (void)opcode_profile_merge(ceval->opcode_profile_exited, prof);
+    }
+    opcode_profile_free(prof);
+}
+
+static void
+opcode_profile_clear_all(_PyRuntimeState *runtime)
+{
+    struct _opcode_profile *list = runtime->ceval.opcode_profile_exited;
+    PyInterpreterState *interp;
+    PyThreadState *ts;
+
+    runtime->ceval.opcode_profile_exited = NULL;
+    if (list != NULL)
+        list->next = NULL;
+    /* Freeing a profile releases code objects. Don't do this while
+       holding the head lock. */
+    OPCODE_PROFILE_HEAD_LOCK(runtime);
+    for (interp = runtime->interpreters.head; interp != NULL;
+         interp = interp->next) {
+        for (ts = interp->tstate_head; ts != NULL; ts = ts->next) {
+            if (ts->opcode_profile != NULL) {
+                ts->opcode_profile->next = list;
+                list = ts->opcode_profile;
+                ts->opcode_profile = NULL;
+            }
+        }
+    }
+    OPCODE_PROFILE_HEAD_UNLOCK(runtime);
+    while (list != NULL) {
+        struct _opcode_profile *next = list->next;
+        opcode_profile_free(list);
+        list = next;
+    }
+}
+
+static int
+opcode_profile_code_to_dict(_Py_hashtable_t *ht, _Py_hashtable_entry_t *entry,
+                            void *arg)
+{
+    PyObject *result = (PyObject *)arg;
+    PyCodeObject *co;
+    uint64_t *counts;
+    PyObject *d;
+    int i;
+
+    _Py_HASHTABLE_ENTRY_READ_KEY(ht, entry, co);
+    _Py_HASHTABLE_ENTRY_READ_DATA(ht, entry, counts);
+    d = PyDict_New();
+    if (d == NULL)
+        return -1;
+    for (i = 0; i < 256; i++) {
+        PyObject *k, *v;
+        int err;
+
+        if (counts[i] == 0)
+            continue;
+        k = PyLong_FromLong(i);
+        v = PyLong_FromUnsignedLongLong(counts[i]);
+        err = k == NULL || v == NULL || PyDict_SetItem(d, k, v) < 0;
+        Py_XDECREF(k);
+        Py_XDECREF(v);
+        if (err) {
+            Py_DECREF(d);
+            return -1;
+        }
+    }
+    i = PyDict_SetItem(result, (PyObject *)co, d);
+    Py_DECREF(d);
+    return i;
+}
+
+static PyObject *
+opcode_profile_to_dict(struct _opcode_profile *prof)
+{
+    PyObject *result, *opcodes = NULL, *pairs = NULL, *codes = NULL;
+    int i, j;
+
+    result = PyDict_New();
+    if (result == NULL)
+        return NULL;
+    opcodes = PyList_New(256);
+    if (opcodes == NULL)
+        goto error;
+    for (i = 0; i < 256; i++) {
+        PyObject *x = PyLong_FromUnsignedLongLong(prof->opcodes[i]);
+        if (x == NULL)
+            goto error;
+        PyList_SET_ITEM(opcodes, i, x);
+    }
+    pairs = PyDict_New();
+    if (pairs == NULL)
+        goto error;
+    for (i = 0; i < 256; i++) {
+        for (j = 0; j < 256; j++) {
+            PyObject *k, *v;
+            int err;
+
+            if (prof->pairs[i][j] == 0)
+                continue;
+            k = Py_BuildValue("(ii)", i, j);
+            v = PyLong_FromUnsignedLongLong(prof->pairs[i][j]);
+            err = k == NULL || v == NULL || PyDict_SetItem(pairs, k, v) < 0;
+            Py_XDECREF(k);
+            Py_XDECREF(v);
+            if (err)
+                goto error;
+        }
+    }
+    codes = PyDict_New();
+    if (codes == NULL)
+        goto error;
+    if (_Py_hashtable_foreach(prof->codes, opcode_profile_code_to_dict, codes))
+        goto error;
+    if (PyDict_SetItemString(result, "opcodes", opcodes) < 0 ||
+        PyDict_SetItemString(result, "pairs", pairs) < 0 ||
+        PyDict_SetItemString(result, "code", codes) < 0)
+        goto error;
+    Py_DECREF(opcodes);
+    Py_DECREF(pairs);
+    Py_DECREF(codes);
+    return result;
+error:
+    Py_XDECREF(opcodes);
+    Py_XDECREF(pairs);
+    Py_XDECREF(codes);
+    Py_DECREF(result);
+    return NULL;
+}
+
+/* Merge the counts of all threads and return them as a dictionary */
+static PyObject *
+opcode_profile_read(_PyRuntimeState *runtime)
+{
+    struct _opcode_profile *merged;
+    PyInterpreterState *interp;
+    PyThreadState *ts;
+    PyObject *result = NULL;
+    int err;
+
+    merged = opcode_profile_new();
+    if (merged == NULL)
+        return PyErr_NoMemory();
+    err = opcode_profile_merge(merged, runtime->ceval.opcode_profile_exited);
+    OPCODE_PROFILE_HEAD_LOCK(runtime);
+    for (interp = runtime->interpreters.head; interp != NULL && !err;
+         interp = interp->next) {
+        for (ts = interp->tstate_head; ts != NULL && !err; ts = ts->next)
+            err = opcode_profile_merge(merged, ts->opcode_profile);
+    }
+    OPCODE_PROFILE_HEAD_UNLOCK(runtime);
+    if (err)
+        PyErr_NoMemory();
+    else
+        result = opcode_profile_to_dict(merged);
+    opcode_profile_free(merged);
+    return result;
+}
+
+PyObject *
+_PyEval_OpcodeProfile(PyObject *enable)
+{
+    _PyRuntimeState *runtime = &_PyRuntime;
+    struct _ceval_runtime_state *ceval = &runtime->ceval;
+    PyObject *result;
+    int on;
+
+    if (enable == Py_None)
+        return opcode_profile_read(runtime);
+    on = PyObject_IsTrue(enable);
+    if (on < 0)
+        return NULL;
+    if (on) {
+        /* start a new profile */
+        opcode_profile_clear_all(runtime);
+        if (!ceval->opcode_profile) {
+            ceval->opcode_profile = 1;
+            ceval->tracing_possible++;
+        }
+        Py_RETURN_NONE;
+    }
+    if (!ceval->opcode_profile)
+        Py_RETURN_NONE;
+    ceval->opcode_profile = 0;
+    ceval->tracing_possible--;
+    result = opcode_profile_read(runtime);
+    opcode_profile_clear_all(runtime);
+    return result;
+}
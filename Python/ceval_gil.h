@@ -253,6 +253,7 @@ _ready:
     }
 
     MUTEX_UNLOCK(gil->mutex);
+    _PyObject_SwitchThreadPools(&tstate->obmalloc_pools);
     errno = err;
 }
 
@@ -897,6 +897,49 @@ sys__current_frames(PyObject *module, PyObject *Py_UNUSED(ignored))
     return sys__current_frames_impl(module);
 }
 
+PyDoc_STRVAR(sys__opcode_profile__doc__,
+"_opcode_profile($module, enable=None, /)\n"
+"--\n"
+"\n"
+"Control the opcode execution profiler.\n"
+"\n"
+"If enable is true, discard all counts and start a new profile.  If\n"
+"enable is false, stop the profiler and return the counts.  If enable\n"
+"is None, return the counts and keep the profiler running.\n"
+"\n"
+"The result is a dict with the items \"opcodes\", a list of the execution\n"
+"counts of each opcode, \"pairs\", a dict mapping (opcode, next_opcode)\n"
+"to its count, and \"code\", a dict mapping code objects to dicts of\n"
+"opcode counts.  The counts of all threads are merged.\n"
+"\n"
+"This function should be used for specialized purposes only.");
+
+#define SYS__OPCODE_PROFILE_METHODDEF    \
+    {"_opcode_profile", (PyCFunction)(void(*)(void))sys__opcode_profile, METH_FASTCALL, sys__opcode_profile__doc__},
+
+static PyObject *
+sys__opcode_profile_impl(PyObject *module, PyObject *enable);
+
+static PyObject *
+sys__opcode_profile(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    PyObject *enable = Py_None;
+
+    if (!_PyArg_CheckPositional("_opcode_profile", nargs, 0, 1)) {
+        goto exit;
+    }
+    if (nargs < 1) {
+        goto skip_optional;
+    }
+    enable = args[0];
+skip_optional:
+    return_value = sys__opcode_profile_impl(module, enable);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys_call_tracing__doc__,
 "call_tracing($module, func, args, /)\n"
 "--\n"
@@ -1082,4 +1125,4 @@ sys_getandroidapilevel(PyObject *module, PyObject *Py_UNUSED(ignored))
 #ifndef SYS_GETANDROIDAPILEVEL_METHODDEF
     #define SYS_GETANDROIDAPILEVEL_METHODDEF
 #endif /* !defined(SYS_GETANDROIDAPILEVEL_METHODDEF) */
-/*[clinic end generated code: output=43c4fde7b5783d8d input=a9049054013a1b77]*/
+/*[clinic end generated code: output=973166ae733d9f11 input=a9049054013a1b77]*/
@@ -1068,6 +1068,15 @@ stack_effect(int opcode, int oparg, int jump)
         case DELETE_FAST:
             return 0;
 
+        /* Superinstructions have the stack effect of their first
+           instruction, the second instruction follows separately */
+        case LOAD_FAST_LOAD_FAST:
+        case LOAD_FAST_LOAD_ATTR:
+            return 1;
+        case STORE_FAST_LOAD_FAST:
+        case COMPARE_AND_BRANCH:
+            return -1;
+
         case RAISE_VARARGS:
             return -oparg;
 
@@ -187,6 +187,22 @@ PyContextVar_Get(PyObject *ovar, PyObject *def, PyObject **val)
         goto not_found;
     }
 
+#ifdef STACKLESS
+    /* Stackless exchanges ts->context and increments ts->context_ver on
+     * every tasklet switch. Therefore the cache is keyed by the version of
+     * the immutable HAMT of the context. Versions are never reused and
+     * tasklets with copies of the same context share the HAMT. If the
+     * versions match, the HAMT is alive and so is the borrowed value. */
+    assert(PyContext_CheckExact(ts->context));
+    PyHamtObject *vars = ((PyContext *)ts->context)->ctx_vars;
+
+    if (var->var_cached != NULL &&
+            var->var_cached_hamtver == vars->h_ver)
+    {
+        *val = var->var_cached;
+        goto found;
+    }
+#else
     if (var->var_cached != NULL &&
             var->var_cached_tsid == ts->id &&
             var->var_cached_tsver == ts->context_ver)
@@ -197,6 +213,7 @@ PyContextVar_Get(PyObject *ovar, PyObject *def, PyObject **val)
 
     assert(PyContext_CheckExact(ts->context));
     PyHamtObject *vars = ((PyContext *)ts->context)->ctx_vars;
+#endif
 
     PyObject *found = NULL;
     int res = _PyHamt_Find(vars, (PyObject*)var, &found);
@@ -208,6 +225,9 @@ PyContextVar_Get(PyObject *ovar, PyObject *def, PyObject **val)
         var->var_cached = found;  /* borrow */
         var->var_cached_tsid = ts->id;
         var->var_cached_tsver = ts->context_ver;
+#ifdef STACKLESS
+        var->var_cached_hamtver = vars->h_ver;
+#endif
 
         *val = found;
         goto found;
@@ -783,6 +803,9 @@ contextvar_set(PyContextVar *var, PyObject *val)
     var->var_cached = val;  /* borrow */
     var->var_cached_tsid = ts->id;
     var->var_cached_tsver = ts->context_ver;
+#ifdef STACKLESS
+    var->var_cached_hamtver = new_vars->h_ver;
+#endif
     return 0;
 }
 
@@ -869,6 +892,9 @@ contextvar_new(PyObject *name, PyObject *def)
     var->var_cached = NULL;
     var->var_cached_tsid = 0;
     var->var_cached_tsver = 0;
+#ifdef STACKLESS
+    var->var_cached_hamtver = 0;
+#endif
 
     if (_PyObject_GC_MAY_BE_TRACKED(name) ||
             (def != NULL && _PyObject_GC_MAY_BE_TRACKED(def)))
@@ -909,6 +935,9 @@ contextvar_tp_clear(PyContextVar *self)
     self->var_cached = NULL;
     self->var_cached_tsid = 0;
     self->var_cached_tsver = 0;
+#ifdef STACKLESS
+    self->var_cached_hamtver = 0;
+#endif
     return 0;
 }
 
@@ -64,6 +64,8 @@
  *  7. _Py_dg_strtod has been modified so that it doesn't accept strings with
  *     leading whitespace.
  *
+ *  8. _Py_dg_dtoa first tries Grisu3 in mode 0, see grisu3() below.
+ *
  ***************************************************************/
 
 /* Please send bug reports for the original dtoa.c code to David M. Gay (dmg
@@ -2201,6 +2203,281 @@ _Py_dg_freedtoa(char *s)
     Bfree(b);
 }
 
+/* Shortest round-trip digits by Grisu3, the algorithm of Florian Loitsch,
+ * "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+ * [Proc. ACM SIGPLAN '10, pp. 233-243], as in the double-conversion
+ * library.
+ *
+ * The double and its rounding boundaries are scaled by a cached power of
+ * ten into a fixed range of 64-bit significands, where the digits are
+ * generated with integer arithmetic.  Grisu3 knows the error bounds of
+ * the scaling and gives up, for about 0.5% of the doubles, whenever it
+ * can't prove that the result is the shortest string that rounds to d
+ * and, of these, the closest to d.  Then _Py_dg_dtoa falls back to the
+ * bignum algorithm below, so that the result of mode 0 is the same.
+ */
+
+typedef struct { ULLong f; int e; } DiyFp;
+
+/* Normalized approximations f * 2**e of 10**k, for k = -348, -340, ...,
+   340. */
+static const struct { ULLong f; short e; short k; } grisu_powers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348},
+    {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316},
+    {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300},
+    {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268},
+    {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252},
+    {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220},
+    {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204},
+    {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172},
+    {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156},
+    {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124},
+    {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108},
+    {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76},
+    {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60},
+    {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28},
+    {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12},
+    {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20},
+    {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36},
+    {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68},
+    {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84},
+    {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116},
+    {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132},
+    {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164},
+    {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180},
+    {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212},
+    {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228},
+    {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260},
+    {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276},
+    {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308},
+    {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324},
+    {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+/* The scaled significands have binary exponents in this range. */
+#define GRISU_MIN_EXP (-60)
+#define GRISU_MAX_EXP (-32)
+
+/* The upper 64 bits of the product of x and y, rounded. */
+static DiyFp
+diyfp_mul(DiyFp x, DiyFp y)
+{
+    ULLong a = x.f >> 32, b = x.f & 0xffffffffU;
+    ULLong c = y.f >> 32, d = y.f & 0xffffffffU;
+    ULLong ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    ULLong t = (bd >> 32) + (ad & 0xffffffffU) + (bc & 0xffffffffU)
+               + (1U << 31);
+    DiyFp r;
+
+    r.f = ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+static DiyFp
+diyfp_normalize(DiyFp x)
+{
+    while (!(x.f & ((ULLong)1 << 63))) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+/* Move the last digit of buffer down while that brings it closer to w,
+ * and check that the result is certainly within the rounding boundaries
+ * and certainly the closest.  All distances are in units of the
+ * generated digits, scaled by ten_kappa.  rest is the distance of the
+ * buffer to too_high, the boundary enlarged by the error unit.
+ */
+static int
+grisu_round_weed(char *buffer, int length, ULLong distance_too_high_w,
+                 ULLong unsafe_interval, ULLong rest, ULLong ten_kappa,
+                 ULLong unit)
+{
+    ULLong small_distance = distance_too_high_w - unit;
+    ULLong big_distance = distance_too_high_w + unit;
+
+    while (rest < small_distance &&
+           unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance ||
+            small_distance - rest >= rest + ten_kappa - small_distance)) {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+    /* If the digit could also be moved for the largest w, it's not
+       certain which one is the closest. */
+    if (rest < big_distance &&
+        unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance ||
+         big_distance - rest > rest + ten_kappa - big_distance))
+        return 0;
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+/* Generate the shortest digits within low..high, which are w scaled by
+ * 10**k with an error of one unit.  Return 1 and set *length and *kappa
+ * so that w is buffer * 10**(kappa - k), or return 0 if Grisu3 can't
+ * decide.
+ */
+static int
+grisu_digit_gen(DiyFp low, DiyFp w, DiyFp high, char *buffer, int *length,
+                int *kappa)
+{
+    ULLong unit = 1;
+    ULLong too_low = low.f - unit, too_high = high.f + unit;
+    ULLong unsafe_interval = too_high - too_low;
+    int shift = -w.e;
+    ULLong one = (ULLong)1 << shift;
+    ULong integrals = (ULong)(too_high >> shift);
+    ULLong fractionals = too_high & (one - 1);
+    ULong divisor = 1;
+
+    /* integrals < 2**32, so there are at most 10 digits */
+    *kappa = 0;
+    if (integrals) {
+        *kappa = 1;
+        while (*kappa < 10 && integrals / divisor >= 10) {
+            divisor *= 10;
+            ++*kappa;
+        }
+    }
+    *length = 0;
+    while (*kappa > 0) {
+        ULLong rest;
+        buffer[(*length)++] = (char)('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        rest = ((ULLong)integrals << shift) + fractionals;
+        if (rest < unsafe_interval)
+            return grisu_round_weed(buffer, *length, too_high - w.f,
+                                    unsafe_interval, rest,
+                                    (ULLong)divisor << shift, unit);
+        divisor /= 10;
+    }
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        buffer[(*length)++] = (char)('0' + (int)(fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        if (fractionals < unsafe_interval)
+            return grisu_round_weed(buffer, *length,
+                                    (too_high - w.f) * unit,
+                                    unsafe_interval, fractionals, one, unit);
+    }
+}
+
+/* Write the shortest digits of the positive finite double u, at most 17,
+ * to buffer.  Return the number of digits and set *decpt as _Py_dg_dtoa
+ * does, or return 0 if Grisu3 fails.
+ */
+static int
+grisu3(U *u, char *buffer, int *decpt)
+{
+    DiyFp w, plus, minus, c;
+    int biased_e = (int)((word0(u) & Exp_mask) >> Exp_shift);
+    int min_exp, k, index, length, kappa;
+
+    w.f = ((ULLong)(word0(u) & Frac_mask) << 32) | word1(u);
+    if (biased_e) {
+        w.f |= (ULLong)1 << 52;
+        w.e = biased_e - Bias - (P - 1);
+    }
+    else
+        w.e = 1 - Bias - (P - 1);
+
+    /* the boundaries are halfway to the neighbours; the lower one is
+       closer if w is a power of two, except for the smallest normal */
+    plus.f = (w.f << 1) + 1;
+    plus.e = w.e - 1;
+    plus = diyfp_normalize(plus);
+    if (w.f == (ULLong)1 << 52 && biased_e > 1) {
+        minus.f = (w.f << 2) - 1;
+        minus.e = w.e - 2;
+    }
+    else {
+        minus.f = (w.f << 1) - 1;
+        minus.e = w.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    w = diyfp_normalize(w);
+
+    /* choose the cached power c of ten which brings the exponent of w * c
+       to GRISU_MIN_EXP..GRISU_MAX_EXP */
+    min_exp = GRISU_MIN_EXP - (w.e + 64);
+    k = (int)ceil((min_exp + 63) * 0.30102999566398114);
+    index = (348 + k - 1) / 8 + 1;
+    c.f = grisu_powers[index].f;
+    c.e = grisu_powers[index].e;
+    assert(GRISU_MIN_EXP <= w.e + c.e + 64 && w.e + c.e + 64 <= GRISU_MAX_EXP);
+
+    if (!grisu_digit_gen(diyfp_mul(minus, c), diyfp_mul(w, c),
+                         diyfp_mul(plus, c), buffer, &length, &kappa))
+        return 0;
+    *decpt = length - grisu_powers[index].k + kappa;
+    return length;
+}
+
 /* dtoa for IEEE arithmetic (dmg): convert double to ASCII string.
  *
  * Inspired by "How to Print Floating-Point Numbers Accurately" by
@@ -2316,6 +2593,17 @@ _Py_dg_dtoa(double dd, int mode, int ndigits,
         return nrv_alloc("0", rve, 1);
     }
 
+    if (mode <= 0 || mode > 9) {
+        char buf[20];
+        int len = grisu3(&u, buf, decpt);
+        if (len > 0) {
+            /* the shortest digits never end in a zero */
+            assert(buf[len - 1] != '0');
+            buf[len] = '\0';
+            return nrv_alloc(buf, rve, len);
+        }
+    }
+
     /* compute k = floor(log10(d)).  The computation may leave k
        one too large, but should never leave k too small. */
     b = d2b(&u, &be, &bbits);
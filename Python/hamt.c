@@ -335,6 +335,11 @@ typedef struct {
 static PyHamtNode_Bitmap *_empty_bitmap_node;
 static PyHamtObject *_empty_hamt;
 
+#ifdef STACKLESS
+/* source of the versions of HAMT objects */
+static uint64_t hamt_next_ver = 0;
+#endif
+
 
 static PyHamtObject *
 hamt_alloc(void);
@@ -2481,6 +2486,9 @@ hamt_alloc(void)
     o->h_count = 0;
     o->h_root = NULL;
     o->h_weakreflist = NULL;
+#ifdef STACKLESS
+    o->h_ver = ++hamt_next_ver;
+#endif
     PyObject_GC_Track(o);
     return o;
 }
@@ -163,10 +163,10 @@ static void *opcode_targets[256] = {
     &&TARGET_CALL_METHOD,
     &&TARGET_CALL_FINALLY,
     &&TARGET_POP_FINALLY,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
+    &&TARGET_LOAD_FAST_LOAD_FAST,
+    &&TARGET_LOAD_FAST_LOAD_ATTR,
+    &&TARGET_STORE_FAST_LOAD_FAST,
+    &&TARGET_COMPARE_AND_BRANCH,
     &&_unknown_opcode,
     &&_unknown_opcode,
     &&_unknown_opcode,
@@ -533,3 +533,48 @@ PyCode_Optimize(PyObject *code, PyObject* consts, PyObject *names,
     PyMem_Free(codestr);
     return code;
 }
+
+/* Fuse frequent pairs of instructions into superinstructions.
+
+   Only the opcode of the first instruction of a pair is replaced, its
+   argument and the second instruction stay in place. Therefore jump targets,
+   EXTENDED_ARG prefixes and instruction offsets (f_lasti) remain valid. The
+   interpreter executes the first instruction and continues directly with the
+   second one, if nothing requires a regular dispatch.
+
+   The compiler never emits superinstructions. The interpreter applies this
+   pass to its private copy of the bytecode, see _PyCode_Quicken().
+   Return the number of fused pairs. */
+Py_ssize_t
+_PyCode_FuseSuperinstructions(_Py_CODEUNIT *codestr, Py_ssize_t codelen)
+{
+    Py_ssize_t i, fused = 0;
+
+    for (i = 0; i + 1 < codelen; i++) {
+        unsigned char opcode = _Py_OPCODE(codestr[i]);
+        unsigned char next = _Py_OPCODE(codestr[i + 1]);
+        unsigned char super;
+
+        switch (opcode) {
+            case LOAD_FAST:
+                super = next == LOAD_FAST ? LOAD_FAST_LOAD_FAST :
+                        next == LOAD_ATTR ? LOAD_FAST_LOAD_ATTR : 0;
+                break;
+            case STORE_FAST:
+                super = next == LOAD_FAST ? STORE_FAST_LOAD_FAST : 0;
+                break;
+            case COMPARE_OP:
+                super = next == POP_JUMP_IF_FALSE ? COMPARE_AND_BRANCH : 0;
+                break;
+            default:
+                super = 0;
+        }
+        if (super) {
+            codestr[i] = PACKOPARG(super, _Py_OPARG(codestr[i]));
+            fused++;
+            /* The second instruction must keep its plain opcode */
+            i++;
+        }
+    }
+    return fused;
+}
@@ -380,6 +380,7 @@ preconfig_copy(PyPreConfig *config, const PyPreConfig *config2)
     COPY_ATTR(coerce_c_locale_warn);
     COPY_ATTR(utf8_mode);
     COPY_ATTR(allocator);
+    COPY_ATTR(arena_size);
 #ifdef MS_WINDOWS
     COPY_ATTR(legacy_windows_fs_encoding);
 #endif
@@ -424,6 +425,7 @@ _PyPreConfig_AsDict(const PyPreConfig *config)
 #endif
     SET_ITEM_INT(dev_mode);
     SET_ITEM_INT(allocator);
+    SET_ITEM_INT(arena_size);
     return dict;
 
 fail:
@@ -725,6 +727,70 @@ preconfig_init_allocator(PyPreConfig *config)
 }
 
 
+/* Parse a size in bytes with an optional "K" (KiB) or "M" (MiB) suffix.
+   Return 0 on success, or -1 on error. */
+static int
+preconfig_parse_size(const wchar_t *str, int *size)
+{
+    wchar_t *end;
+    long value;
+    int shift = 0;
+
+    errno = 0;
+    value = wcstol(str, &end, 10);
+    if (end == str || errno != 0 || value <= 0) {
+        return -1;
+    }
+    if (*end == L'K' || *end == L'k') {
+        shift = 10;
+        end++;
+    }
+    else if (*end == L'M' || *end == L'm') {
+        shift = 20;
+        end++;
+    }
+    if (*end != L'\0' || value > (INT_MAX >> shift)) {
+        return -1;
+    }
+    *size = (int)(value << shift);
+    return 0;
+}
+
+
+static PyStatus
+preconfig_init_arena_size(PyPreConfig *config, const _PyPreCmdline *cmdline)
+{
+    if (config->arena_size > 0) {
+        return _PyStatus_OK();
+    }
+
+    const wchar_t *xopt;
+    xopt = _Py_get_xoption(&cmdline->xoptions, L"arena_size");
+    if (xopt) {
+        wchar_t *sep = wcschr(xopt, L'=');
+        if (sep == NULL || preconfig_parse_size(sep + 1,
+                                                &config->arena_size) < 0) {
+            return _PyStatus_ERR("invalid -X arena_size option value");
+        }
+        return _PyStatus_OK();
+    }
+
+    const char *opt = _Py_GetEnv(config->use_environment,
+                                 "PYTHONMALLOC_ARENA_SIZE");
+    if (opt) {
+        wchar_t *wopt = Py_DecodeLocale(opt, NULL);
+        int res = (wopt != NULL
+                   ? preconfig_parse_size(wopt, &config->arena_size) : -1);
+        PyMem_RawFree(wopt);
+        if (res < 0) {
+            return _PyStatus_ERR("invalid PYTHONMALLOC_ARENA_SIZE "
+                                 "environment variable value");
+        }
+    }
+    return _PyStatus_OK();
+}
+
+
 static PyStatus
 preconfig_read(PyPreConfig *config, _PyPreCmdline *cmdline)
 {
@@ -757,6 +823,11 @@ preconfig_read(PyPreConfig *config, _PyPreCmdline *cmdline)
         return status;
     }
 
+    status = preconfig_init_arena_size(config, cmdline);
+    if (_PyStatus_EXCEPTION(status)) {
+        return status;
+    }
+
     assert(config->coerce_c_locale >= 0);
     assert(config->coerce_c_locale_warn >= 0);
 #ifdef MS_WINDOWS
@@ -931,6 +1002,17 @@ _PyPreConfig_Write(const PyPreConfig *src_config)
         return _PyStatus_OK();
     }
 
+    switch (_PyObject_SetArenaSize((size_t)config.arena_size)) {
+    case 0:
+        break;
+    case -2:
+        return _PyStatus_ERR("cannot change the arena size: "
+                             "arenas are already allocated");
+    default:
+        return _PyStatus_ERR("invalid arena size: must be a power of two "
+                             "between 256 KiB and 32 MiB");
+    }
+
     PyMemAllocatorName name = (PyMemAllocatorName)config.allocator;
     if (name != PYMEM_ALLOCATOR_NOT_SET) {
         if (_PyMem_SetupAllocators(name) < 0) {
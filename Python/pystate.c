@@ -645,6 +645,9 @@ new_threadstate(PyInterpreterState *interp, int init)
     tstate->context = NULL;
     tstate->context_ver = 1;
 
+    tstate->opcode_profile = NULL;
+    tstate->obmalloc_pools = NULL;
+
 #ifdef STACKLESS
     STACKLESS_PYSTATE_NEW;
 #endif
@@ -844,6 +847,9 @@ PyThreadState_Clear(PyThreadState *tstate)
 
     Py_CLEAR(tstate->context);
 
+    _PyEval_ClearOpcodeProfile(tstate);
+    _PyObject_ClearThreadPools(&tstate->obmalloc_pools);
+
 #ifdef STACKLESS
     STACKLESS_PYSTATE_CLEAR;
 #endif
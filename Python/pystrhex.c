@@ -4,6 +4,46 @@
 
 #include "pystrhex.h"
 
+/* SSE2 is part of the x86-64 baseline and can be used unconditionally. */
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HAVE_STRHEX_SSE2
+#  include <emmintrin.h>
+#endif
+
+/* Write the 2 * n hex digits of the n bytes at argbuf to retbuf, without
+   separators. */
+static void
+strhex_bulk(const unsigned char *argbuf, Py_ssize_t n, Py_UCS1 *retbuf)
+{
+    Py_ssize_t i = 0;
+#ifdef HAVE_STRHEX_SSE2
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    /* 'a' - '0' - 10 */
+    const __m128i letter = _mm_set1_epi8(39);
+    const __m128i zero = _mm_set1_epi8('0');
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i *)(argbuf + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+        __m128i lo = _mm_and_si128(in, nibble);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero),
+                          _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero),
+                          _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+        _mm_storeu_si128((__m128i *)(retbuf + 2 * i),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(retbuf + 2 * i + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; i < n; i++) {
+        retbuf[2 * i] = Py_hexdigits[argbuf[i] >> 4];
+        retbuf[2 * i + 1] = Py_hexdigits[argbuf[i] & 0xf];
+    }
+}
+
 static PyObject *_Py_strhex_impl(const char* argbuf, const Py_ssize_t arglen,
                                  const PyObject* sep, int bytes_per_sep_group,
                                  const int return_bytes)
@@ -76,7 +116,15 @@ static PyObject *_Py_strhex_impl(const char* argbuf, const Py_ssize_t arglen,
     }
 
     /* Hexlify */
-    for (i=j=0; i < arglen; ++i) {
+    if (!bytes_per_sep_group) {
+        strhex_bulk((const unsigned char *)argbuf, arglen, retbuf);
+        i = arglen;
+        j = resultlen;
+    }
+    else {
+        i = j = 0;
+    }
+    for (; i < arglen; ++i) {
         assert(j < resultlen);
         unsigned char c;
         c = (argbuf[i] >> 4) & 0xf;
@@ -17,6 +17,7 @@ Data members:
 #include "Python.h"
 #include "code.h"
 #include "frameobject.h"
+#include "pycore_ceval.h"
 #include "pycore_initconfig.h"
 #include "pycore_pylifecycle.h"
 #include "pycore_pymem.h"
@@ -1776,6 +1777,33 @@ sys__current_frames_impl(PyObject *module)
     return _PyThread_CurrentFrames();
 }
 
+/*[clinic input]
+sys._opcode_profile
+
+    enable: object = None
+    /
+
+Control the opcode execution profiler.
+
+If enable is true, discard all counts and start a new profile.  If
+enable is false, stop the profiler and return the counts.  If enable
+is None, return the counts and keep the profiler running.
+
+The result is a dict with the items "opcodes", a list of the execution
+counts of each opcode, "pairs", a dict mapping (opcode, next_opcode)
+to its count, and "code", a dict mapping code objects to dicts of
+opcode counts.  The counts of all threads are merged.
+
+This function should be used for specialized purposes only.
+[clinic start generated code]*/
+
+static PyObject *
+sys__opcode_profile_impl(PyObject *module, PyObject *enable)
+/*[clinic end generated code: output=6e69aba819a384f5 input=9eb5805456ab80eb]*/
+{
+    return _PyEval_OpcodeProfile(enable);
+}
+
 /*[clinic input]
 sys.call_tracing
 
@@ -1953,6 +1981,7 @@ static PyMethodDef sys_methods[] = {
     {"getsizeof",   (PyCFunction)(void(*)(void))sys_getsizeof,
      METH_VARARGS | METH_KEYWORDS, getsizeof_doc},
     SYS__GETFRAME_METHODDEF
+    SYS__OPCODE_PROFILE_METHODDEF
     SYS_GETWINDOWSVERSION_METHODDEF
     SYS__ENABLELEGACYWINDOWSFSENCODING_METHODDEF
     SYS_INTERN_METHODDEF
@@ -119,6 +119,7 @@ slp_cstack_save(PyCStackObject *cstprev)
 
     memcpy((cstprev)->stack, (cstprev)->startaddr -
                              Py_SIZE(cstprev), stsizeb);
+    slp_cstack_gap_note_save(cstprev->tstate, Py_SIZE(cstprev));
 #ifdef SLP_SEH32
     //save the SEH handler
     cstprev->exception_list = (DWORD)
@@ -900,6 +901,7 @@ slp_eval_frame_newstack(PyFrameObject *f, int exc, PyObject *retval)
         return retval;
     }
 
+    ts->st.cstack_gap.spills++;
     SLP_SET_CURRENT_FRAME(ts, f);
     cf = slp_cframe_new(eval_frame_callback, 1);
     if (cf == NULL)
@@ -144,6 +144,7 @@ slp_channel_remove(PyChannelObject *channel,
     channel->balance -= dir;
     SLP_HEADCHAIN_REMOVE(task, next, prev);
     task->flags.blocked = 0;
+    task->gc_blocked_since = 0;
     return task;
 }
 
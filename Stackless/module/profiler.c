@@ -0,0 +1,491 @@
+/******************************************************
+
+  The sampling profiler
+
+ ******************************************************/
+
+/*
+ * The profiler samples the Python frame stacks of all tasklets. Unlike
+ * the profile and trace functions, which are exchanged on every tasklet
+ * switch, it has no per tasklet state.
+ *
+ * A timer signal (SIGPROF) sets the flag ceval->profiler_sample_pending
+ * and the eval_breaker. The signal handler does nothing else, because it
+ * runs asynchronously and without the GIL. At the next eval_breaker check
+ * the eval loop calls slp_profiler_take_sample(). This function records
+ * the id of the current tasklet and the code objects of its frame stack
+ * into a ring buffer. Therefore the profiler costs nothing, if it is not
+ * running.
+ *
+ * The ring buffer is a flat array of slots. Each sample occupies a header
+ * slot followed by "depth" code slots (innermost frame first). If the
+ * buffer is full, the oldest samples get overwritten. All accesses to the
+ * buffer are made by threads holding the GIL, therefore the buffer needs
+ * no lock. The flag profiler.busy protects the buffer against recursive
+ * modifications, i.e. if a Py_DECREF() runs Python code.
+ */
+
+#include "Python.h"
+
+#ifdef STACKLESS
+#include "pycore_stackless.h"
+#include "frameobject.h"
+
+#ifdef HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#if defined(HAVE_SETITIMER) && defined(HAVE_SIGACTION) && defined(SIGPROF)
+#define SLP_PROFILER_HAVE_TIMER
+#endif
+
+/* maximum number of frames recorded per sample */
+#define SLP_PROFILER_MAX_DEPTH 256
+/* default size of the ring buffer in slots */
+#define SLP_PROFILER_DEFAULT_CAPACITY (1 << 18)
+
+typedef union _slp_profiler_slot {
+    struct {
+        uintptr_t tasklet_id;
+        unsigned long thread_id;
+        int depth;
+        int on_demand;
+    } header;
+    PyObject *code;
+} slp_profiler_slot;
+
+static struct {
+    int running;
+    int busy;
+    long interval;      /* in microseconds */
+    slp_profiler_slot *slots;
+    Py_ssize_t capacity;
+    Py_ssize_t head;    /* index of the next slot to write */
+    Py_ssize_t tail;    /* index of the header of the oldest sample */
+    Py_ssize_t used;    /* number of used slots */
+    Py_ssize_t samples; /* number of samples in the buffer */
+    Py_ssize_t dropped; /* number of overwritten samples */
+    Py_ssize_t lost;    /* number of samples not taken, because busy was set */
+#ifdef SLP_PROFILER_HAVE_TIMER
+    struct sigaction old_action;
+#endif
+} profiler;
+
+/* Remove the oldest sample from the buffer. Must be called with busy set. */
+static void
+profiler_drop_oldest(void)
+{
+    slp_profiler_slot *slots = profiler.slots;
+    Py_ssize_t i = profiler.tail;
+    int depth = slots[i].header.depth;
+
+    assert(profiler.busy);
+    assert(profiler.samples > 0);
+    for (int k = 0; k < depth; k++) {
+        i = (i + 1) % profiler.capacity;
+        Py_DECREF(slots[i].code);
+    }
+    profiler.tail = (i + 1) % profiler.capacity;
+    profiler.used -= 1 + depth;
+    profiler.samples--;
+    profiler.dropped++;
+}
+
+/* Record the frame stack starting at frame f. */
+static void
+profiler_record(PyThreadState *ts, PyTaskletObject *task, PyFrameObject *f,
+                int on_demand)
+{
+    PyObject *codes[SLP_PROFILER_MAX_DEPTH];
+    int depth = 0;
+    Py_ssize_t i;
+
+    assert(profiler.busy);
+    if (profiler.slots == NULL)
+        return;
+    for (; f != NULL && depth < SLP_PROFILER_MAX_DEPTH; f = f->f_back) {
+        if (!PyFrame_Check(f))
+            continue;  /* a cframe */
+        codes[depth] = (PyObject *)f->f_code;
+        Py_INCREF(codes[depth]);
+        depth++;
+    }
+    /* Dropping old samples may run arbitrary Python code. Therefore we
+     * own the references to the code objects. */
+    while (depth + 1 > profiler.capacity)
+        Py_DECREF(codes[--depth]);
+    while (profiler.capacity - profiler.used < depth + 1)
+        profiler_drop_oldest();
+
+    i = profiler.head;
+    profiler.slots[i].header.tasklet_id = (uintptr_t)task;
+    profiler.slots[i].header.thread_id = ts ? ts->thread_id : 0;
+    profiler.slots[i].header.depth = depth;
+    profiler.slots[i].header.on_demand = on_demand;
+    for (int k = 0; k < depth; k++) {
+        i = (i + 1) % profiler.capacity;
+        profiler.slots[i].code = codes[k];
+    }
+    profiler.head = (i + 1) % profiler.capacity;
+    profiler.used += 1 + depth;
+    profiler.samples++;
+}
+
+void
+slp_profiler_take_sample(PyThreadState *ts)
+{
+    if (!profiler.running)
+        return;
+    if (profiler.busy) {
+        profiler.lost++;
+        return;
+    }
+    profiler.busy = 1;
+    profiler_record(ts, ts->st.current, ts->frame, 0);
+    profiler.busy = 0;
+}
+
+static void
+profiler_clear(void)
+{
+    assert(profiler.busy);
+    while (profiler.samples > 0)
+        profiler_drop_oldest();
+    profiler.head = profiler.tail = 0;
+    profiler.dropped = profiler.lost = 0;
+}
+
+#ifdef SLP_PROFILER_HAVE_TIMER
+static void
+profiler_signal_handler(int signum)
+{
+    /* async signal safe: only atomic stores */
+    struct _ceval_runtime_state *ceval = &_PyRuntime.ceval;
+    _Py_atomic_store_relaxed(&ceval->profiler_sample_pending, 1);
+    _Py_atomic_store_relaxed(&ceval->eval_breaker, 1);
+}
+
+static int
+profiler_set_timer(long interval)
+{
+    struct itimerval timer;
+    timer.it_interval.tv_sec = interval / 1000000;
+    timer.it_interval.tv_usec = interval % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+static int
+profiler_stop(void)
+{
+    if (!profiler.running)
+        return 0;
+#ifdef SLP_PROFILER_HAVE_TIMER
+    if (profiler_set_timer(0))
+        return -1;
+    if (sigaction(SIGPROF, &profiler.old_action, NULL) != 0) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+#endif
+    profiler.running = 0;
+    return 0;
+}
+
+/******************************************************
+
+  The _stackless._profiler module
+
+ ******************************************************/
+
+PyDoc_STRVAR(profiler_start__doc__,
+"start(interval, capacity=0) -- start sampling every interval microseconds\n\
+of CPU time.\n\
+\n\
+Samples are recorded into a ring buffer of capacity slots. Each sample uses\n\
+one slot plus one slot per frame. If capacity is 0, a default capacity is\n\
+used. Changing the capacity clears the buffer.");
+
+static PyObject *
+profiler_start(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *argnames[] = {"interval", "capacity", NULL};
+    long interval;
+    Py_ssize_t capacity = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "l|n:start", argnames,
+                                     &interval, &capacity))
+        return NULL;
+    if (interval <= 0)
+        VALUE_ERROR("interval must be positive", NULL);
+    if (capacity < 0)
+        VALUE_ERROR("capacity must not be negative", NULL);
+    if (capacity == 0)
+        capacity = profiler.capacity ? profiler.capacity : SLP_PROFILER_DEFAULT_CAPACITY;
+    if (capacity < 2)
+        VALUE_ERROR("capacity is too small", NULL);
+    if (profiler.running)
+        RUNTIME_ERROR("the profiler is already running", NULL);
+    if (profiler.busy)
+        RUNTIME_ERROR("the profiler is busy", NULL);
+#ifndef SLP_PROFILER_HAVE_TIMER
+    PyErr_SetString(PyExc_NotImplementedError,
+                    "sampling requires setitimer() and sigaction()");
+    return NULL;
+#else
+    if (capacity != profiler.capacity) {
+        slp_profiler_slot *slots;
+        if ((size_t)capacity > PY_SSIZE_T_MAX / sizeof(slp_profiler_slot))
+            return PyErr_NoMemory();
+        slots = PyMem_RawMalloc(capacity * sizeof(slp_profiler_slot));
+        if (slots == NULL)
+            return PyErr_NoMemory();
+        profiler.busy = 1;
+        profiler_clear();
+        profiler.busy = 0;
+        PyMem_RawFree(profiler.slots);
+        profiler.slots = slots;
+        profiler.capacity = capacity;
+        profiler.used = 0;
+    }
+
+    {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = profiler_signal_handler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        if (sigaction(SIGPROF, &action, &profiler.old_action) != 0)
+            return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    profiler.interval = interval;
+    profiler.running = 1;
+    if (profiler_set_timer(interval)) {
+        PyObject *exc, *val, *tb;
+        PyErr_Fetch(&exc, &val, &tb);
+        profiler_stop();
+        PyErr_Restore(exc, val, tb);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+#endif
+}
+
+PyDoc_STRVAR(profiler_stop__doc__,
+"stop() -- stop sampling. The recorded samples are kept.");
+
+static PyObject *
+profiler_stop_meth(PyObject *self, PyObject *unused)
+{
+    if (profiler_stop())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(profiler_is_running__doc__,
+"is_running() -- return True, if the profiler is sampling.");
+
+static PyObject *
+profiler_is_running(PyObject *self, PyObject *unused)
+{
+    return PyBool_FromLong(profiler.running);
+}
+
+PyDoc_STRVAR(profiler_sample__doc__,
+"sample(tasklets) -- record a sample of the frame stack of each tasklet in\n\
+the iterable tasklets, i.e. of blocked tasklets.\n\
+\n\
+This works, even if the profiler is not running. Dead tasklets are ignored.");
+
+static PyObject *
+profiler_sample(PyObject *self, PyObject *tasklets)
+{
+    PyObject *it, *item;
+
+    if (profiler.slots == NULL) {
+        slp_profiler_slot *slots = PyMem_RawMalloc(
+            SLP_PROFILER_DEFAULT_CAPACITY * sizeof(slp_profiler_slot));
+        if (slots == NULL)
+            return PyErr_NoMemory();
+        profiler.slots = slots;
+        profiler.capacity = SLP_PROFILER_DEFAULT_CAPACITY;
+    }
+    it = PyObject_GetIter(tasklets);
+    if (it == NULL)
+        return NULL;
+    while ((item = PyIter_Next(it)) != NULL) {
+        PyTaskletObject *t = (PyTaskletObject *)item;
+        if (!PyTasklet_Check(item)) {
+            Py_DECREF(item);
+            Py_DECREF(it);
+            TYPE_ERROR("sample() requires an iterable of tasklets", NULL);
+        }
+        if (profiler.busy) {
+            profiler.lost++;
+        }
+        else {
+            PyFrameObject *f = slp_get_frame(t);
+            if (f != NULL) {
+                profiler.busy = 1;
+                profiler_record(t->cstate->tstate, t, f, 1);
+                profiler.busy = 0;
+            }
+        }
+        Py_DECREF(item);
+    }
+    Py_DECREF(it);
+    if (PyErr_Occurred())
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(profiler_samples__doc__,
+"samples() -- return a list of the recorded samples, oldest first.\n\
+\n\
+Each sample is a tuple (thread_id, tasklet_id, on_demand, code_objects).\n\
+The tasklet_id is the id() of the sampled tasklet or 0. The item on_demand\n\
+is true for samples recorded by sample(). The code objects of the frame\n\
+stack are ordered from the outermost to the innermost frame.");
+
+static PyObject *
+profiler_samples(PyObject *self, PyObject *unused)
+{
+    PyObject *result, *codes, *sample;
+    slp_profiler_slot *slots = profiler.slots;
+    Py_ssize_t i, n;
+
+    if (profiler.busy)
+        RUNTIME_ERROR("the profiler is busy", NULL);
+    /* new samples are not recorded, while we build the result */
+    profiler.busy = 1;
+    result = PyList_New(profiler.samples);
+    if (result == NULL)
+        goto error;
+    for (i = profiler.tail, n = 0; n < profiler.samples; n++) {
+        int depth = slots[i].header.depth;
+        codes = PyTuple_New(depth);
+        if (codes == NULL)
+            goto error;
+        for (int k = 0; k < depth; k++) {
+            PyObject *code = slots[(i + 1 + k) % profiler.capacity].code;
+            Py_INCREF(code);
+            PyTuple_SET_ITEM(codes, depth - 1 - k, code);
+        }
+        /* PyLong_FromVoidPtr() like id(), unsigned long is too small on Win64 */
+        sample = Py_BuildValue("(kNON)",
+                               slots[i].header.thread_id,
+                               PyLong_FromVoidPtr(
+                                   (void *)slots[i].header.tasklet_id),
+                               slots[i].header.on_demand ? Py_True : Py_False,
+                               codes);
+        if (sample == NULL)
+            goto error;
+        PyList_SET_ITEM(result, n, sample);
+        i = (i + 1 + depth) % profiler.capacity;
+    }
+    profiler.busy = 0;
+    return result;
+error:
+    profiler.busy = 0;
+    Py_XDECREF(result);
+    return NULL;
+}
+
+PyDoc_STRVAR(profiler_clear__doc__,
+"clear() -- remove all samples from the buffer.");
+
+static PyObject *
+profiler_clear_meth(PyObject *self, PyObject *unused)
+{
+    if (profiler.busy)
+        RUNTIME_ERROR("the profiler is busy", NULL);
+    profiler.busy = 1;
+    profiler_clear();
+    profiler.busy = 0;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(profiler_stats__doc__,
+"stats() -- return a dictionary with statistics of the profiler.");
+
+static PyObject *
+profiler_stats(PyObject *self, PyObject *unused)
+{
+    return Py_BuildValue("{snsnsnsnsnsl}",
+                         "samples", profiler.samples,
+                         "dropped", profiler.dropped,
+                         "lost", profiler.lost,
+                         "used", profiler.used,
+                         "capacity", profiler.capacity,
+                         "interval", profiler.interval);
+}
+
+static PyMethodDef profiler_methods[] = {
+    {"start",      (PyCFunction)(void(*)(void))profiler_start,
+                   METH_VARARGS | METH_KEYWORDS, profiler_start__doc__},
+    {"stop",       (PyCFunction)profiler_stop_meth, METH_NOARGS,
+                   profiler_stop__doc__},
+    {"is_running", (PyCFunction)profiler_is_running, METH_NOARGS,
+                   profiler_is_running__doc__},
+    {"sample",     (PyCFunction)profiler_sample, METH_O,
+                   profiler_sample__doc__},
+    {"samples",    (PyCFunction)profiler_samples, METH_NOARGS,
+                   profiler_samples__doc__},
+    {"clear",      (PyCFunction)profiler_clear_meth, METH_NOARGS,
+                   profiler_clear__doc__},
+    {"stats",      (PyCFunction)profiler_stats, METH_NOARGS,
+                   profiler_stats__doc__},
+    {NULL,         NULL}       /* sentinel */
+};
+
+static void
+profiler_module_free(void *module)
+{
+    if (profiler_stop())
+        PyErr_Clear();
+    if (!profiler.busy) {
+        profiler.busy = 1;
+        profiler_clear();
+        profiler.busy = 0;
+    }
+}
+
+PyDoc_STRVAR(profiler_module__doc__,
+"The statistical sampling profiler of Stackless Python.\n\
+Use the object stackless.profiler instead of this module.");
+
+static struct PyModuleDef _profilermodule = {
+    PyModuleDef_HEAD_INIT,
+    "_stackless._profiler",
+    profiler_module__doc__,
+    -1,
+    profiler_methods,
+    NULL,
+    NULL,
+    NULL,
+    profiler_module_free
+};
+
+PyObject*
+slp_init_profiler(void)
+{
+    return PyModule_Create(&_profilermodule);
+}
+
+void
+slp_profiler_fini(void)
+{
+    /* It is too late to release the code objects. Just stop the timer. */
+    if (profiler_stop())
+        PyErr_Clear();
+}
+
+#endif
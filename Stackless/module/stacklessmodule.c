@@ -858,6 +858,70 @@ slpmodule_switch_trap(PyObject *self, PyObject *args)
     return PyLong_FromLong(PyStackless_AdjustSwitchTrap(change));
 }
 
+PyDoc_STRVAR(set_stack_gap__doc__,
+"set_stack_gap(gap) -- set the stack spilling watermark of the thread in bytes.\n\
+If the C-stack grows more than gap bytes, Stackless continues the recursion\n\
+on a new C-stack. A large gap increases the amount of memory copied by hard\n\
+switches, a small gap causes frequent stack spilling. If gap is 0, the\n\
+watermark adapts to the sizes of the C-stacks saved by the thread.\n\
+Other values are clamped to the limits of the adaptive watermark.\n\
+For inquiry only, use 'None' as the gap.\n\
+Returns the previous value. By default, the watermark is adaptive.");
+
+static PyObject *
+set_stack_gap(PyObject *self, PyObject *arg)
+{
+    PyThreadState *ts = _PyThreadState_GET();
+    Py_ssize_t old = ts->st.cstack_gap.fixed * (Py_ssize_t)sizeof(intptr_t);
+    Py_ssize_t gap;
+
+    if (arg == Py_None)
+        return PyLong_FromSsize_t(old);
+    gap = PyNumber_AsSsize_t(arg, NULL);
+    if (gap == -1 && PyErr_Occurred())
+        return NULL;
+    if (gap < 0)
+        VALUE_ERROR("gap must not be negative", NULL);
+    /* A tiny gap would spill every frame, a huge gap would never spill. */
+    if (gap != 0)
+        gap = slp_cstack_clamp_watermark(gap / (Py_ssize_t)sizeof(intptr_t));
+    if (gap == 0 && ts->st.cstack_gap.fixed) {
+        /* resume adapting from the default watermark */
+        ts->st.cstack_gap.watermark = 0;
+        ts->st.cstack_gap.average = 0;
+    }
+    else if (gap != 0) {
+        ts->st.cstack_gap.watermark = gap;
+    }
+    ts->st.cstack_gap.fixed = gap;
+    return PyLong_FromSsize_t(old);
+}
+
+PyDoc_STRVAR(get_stack_gap_stats__doc__,
+"get_stack_gap_stats() -- return a dictionary with the stack spilling\n\
+statistics of the thread:\n\
+'gap': the current watermark in bytes,\n\
+'fixed': the value set by set_stack_gap() or 0,\n\
+'average': the moving average of the sizes of saved C-stacks in bytes,\n\
+'saves': the number of saved C-stacks,\n\
+'saved': the total number of bytes copied by saves,\n\
+'spills': the number of times a recursion continued on a new C-stack.");
+
+static PyObject *
+get_stack_gap_stats(PyObject *self, PyObject *unused)
+{
+    PyThreadState *ts = _PyThreadState_GET();
+    const Py_ssize_t w = (Py_ssize_t)sizeof(intptr_t);
+
+    return Py_BuildValue("{snsnsnsnsLsn}",
+                         "gap", slp_cstack_get_watermark(ts) * w,
+                         "fixed", ts->st.cstack_gap.fixed * w,
+                         "average", ts->st.cstack_gap.average / 16 * w,
+                         "saves", ts->st.cstack_gap.saves,
+                         "saved", ts->st.cstack_gap.saved * w,
+                         "spills", ts->st.cstack_gap.spills);
+}
+
 PyDoc_STRVAR(set_error_handler__doc__,
 "set_error_handler(handler) -- Set or delete the error handler function \n\
 used for uncaught exceptions on tasklets.  \"handler\" should take three \n\
@@ -1600,6 +1664,10 @@ static PyMethodDef stackless_methods[] = {
      get_thread_info__doc__},
     {"switch_trap",                 (PCF)slpmodule_switch_trap, METH_VARARGS,
      slpmodule_switch_trap__doc__},
+    {"set_stack_gap",               (PCF)set_stack_gap,         METH_O,
+     set_stack_gap__doc__},
+    {"get_stack_gap_stats",         (PCF)get_stack_gap_stats,   METH_NOARGS,
+     get_stack_gap_stats__doc__},
     {"set_error_handler",           (PCF)set_error_handler,     METH_VARARGS,
      set_error_handler__doc__},
     {"_gc_untrack",                 (PCF)_gc_untrack,           METH_O,
@@ -1693,6 +1761,7 @@ void
 PyStackless_Fini(void)
 {
     slp_scheduling_fini();
+    slp_profiler_fini();
     slp_cframe_fini();
     slp_stacklesseval_fini();
 }
@@ -1752,6 +1821,20 @@ PyInit__stackless(void)
             "_stackless._wrap", tmp))
         goto fail;;
 
+    /* add the soft switchable functions of the builtins module */
+    if (slp_init_bltin_declarations(slp_module, &stacklessmodule) < 0)
+        goto fail;
+
+    /* add the profiler submodule */
+    tmp = slp_init_profiler();
+    if (tmp == NULL)
+        goto fail;
+    INSERT("_profiler", tmp);
+    Py_DECREF(tmp);
+    if (PyDict_SetItemString(PyImport_GetModuleDict(),
+            "_stackless._profiler", tmp))
+        goto fail;
+
     return slp_module;
 fail:
     Py_XDECREF(slp_module);
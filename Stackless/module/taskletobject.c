@@ -581,6 +581,7 @@ tasklet_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     t->tempval = Py_None;
     t->tsk_weakreflist = NULL;
     t->context = NULL;
+    t->gc_blocked_since = 0;
     Py_INCREF(ts->st.initial_stub);
     t->cstate = ts->st.initial_stub;
     t->def_globals = PyEval_GetGlobals();
@@ -820,6 +821,8 @@ tasklet_setstate(PyObject *self, PyObject *args)
     t->flags = tasklet_flags_from_integer(flags);
     if (t->next == NULL) {
         t->flags.blocked = 0;
+        /* a new blocking period starts, see park_blocked_tasklets() */
+        t->gc_blocked_since = 0;
     } else {
         t->flags.blocked = j;
     }
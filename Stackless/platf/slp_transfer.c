@@ -116,6 +116,23 @@ or disable the STACKLESS flag.
 #endif
 #endif  /* #ifndef SLP_CSTACK_WATERMARK */
 
+/* Limits of the adaptive watermark. The adaptive watermark follows
+ * SLP_CSTACK_GAP_FACTOR times the moving average of the sizes of saved
+ * C-stacks. If tasklets usually switch at a shallow C-stack depth, a deep
+ * recursion gets spilled early and a later hard switch copies less. Each
+ * spill saves a C-stack close to the watermark. If spills are frequent,
+ * they raise the average and therefore the watermark.
+ */
+#ifndef SLP_CSTACK_GAP_FACTOR
+#define SLP_CSTACK_GAP_FACTOR 4
+#endif
+#ifndef SLP_CSTACK_MIN_WATERMARK
+#define SLP_CSTACK_MIN_WATERMARK (SLP_CSTACK_WATERMARK / 8)
+#endif
+#ifndef SLP_CSTACK_MAX_WATERMARK
+#define SLP_CSTACK_MAX_WATERMARK SLP_CSTACK_WATERMARK
+#endif
+
 /* define direction of stack growth */
 
 #ifndef SLP_CSTACK_DOWNWARDS
@@ -360,11 +377,62 @@ slp_transfer_return(PyCStackObject *cst)
 int
 slp_cstack_save_now(const PyThreadState *tstate, const void * pstackvar)
 {
+    Py_ssize_t watermark;
     assert(tstate);
     assert(pstackvar);
     if (tstate->st.cstack_root == NULL)
         return 1;
-    return SLP_CSTACK_SUBTRACT(tstate->st.cstack_root, (const intptr_t*)pstackvar) > SLP_CSTACK_WATERMARK;
+    watermark = tstate->st.cstack_gap.watermark;
+    if (watermark == 0)
+        watermark = SLP_CSTACK_WATERMARK;
+    return SLP_CSTACK_SUBTRACT(tstate->st.cstack_root, (const intptr_t*)pstackvar) > watermark;
+}
+
+void
+slp_cstack_gap_note_save(PyThreadState *tstate, Py_ssize_t size)
+{
+    Py_ssize_t average, watermark;
+    assert(tstate);
+    assert(size >= 0);
+    tstate->st.cstack_gap.saves++;
+    tstate->st.cstack_gap.saved += size;
+    if (size > SLP_CSTACK_MAX_WATERMARK)
+        size = SLP_CSTACK_MAX_WATERMARK;
+    /* exponential moving average with weight 1/16, scaled by 16 */
+    average = tstate->st.cstack_gap.average;
+    if (average == 0)
+        average = size * 16;
+    else
+        average += size - average / 16;
+    tstate->st.cstack_gap.average = average;
+    if (tstate->st.cstack_gap.fixed)
+        return;
+    watermark = average / 16 * SLP_CSTACK_GAP_FACTOR;
+    if (watermark < SLP_CSTACK_MIN_WATERMARK)
+        watermark = SLP_CSTACK_MIN_WATERMARK;
+    else if (watermark > SLP_CSTACK_MAX_WATERMARK)
+        watermark = SLP_CSTACK_MAX_WATERMARK;
+    tstate->st.cstack_gap.watermark = watermark;
+}
+
+/* Clamp a fixed watermark to the limits of the adaptive watermark. */
+Py_ssize_t
+slp_cstack_clamp_watermark(Py_ssize_t watermark)
+{
+    if (watermark < SLP_CSTACK_MIN_WATERMARK)
+        return SLP_CSTACK_MIN_WATERMARK;
+    if (watermark > SLP_CSTACK_MAX_WATERMARK)
+        return SLP_CSTACK_MAX_WATERMARK;
+    return watermark;
+}
+
+Py_ssize_t
+slp_cstack_get_watermark(PyThreadState *tstate)
+{
+    assert(tstate);
+    if (tstate->st.cstack_gap.watermark == 0)
+        return SLP_CSTACK_WATERMARK;
+    return tstate->st.cstack_gap.watermark;
 }
 
 void
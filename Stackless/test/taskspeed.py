@@ -335,6 +335,7 @@ res.append(tester(test_cframe_nr, niter, (), "cframe softswitches"))
 enable_softswitch(0)
 res.append(tester(chantest, niter, (), "channel hard top   "))
 res.append(tester(chantest, niter, (3,), "channel hard nest 3"))
+res.append(tester(chantest, niter, (30,), "channel hard nest 30"))
 enable_softswitch(1)
 res.append(tester(chantest, niter, (), "channel soft       "))
 res.append(tester(chantest, niter, (0, 0, 1), "channel iterator   "))
@@ -371,6 +372,11 @@ if IS_SLP:
     run()
     cleanup()
 
+    stats = get_stack_gap_stats()
+    print("Stack spilling watermark     =", stats["gap"] // adrsize)
+    print("Stack words copied by saves  =", stats["saved"] // adrsize)
+    print("Stack spills                 =", stats["spills"])
+
 results_2002_07_28 = """
 python22/python taskspeed.py
 hey this is sitepython
@@ -0,0 +1,154 @@
+import unittest
+import sys
+import gc
+import weakref
+
+import stackless
+
+from support import test_main  # @UnusedImport
+from support import StacklessTestCase
+
+
+class TestParkedGeneration(StacklessTestCase):
+    """Test the parked generation of the garbage collector"""
+
+    def setUp(self):
+        super().setUp()
+        self.addCleanup(gc.set_park_threshold, *gc.get_park_threshold())
+
+    def blocked_tasklets(self, n):
+        channel = stackless.channel()
+        received = []
+
+        def receiver():
+            received.append(channel.receive())
+        tasklets = [stackless.tasklet(receiver)() for i in range(n)]
+        stackless.run()
+        self.assertTrue(all(t.blocked for t in tasklets))
+        return channel, tasklets, received
+
+    def test_threshold(self):
+        gc.set_park_threshold(3, 1000)
+        self.assertEqual(gc.get_park_threshold(), (3, 1000))
+        gc.set_park_threshold(0)
+        self.assertEqual(gc.get_park_threshold(), (0, 0))
+        self.assertRaises(ValueError, gc.set_park_threshold, -1)
+        self.assertRaises(ValueError, gc.set_park_threshold, 1, -1)
+
+    def test_stats(self):
+        stats = gc.get_parked_stats()
+        self.assertEqual(set(stats), {"objects", "tasklets", "frames", "merges"})
+        for st in gc.get_stats():
+            self.assertIsInstance(st["time"], float)
+            self.assertGreaterEqual(st["time"], 0.0)
+
+    def test_park_and_resume(self):
+        channel, tasklets, received = self.blocked_tasklets(10)
+        old = gc.get_parked_stats()
+        gc.set_park_threshold(1)
+        gc.collect()  # the tasklets are seen blocked for the first time
+        self.assertEqual(gc.get_parked_stats()["tasklets"], old["tasklets"])
+        gc.collect()  # now they get parked
+        new = gc.get_parked_stats()
+        self.assertEqual(new["tasklets"], old["tasklets"] + 10)
+        self.assertGreaterEqual(new["frames"], old["frames"] + 10)
+        self.assertGreaterEqual(new["objects"], 20)
+
+        # parked objects are still visible
+        objects = gc.get_objects()
+        for t in tasklets:
+            self.assertTrue(gc.is_tracked(t))
+            self.assertTrue(any(t is o for o in objects))
+        self.assertIn(tasklets[0], gc.get_referrers(tasklets[0].frame))
+
+        # parked tasklets continue to work
+        for i in range(10):
+            channel.send(i)
+        self.assertEqual(received, list(range(10)))
+        self.assertFalse(any(t.alive for t in tasklets))
+
+    def test_explicit_collection_collects_parked(self):
+        # a hard switched tasklet is kept alive by its C-stack
+        self.skipUnlessSoftswitching()
+        channel, tasklets, received = self.blocked_tasklets(1)
+        ref = weakref.ref(tasklets[0])
+        gc.set_park_threshold(1)
+        gc.collect()
+        gc.collect()
+        self.assertGreater(gc.get_parked_stats()["objects"], 0)
+        # the cycle channel -> tasklet -> frame -> channel is garbage now
+        del channel, tasklets
+        merges = gc.get_parked_stats()["merges"]
+        gc.collect()
+        self.assertGreater(gc.get_parked_stats()["merges"], merges)
+        self.assertIsNone(ref())
+
+    def test_disable_unparks(self):
+        channel, tasklets, received = self.blocked_tasklets(1)
+        gc.set_park_threshold(1)
+        gc.collect()
+        gc.collect()
+        self.assertGreater(gc.get_parked_stats()["objects"], 0)
+        gc.set_park_threshold(0)
+        self.assertEqual(gc.get_parked_stats()["objects"], 0)
+        channel.send(None)
+        self.assertEqual(received, [None])
+
+    def test_unblocked_tasklet_is_not_parked(self):
+        channel = stackless.channel()
+
+        def receiver():
+            channel.receive()
+            channel.receive()
+        t = stackless.tasklet(receiver)()
+        stackless.run()
+        old = gc.get_parked_stats()
+        gc.set_park_threshold(1)
+        gc.collect()
+        # unblock and block again: the tasklet starts a new blocking period
+        channel.send(None)
+        self.assertTrue(t.blocked)
+        gc.collect()
+        self.assertEqual(gc.get_parked_stats()["tasklets"], old["tasklets"])
+        gc.collect()
+        self.assertEqual(gc.get_parked_stats()["tasklets"], old["tasklets"] + 1)
+        channel.send(None)
+        self.assertFalse(t.alive)
+
+    def test_incremental_collection_unparks(self):
+        channel, tasklets, received = self.blocked_tasklets(10)
+        gc.set_park_threshold(1)
+        gc.collect()
+        gc.collect()
+        self.assertGreater(gc.get_parked_stats()["objects"], 0)
+        try:
+            gc.set_incremental(0.1)
+        except NotImplementedError:
+            self.skipTest("incremental collection is not supported")
+        self.addCleanup(gc.set_incremental, 0)
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        gc.set_threshold(100, 1, 1)
+        merges = gc.get_parked_stats()["merges"]
+        slices = gc.get_stats()[2]["slices"]
+        live = []
+        for i in range(200000):
+            live.append([])
+            if gc.get_stats()[2]["slices"] > slices:
+                break
+        self.assertGreater(gc.get_stats()[2]["slices"], slices)
+        # an increment must not take objects from the parked generation
+        self.assertEqual(gc.get_parked_stats()["objects"], 0)
+        self.assertGreater(gc.get_parked_stats()["merges"], merges)
+        for i in range(10):
+            channel.send(i)
+        self.assertEqual(received, list(range(10)))
+        self.assertFalse(any(t.alive for t in tasklets))
+
+
+if __name__ == '__main__':
+    if not sys.argv[1:]:
+        sys.argv.append('-v')
+    unittest.main()
@@ -1309,6 +1309,112 @@ class TestCstate(StacklessTestCase):
             c = c.next
 
 
+class TestStackGap(StacklessTestCase):
+    def setUp(self):
+        super().setUp()
+        self.addCleanup(stackless.set_stack_gap, stackless.set_stack_gap(None))
+
+    def test_set_stack_gap(self):
+        stackless.set_stack_gap(0)
+        self.assertEqual(stackless.set_stack_gap(None), 0)
+        self.assertEqual(stackless.set_stack_gap(1 << 16), 0)
+        self.assertEqual(stackless.set_stack_gap(None), 1 << 16)
+        self.assertEqual(stackless.get_stack_gap_stats()["gap"], 1 << 16)
+        self.assertEqual(stackless.get_stack_gap_stats()["fixed"], 1 << 16)
+        self.assertEqual(stackless.set_stack_gap(0), 1 << 16)
+        self.assertEqual(stackless.get_stack_gap_stats()["fixed"], 0)
+        self.assertRaises(ValueError, stackless.set_stack_gap, -1)
+        self.assertRaises(TypeError, stackless.set_stack_gap, "1")
+
+    def test_set_stack_gap_clamped(self):
+        # gaps outside of the limits of the adaptive watermark are clamped
+        stackless.set_stack_gap(1)
+        low = stackless.set_stack_gap(None)
+        self.assertGreater(low, 7)
+        self.assertEqual(stackless.get_stack_gap_stats()["gap"], low)
+        stackless.set_stack_gap(7)
+        self.assertEqual(stackless.set_stack_gap(None), low)
+        self.assertEqual(stackless.get_stack_gap_stats()["fixed"], low)
+        stackless.set_stack_gap(1 << 100)
+        high = stackless.set_stack_gap(None)
+        self.assertGreaterEqual(high, low)
+        self.assertLess(high, 1 << 30)
+        self.assertEqual(stackless.get_stack_gap_stats()["gap"], high)
+        stackless.set_stack_gap(low + 8)
+        self.assertEqual(stackless.set_stack_gap(None), min(low + 8, high))
+
+    def test_stats(self):
+        stats = stackless.get_stack_gap_stats()
+        self.assertEqual(set(stats), {"gap", "fixed", "average", "saves", "saved", "spills"})
+        self.assertGreater(stats["gap"], 0)
+
+    def nested_receive(self, channel, nest, result):
+        if nest:
+            return self.nested_receive(channel, nest - 1, result)
+        result.append(channel.receive())
+
+    def test_spilling(self):
+        # a small watermark spills a deep recursion to a new C-stack
+        stackless.set_stack_gap(1024)
+        channel = stackless.channel()
+        result = []
+        t = stackless.tasklet(apply_not_stackless)(self.nested_receive, channel, 50, result)
+        stats = stackless.get_stack_gap_stats()
+        t.run()
+        self.assertTrue(t.blocked)
+        channel.send(42)
+        self.assertFalse(t.alive)
+        self.assertEqual(result, [42])
+        new = stackless.get_stack_gap_stats()
+        self.assertGreater(new["spills"], stats["spills"])
+        self.assertGreater(new["saves"], stats["saves"])
+        self.assertGreater(new["saved"], stats["saved"])
+
+
+
+class TestSoftSwitchableBuiltins(AsTaskletTestCase):
+    """map, filter, sorted and functools.partial call Python code soft switched"""
+
+    def assertLevel(self, expected=0):
+        if stackless.enable_softswitch(None):
+            self.assertEqual(stackless.current.nesting_level, expected)
+        else:
+            self.assertGreater(stackless.current.nesting_level, expected)
+
+    def callback(self, x):
+        self.assertLevel()
+        stackless.schedule()
+        self.assertLevel()
+        return x
+
+    def test_map(self):
+        self.assertEqual([x for x in map(self.callback, range(3))], [0, 1, 2])
+
+    def test_filter(self):
+        self.assertEqual([x for x in filter(self.callback, range(3))], [1, 2])
+        self.assertEqual([x for x in filter(lambda x: not self.callback(x), range(3))], [0])
+
+    def test_sorted(self):
+        self.assertEqual(sorted(range(4), key=lambda x: -self.callback(x)), [3, 2, 1, 0])
+        self.assertEqual(sorted(range(4), key=self.callback, reverse=True), [3, 2, 1, 0])
+        self.assertEqual(sorted([], key=self.callback), [])
+
+    def test_partial(self):
+        import functools
+        self.assertEqual(functools.partial(self.callback, 5)(), 5)
+        self.assertEqual(functools.partial(self.callback)(x=6), 6)
+
+    def test_errors(self):
+        def fail(x):
+            stackless.schedule()
+            raise ZeroDivisionError(x)
+        self.assertRaises(ZeroDivisionError, lambda: [x for x in map(fail, [1])])
+        self.assertRaises(ZeroDivisionError, lambda: [x for x in filter(fail, [1])])
+        self.assertRaises(ZeroDivisionError, sorted, [1], key=fail)
+        self.assertRaises(TypeError, sorted, [1], key=self.callback, reverse=1.5)
+        self.assertRaises(TypeError, sorted, [1], key=self.callback, foo=1)
+
+
 class TestTaskletFinalizer(StacklessTestCase):
     def test_zombie(self):
         loop = True
@@ -1752,6 +1858,36 @@ class TestTaskletContext(AsTaskletTestCase):
         self.assertNotEqual(cid0, cid)
         self.assertEqual(id(ctx), cid)
 
+    def test_cvar_cache_switch(self):
+        # ContextVar.get() caches the value. The cache must not return the
+        # value of another tasklet after a switch.
+        sentinel = object()
+        self.cvar.set(sentinel)
+        results = []
+
+        def task(value):
+            self.assertIs(self.cvar.get(), sentinel)  # inherited
+            stackless.schedule()
+            self.assertIs(self.cvar.get(), sentinel)
+            self.cvar.set(value)
+            for i in range(3):
+                stackless.schedule()
+                results.append((value, self.cvar.get()))
+            stackless.schedule()
+            contextvars.Context().run(lambda: results.append((value, self.cvar.get())))
+            results.append((value, self.cvar.get()))
+
+        # tasklets share the context of their creator, therefore use copies
+        tasklets = [stackless.tasklet(contextvars.copy_context().run)(task, i)
+                    for i in range(3)]
+        for t in tasklets:
+            t.run()
+        stackless.run()
+        self.assertIs(self.cvar.get(), sentinel)
+        self.assertEqual(sorted(results, key=str),
+                         sorted([(i, i) for i in range(3) for j in range(4)] +
+                                [(i, "unset") for i in range(3)], key=str))
+
     def test_main_tasklet_init(self):
         # This test succeeds, if Stackless copies ts->context to into the main
         # tasklet, when Stackless creates the main tasklet.
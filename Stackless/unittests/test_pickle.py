@@ -96,6 +96,42 @@ def xrangetest(n, when):
     return i
 
 
+class AttrTestClass:
+    __slots__ = ("slot", "__dict__")
+
+    def __init__(self, i):
+        self.slot = i
+        self.attr = 2 * i
+
+    def meth(self):
+        return self.slot + self.attr
+
+
+def attrtest(n, when):
+    # attribute access using the opcode cache of the interpreter
+    r = 0
+    for i in range(n):
+        if i == when:
+            schedule()
+        o = AttrTestClass(i)
+        r += o.slot + o.attr + o.meth()
+        del o
+    return r
+
+
+def supertest(n, when):
+    # executes the superinstructions of the interpreter
+    r = 0
+    i = 0
+    while i < n:
+        if i == when:
+            schedule()
+        j = i
+        r = r + j * i
+        i = j + 1
+    return r
+
+
 def enumeratetest(n, when):
     for i, ig in enumerate([None] * n):
         if i == when:
@@ -138,6 +174,29 @@ def tupletest(n, when):
     return i
 
 
+class KeyTestClass:
+    # a Python method as key function or predicate
+
+    def __init__(self, when):
+        self.when = when
+
+    def key(self, i):
+        if i == self.when:
+            schedule()
+        return -i
+
+
+def sortedtest(n, when):
+    return sorted(range(n), key=KeyTestClass(when).key)
+
+
+def filtertest(n, when):
+    r = 0
+    for i in filter(KeyTestClass(when).key, range(n)):
+        r += i
+    return r
+
+
 def genschedinnertest(n, when):
     for i in range(n):
         if i == when:
@@ -341,6 +400,17 @@ class TestPickledTasklets(StacklessPickleTestCase):
     def testRecursive(self):
         self.run_pickled(rectest, 13)
 
+    def testAttributeCache(self):
+        # execute the code often enough to create the opcode cache
+        for i in range(1100):
+            attrtest(2, -1)
+        self.run_pickled(attrtest, 20, 13)
+
+    def testSuperinstructions(self):
+        # f_lasti of a pickled frame is an offset into co_code
+        supertest(2, -1)
+        self.run_pickled(supertest, 20, 13)
+
     # Pickling of all three dictionary iterator types.
 
     # Test picking of the dictionary keys iterator.
@@ -365,6 +435,12 @@ class TestPickledTasklets(StacklessPickleTestCase):
     def testTuple(self):
         self.run_pickled(tupletest, 20, 13)
 
+    def testSorted(self):
+        self.run_pickled(sortedtest, 20, 13)
+
+    def testFilter(self):
+        self.run_pickled(filtertest, 20, 13)
+
     def testGeneratorScheduling(self):
         self.run_pickled(genschedoutertest, 20, 13)
 
@@ -0,0 +1,124 @@
+import unittest
+import sys
+import time
+
+import stackless
+
+from support import test_main  # @UnusedImport
+from support import StacklessTestCase
+
+has_timer = hasattr(__import__("signal"), "setitimer")
+
+
+def busy(seconds):
+    end = time.process_time() + seconds
+    while time.process_time() < end:
+        pass
+
+
+class TestProfiler(StacklessTestCase):
+    """Test the sampling profiler"""
+
+    def setUp(self):
+        super().setUp()
+        stackless.profiler.clear()
+
+    def tearDown(self):
+        stackless.profiler.stop()
+        stackless.profiler.clear()
+        super().tearDown()
+
+    @unittest.skipUnless(has_timer, "requires setitimer")
+    def test_start_stop(self):
+        self.assertFalse(stackless.profiler.is_running())
+        stackless.profiler.start(1000)
+        self.assertTrue(stackless.profiler.is_running())
+        self.assertRaises(RuntimeError, stackless.profiler.start, 1000)
+        stackless.profiler.stop()
+        self.assertFalse(stackless.profiler.is_running())
+        self.assertRaises(ValueError, stackless.profiler.start, 0)
+        self.assertRaises(ValueError, stackless.profiler.start, 1000, -1)
+
+    @unittest.skipUnless(has_timer, "requires setitimer")
+    def test_samples_all_tasklets(self):
+        def worker():
+            for i in range(5):
+                busy(0.02)
+                stackless.schedule()
+        tasklets = [stackless.tasklet(worker)() for i in range(3)]
+        stackless.profiler.start(1000)
+        stackless.run()
+        stackless.profiler.stop()
+        samples = stackless.profiler.samples()
+        stats = stackless.profiler.stats()
+        self.assertEqual(stats["samples"], len(samples))
+        self.assertGreater(len(samples), 0)
+        ids = {tasklet_id for thread_id, tasklet_id, on_demand, codes in samples
+               if any(c is worker.__code__ for c in codes)}
+        self.assertTrue(ids <= {id(t) for t in tasklets})
+        self.assertGreater(len(ids), 1)
+        for sample in samples:
+            self.assertFalse(sample[2])
+
+    def test_sample_blocked(self):
+        channel = stackless.channel()
+
+        def receiver():
+            channel.receive()
+        t = stackless.tasklet(receiver)()
+        stackless.run()
+        self.assertTrue(t.blocked)
+        stackless.profiler.sample([t])
+        samples = stackless.profiler.samples()
+        self.assertEqual(len(samples), 1)
+        thread_id, tasklet_id, on_demand, codes = samples[0]
+        self.assertEqual(tasklet_id, id(t))
+        self.assertTrue(on_demand)
+        self.assertIs(codes[-1], receiver.__code__)
+        channel.send(None)
+        self.assertRaises(TypeError, stackless.profiler.sample, [None])
+
+    def test_collapsed(self):
+        channel = stackless.channel()
+
+        def receiver():
+            channel.receive()
+        t = stackless.tasklet(receiver)()
+        stackless.run()
+        stackless.profiler.sample([t, t])
+        self.assertEqual(stackless.profiler.collapsed(), [])
+        lines = stackless.profiler.collapsed(by_tasklet=True, include_on_demand=True)
+        self.assertEqual(len(lines), 1)
+        stack, count = lines[0].rsplit(" ", 1)
+        self.assertEqual(count, "2")
+        self.assertTrue(stack.startswith("tasklet-%#x;" % id(t)))
+        self.assertTrue(stack.endswith("receiver (%s:%d)" %
+                                       (__file__, receiver.__code__.co_firstlineno)))
+        channel.send(None)
+
+    @unittest.skipUnless(has_timer, "requires setitimer")
+    def test_ring_buffer(self):
+        channel = stackless.channel()
+
+        def receiver():
+            channel.receive()
+        t = stackless.tasklet(receiver)()
+        stackless.run()
+        stackless.profiler.start(100000, 64)
+        stackless.profiler.stop()
+        stackless.profiler.clear()
+        for i in range(100):
+            stackless.profiler.sample([t])
+        stats = stackless.profiler.stats()
+        self.assertEqual(stats["capacity"], 64)
+        self.assertLessEqual(stats["used"], 64)
+        self.assertGreater(stats["dropped"], 0)
+        self.assertEqual(stats["samples"], 100 - stats["dropped"])
+        self.assertEqual(len(stackless.profiler.samples()), stats["samples"])
+        channel.send(None)
+
+
+if __name__ == '__main__':
+    if not sys.argv[1:]:
+        sys.argv.append('-v')
+    unittest.main()
@@ -0,0 +1,77 @@
+'Compare pymalloc arena sizes on a large heap.'
+
+# The script runs a child interpreter for each arena size.  The child builds
+# a heap of small objects and then visits them in random order, which makes
+# the dTLB a bottleneck.  For each arena size the script shows the time of
+# the random walk, the resident set size, the number of memory mappings and
+# the amount of memory backed by transparent huge pages.  If the perf tool
+# is available, it also shows the dTLB misses of the child.  On Linux,
+# transparent huge pages must be enabled in "madvise" or "always" mode, see
+# /sys/kernel/mm/transparent_hugepage/enabled.
+
+import os
+import shutil
+import subprocess
+import sys
+
+arena_sizes = ['256K', '2M', '8M', '32M']
+nobjects = 2000000
+
+child_code = r'''
+import random, sys, time
+
+def proc_value(path, key):
+    try:
+        with open(path) as f:
+            for line in f:
+                if line.startswith(key):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return -1
+
+n = int(sys.argv[1])
+heap = [(i, str(i)) for i in range(n)]
+order = list(range(n))
+random.Random(1).shuffle(order)
+t0 = time.perf_counter()
+for k in range(3):
+    total = 0
+    for i in order:
+        total += len(heap[i][1])
+t1 = time.perf_counter()
+with open('/proc/self/maps') as f:
+    nmaps = sum(1 for line in f)
+print(t1 - t0, proc_value('/proc/self/status', 'VmRSS:'), nmaps,
+      proc_value('/proc/self/smaps_rollup', 'AnonHugePages:'))
+'''
+
+def run(arena_size, perf):
+    cmd = [sys.executable, '-X', 'arena_size=' + arena_size,
+           '-c', child_code, str(nobjects)]
+    if perf:
+        cmd = [perf, 'stat', '-x,', '-e', 'dTLB-load-misses'] + cmd
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                          universal_newlines=True, check=True)
+    walk, rss, nmaps, huge = proc.stdout.split()
+    misses = None
+    for line in proc.stderr.splitlines():
+        fields = line.split(',')
+        if len(fields) > 2 and fields[2].startswith('dTLB-load-misses'):
+            if fields[0].isdigit():
+                misses = int(fields[0])
+    return float(walk), int(rss), int(nmaps), int(huge), misses
+
+
+if __name__=='__main__':
+
+    if not os.path.exists('/proc/self/maps'):
+        sys.exit('this script requires the Linux /proc file system')
+    perf = shutil.which('perf')
+    print('arena size   walk (s)    RSS (MiB)   mappings   huge (MiB)'
+          '   dTLB load misses')
+    for arena_size in arena_sizes:
+        walk, rss, nmaps, huge, misses = run(arena_size, perf)
+        print('{:>10}   {:8.3f}   {:10.1f}   {:8}   {:10.1f}   {:>16}'.format(
+            arena_size, walk, rss / 1024, nmaps, max(huge, 0) / 1024,
+            'n/a' if misses is None else '{:,}'.format(misses)))
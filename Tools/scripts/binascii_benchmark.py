@@ -0,0 +1,44 @@
+'Measure the throughput of the hex, base64 and CRC functions of binascii.'
+
+# For each size the script encodes and decodes random data with hex and
+# base64 and computes its CRC-32 and CRC-CCITT, like a server which dumps
+# and checks the payloads of a wire protocol.  The numbers are GB/s of
+# binary data, best of many runs.
+
+import binascii
+import random
+import time
+
+sizes = [64, 1024, 65536, 4 * 1024 * 1024]
+total = 64 * 1024 * 1024
+repeat = 5
+
+def measure(func, arg, size):
+    loops = max(1, total // 8 // size)
+    best = float('inf')
+    for i in range(repeat):
+        t0 = time.perf_counter()
+        for j in range(loops):
+            func(arg)
+        best = min(best, time.perf_counter() - t0)
+    return size * loops / best / 1e9
+
+def run(size):
+    data = random.Random(size).getrandbits(8 * size).to_bytes(size, 'little')
+    hexdata = data.hex()
+    b64data = binascii.b2a_base64(data)
+    return (measure(bytes.hex, data, size),
+            measure(binascii.unhexlify, hexdata, size),
+            measure(binascii.b2a_base64, data, size),
+            measure(binascii.a2b_base64, b64data, size),
+            measure(binascii.crc32, data, size),
+            measure(lambda data: binascii.crc_hqx(data, 0), data, size))
+
+
+if __name__=='__main__':
+
+    print('     size   bytes.hex  unhexlify  b2a_base64 a2b_base64'
+          '   crc32    crc_hqx')
+    for size in sizes:
+        print('{:>9}  '.format(size) +
+              ' '.join('{:10.2f}'.format(x) for x in run(size)))
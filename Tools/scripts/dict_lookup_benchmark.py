@@ -0,0 +1,59 @@
+'Measure the lookup throughput of dicts and sets across table sizes.'
+
+# For each size the script builds a dict and a set of str keys, a dict of
+# int keys and a FrozenDict with the items of the str dict.  It measures
+# successful lookups of keys that are equal to, but not identical with the
+# stored keys, like keys read from a file or a socket, and failed lookups.
+# The keys are visited in random order, so that large tables are not in the
+# cache.  The numbers are millions of lookups per second.  The last columns
+# are the sizes of the str dict and the FrozenDict reported by
+# sys.getsizeof(), in bytes per item.
+
+import random
+import sys
+import time
+from types import FrozenDict
+
+sizes = [1000, 5000, 10000, 100000, 1000000, 4000000]
+nlookups = 2000000
+
+def measure(container, keys):
+    t0 = time.perf_counter()
+    for key in keys:
+        key in container
+    return len(keys) / (time.perf_counter() - t0) / 1e6
+
+def run(size):
+    rand = random.Random(size)
+    strs = ['/route/%d/%x' % (i, rand.getrandbits(32)) for i in range(size)]
+    ints = [rand.getrandbits(48) for i in range(size)]
+    str_dict = dict.fromkeys(strs)
+    str_set = set(strs)
+    int_dict = dict.fromkeys(ints)
+    frozen = FrozenDict(str_dict)
+
+    # copies of the keys, to defeat the identity check
+    n = min(nlookups, 10 * size)
+    hits = [''.join(s) for s in rand.choices(strs, k=n)]
+    misses = [s + '?' for s in hits]
+    int_hits = [i + 0 for i in rand.choices(ints, k=n)]
+    int_misses = [i + (1 << 48) for i in int_hits]
+    for key in hits + misses:
+        hash(key)
+    return (measure(str_dict, hits), measure(str_dict, misses),
+            measure(str_set, hits), measure(str_set, misses),
+            measure(int_dict, int_hits), measure(int_dict, int_misses),
+            measure(frozen, hits), measure(frozen, misses),
+            sys.getsizeof(str_dict) / size, sys.getsizeof(frozen) / size)
+
+
+if __name__=='__main__':
+
+    print('     size      str dict        str set       int dict'
+          '      FrozenDict    bytes/item')
+    print('             hit   miss     hit   miss     hit   miss'
+          '     hit   miss    dict Frozen')
+    for size in sizes:
+        print('{:>9}  '.format(size) +
+              '  '.join('{:6.1f} {:6.1f}'.format(*pair)
+                        for pair in zip(*[iter(run(size))] * 2)))
@@ -0,0 +1,49 @@
+'Measure repr() of floats and json.dumps() of lists of floats.'
+
+# For each kind of data the script formats 10000 floats with repr() and
+# dumps them as a JSON list, like a service sending measurements or prices.
+# The numbers are nanoseconds per float, best of many runs.
+
+import json
+import random
+import struct
+import time
+
+nfloats = 10000
+repeat = 50
+
+def measure(func):
+    best = float('inf')
+    for i in range(repeat):
+        t0 = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - t0)
+    return best / nfloats * 1e9
+
+def random_bits(rand):
+    while True:
+        x = struct.unpack('<d', struct.pack('<Q', rand.getrandbits(63)))[0]
+        if x == x and x != float('inf'):
+            return x
+
+kinds = [
+    ('random()', lambda rand: rand.random()),
+    ('prices', lambda rand: rand.randrange(100000) / 100),
+    ('integral', lambda rand: float(rand.randrange(10 ** 9))),
+    ('wide range', lambda rand: rand.random() * 10 ** rand.randrange(-30, 30)),
+    ('random bits', random_bits),
+]
+
+def run(make):
+    rand = random.Random(12345)
+    data = [make(rand) for i in range(nfloats)]
+    return (measure(lambda: list(map(repr, data))),
+            measure(lambda: json.dumps(data)))
+
+
+if __name__=='__main__':
+
+    print('kind              repr  json.dumps')
+    for name, make in kinds:
+        print('{:<12}  '.format(name) +
+              ' '.join('{:8.1f}'.format(x) for x in run(make)))
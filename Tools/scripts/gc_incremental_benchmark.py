@@ -0,0 +1,68 @@
+'Measure the pauses of automatic collections on a large heap.'
+
+# The script runs a child interpreter for each time budget of the
+# incremental collection.  The child builds a large heap of long lived
+# objects and then runs a workload, that keeps a ring of recently created
+# objects with reference cycles.  The objects of the ring survive into the
+# oldest generation and become garbage later.  A gc callback measures the
+# pause of each collection of the oldest generation.
+# For each budget the script shows the total run time, the number and the
+# longest and the 99th percentile pauses of collections of the oldest
+# generation and the slice counters of gc.get_stats().
+
+import subprocess
+import sys
+
+budgets = [0, 0.5, 2, 10]
+nobjects = 1000000
+
+child_code = r'''
+import gc, sys, time
+
+gc.set_incremental(float(sys.argv[1]))
+heap = [{'i': i, 'l': [i]} for i in range(int(sys.argv[2]))]
+pauses = []
+def callback(phase, info, start=[0]):
+    if info['generation'] == 2:
+        if phase == 'start':
+            start[0] = time.perf_counter()
+        else:
+            pauses.append(time.perf_counter() - start[0])
+gc.callbacks.append(callback)
+
+class Node:
+    pass
+
+t0 = time.perf_counter()
+ring = [None] * 100000
+for i in range(3000000):
+    n = Node()
+    n.self = n
+    ring[i % len(ring)] = n
+t1 = time.perf_counter()
+gc.callbacks.remove(callback)
+pauses.sort()
+st = gc.get_stats()[2]
+print(t1 - t0, len(pauses), pauses[-1] if pauses else 0,
+      pauses[len(pauses) * 99 // 100] if pauses else 0,
+      st['slices'], st['rounds'], st['fallbacks'])
+'''
+
+def run(budget):
+    cmd = [sys.executable, '-c', child_code, str(budget), str(nobjects)]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE,
+                          universal_newlines=True, check=True)
+    total, n, longest, p99, slices, rounds, fallbacks = proc.stdout.split()
+    return (float(total), int(n), float(longest), float(p99), int(slices),
+            int(rounds), int(fallbacks))
+
+
+if __name__=='__main__':
+
+    print('budget (ms)   total (s)   pauses   max (ms)   p99 (ms)'
+          '   slices   rounds   fallbacks')
+    for budget in budgets:
+        total, n, longest, p99, slices, rounds, fallbacks = run(budget)
+        print('{:>11}   {:9.3f}   {:6}   {:8.2f}   {:8.2f}   {:6}   {:6}'
+              '   {:9}'.format(budget, total, n, longest * 1e3, p99 * 1e3,
+                               slices, rounds, fallbacks))
@@ -0,0 +1,56 @@
+'Time collections of the youngest generation on a JSON workload.'
+
+# The script decodes many small JSON documents and keeps them alive in
+# batches, as a service with a request cache would do.  Values of
+# the documents are tuples, which gets the dicts tracked.  A gc callback
+# measures the time of the collections of the youngest generation.  The
+# script shows the total run time, the time spent in collections of the
+# youngest generation and the untracked and kept counters of
+# gc.get_stats().  Run this script with an interpreter with and without
+# untracking in the youngest generation to compare the timings.
+
+import gc
+import json
+import time
+
+documents = 500000
+batch_size = 100000
+
+document = json.dumps({'id': 1, 'name': 'name', 'tags': ['a', 'b', 'c'],
+                       'point': [1.5, 2.5], 'flags': {'x': True, 'y': False}})
+
+def pairs_hook(pairs):
+    return {k: tuple(v) if isinstance(v, list) else v for k, v in pairs}
+
+def run():
+    times = []
+    def callback(phase, info, start=[0]):
+        if info['generation'] == 0:
+            if phase == 'start':
+                start[0] = time.perf_counter()
+            else:
+                times.append(time.perf_counter() - start[0])
+    gc.callbacks.append(callback)
+    batch = []
+    t0 = time.perf_counter()
+    for i in range(documents):
+        if len(batch) == batch_size:
+            batch = []
+        batch.append(json.loads(document, object_pairs_hook=pairs_hook))
+    t1 = time.perf_counter()
+    gc.callbacks.remove(callback)
+    return t1 - t0, len(times), sum(times)
+
+
+if __name__=='__main__':
+
+    gc.collect()
+    old = gc.get_stats()[0]
+    total, n, gen0 = run()
+    new = gc.get_stats()[0]
+    print('total time          {:8.3f} s'.format(total))
+    print('gen0 collections    {:8}'.format(n))
+    print('gen0 time           {:8.3f} s ({:.1f}%)'.format(
+        gen0, 100 * gen0 / total))
+    for key in 'untracked', 'kept':
+        print('{:20}{:8}'.format(key, new.get(key, 0) - old.get(key, 0)))
@@ -0,0 +1,53 @@
+'Measure the memory and the attribute access time of small instances.'
+
+# Instances of Python classes keep their attributes inline, until the
+# __dict__ attribute is used.  The script creates many small instances and
+# shows the memory used per instance, measured with tracemalloc, and the
+# time of attribute loads and stores.  The second row shows the same
+# numbers, after the __dict__ of each instance has been created.  Run this
+# script with an interpreter with and without inline values to compare.
+
+import time
+import tracemalloc
+
+ninstances = 1000000
+
+class Point:
+    def __init__(self, x, y, z):
+        self.x = x
+        self.y = y
+        self.z = z
+
+def load(points):
+    t0 = time.perf_counter()
+    for i in range(5):
+        for p in points:
+            p.x; p.y; p.z
+    return (time.perf_counter() - t0) / (15 * len(points))
+
+def store(points):
+    t0 = time.perf_counter()
+    for i in range(5):
+        for p in points:
+            p.x = p.y = p.z = i
+    return (time.perf_counter() - t0) / (15 * len(points))
+
+def run():
+    tracemalloc.start()
+    before = tracemalloc.get_traced_memory()[0]
+    points = [Point(i, i, i) for i in range(ninstances)]
+    size = (tracemalloc.get_traced_memory()[0] - before) / ninstances
+    yield 'inline', size, load(points), store(points)
+
+    for p in points:
+        p.__dict__
+    size = (tracemalloc.get_traced_memory()[0] - before) / ninstances
+    tracemalloc.stop()
+    yield '__dict__', size, load(points), store(points)
+
+if __name__=='__main__':
+
+    print('layout     bytes per instance   load (ns)   store (ns)')
+    for layout, size, load_time, store_time in run():
+        print('{:8}   {:18.1f}   {:9.1f}   {:10.1f}'.format(
+            layout, size, load_time * 1e9, store_time * 1e9))
@@ -0,0 +1,46 @@
+'Measure the multiplication and division of large ints across sizes.'
+
+# For each number of bits the script measures the product of two random
+# ints, the square of one, the division of an int with twice the bits by
+# one of the size, and a modular multiplication, as done by pow(a, b, m).
+# The numbers are the times of one operation in microseconds.
+
+import random
+import time
+
+sizes = [10000, 30000, 100000, 300000, 1000000]
+
+def measure(func, *args):
+    n = 0
+    t0 = time.perf_counter()
+    while True:
+        func(*args)
+        n += 1
+        t = time.perf_counter() - t0
+        if t > 0.2:
+            return t / n * 1e6
+
+def mul(a, b):
+    a * b
+
+def square(a):
+    a * a
+
+def modmul(a, b, m):
+    a * b % m
+
+def run(bits):
+    rand = random.Random(bits)
+    a = rand.getrandbits(bits) | 1 << (bits - 1)
+    b = rand.getrandbits(bits) | 1 << (bits - 1)
+    m = rand.getrandbits(bits) | 1 << (bits - 1)
+    return (measure(mul, a, b), measure(square, a),
+            measure(divmod, a * b + m, m), measure(modmul, a, b, m))
+
+
+if __name__=='__main__':
+
+    print('     bits         a*b         a*a      divmod   a*b % m')
+    for bits in sizes:
+        print('{:>9} '.format(bits) +
+              ' '.join('{:>11.1f}'.format(t) for t in run(bits)))
@@ -0,0 +1,34 @@
+'Measure the conversions between ints and decimal strings across sizes.'
+
+# For each number of decimal digits the script converts a random int to a
+# string with str() and the string back with int().  The numbers are the
+# times of one conversion in milliseconds.
+
+import random
+import time
+
+sizes = [100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000]
+
+def measure(func, arg):
+    n = 0
+    t0 = time.perf_counter()
+    while True:
+        func(arg)
+        n += 1
+        t = time.perf_counter() - t0
+        if t > 0.2:
+            return t / n * 1e3
+
+def run(size):
+    rand = random.Random(size)
+    s = str(rand.randrange(1, 10)) + ''.join(
+        rand.choice('0123456789') for i in range(size - 1))
+    x = int(s)
+    return measure(str, x), measure(int, s)
+
+
+if __name__=='__main__':
+
+    print('   digits      int->str     str->int')
+    for size in sizes:
+        print('{:>9}  {:>12.3f} {:>12.3f}'.format(size, *run(size)))
@@ -0,0 +1,60 @@
+'Time small object allocation in several threads at once.'
+
+# pymalloc gives every thread its own cache of partially used pools.  The
+# threads below allocate and free many small objects while the GIL switches
+# between them.  Run this script with an interpreter with and without thread
+# pool caches to compare the timings.  The second part of the output are the
+# thread pool cache counters of sys._debugmallocstats().
+
+import sys
+import threading
+import time
+
+objects_per_round = 2000
+rounds = 100
+
+def churn(rounds=rounds):
+    keep = []
+    for r in range(rounds):
+        l = [(i, str(i)) for i in range(objects_per_round)]
+        d = {i: [i] for i in range(0, objects_per_round, 4)}
+        keep.append(l[::50])
+        del l, d
+    return keep
+
+def run(nthreads):
+    threads = [threading.Thread(target=churn) for i in range(nthreads)]
+    t0 = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return time.perf_counter() - t0
+
+def print_cache_counters():
+    import io, os, tempfile
+    # _debugmallocstats() writes to the C level stderr
+    with tempfile.TemporaryFile() as f:
+        sys.stderr.flush()
+        saved = os.dup(2)
+        os.dup2(f.fileno(), 2)
+        try:
+            sys._debugmallocstats()
+        finally:
+            os.dup2(saved, 2)
+            os.close(saved)
+        f.seek(0)
+        for line in io.TextIOWrapper(f, 'ascii'):
+            if 'thread pool' in line or 'shared lists' in line:
+                print(line.rstrip())
+
+
+if __name__=='__main__':
+
+    sys.setswitchinterval(0.0005)
+    for nthreads in 1, 2, 4, 8:
+        timing = min(run(nthreads) for i in range(3))
+        timing *= 1e9 / (nthreads * rounds * objects_per_round)
+        print('{:6.1f} ns per object\t{} threads'.format(timing, nthreads))
+    print()
+    print_cache_counters()
@@ -0,0 +1,88 @@
+'Show the speed and the dispatch reduction of superinstructions.'
+
+# The interpreter fuses the instruction pairs LOAD_FAST/LOAD_FAST,
+# LOAD_FAST/LOAD_ATTR, STORE_FAST/LOAD_FAST and COMPARE_OP/POP_JUMP_IF_FALSE
+# into superinstructions.  Each executed superinstruction saves one dispatch
+# through the jump table.  Run this script with an interpreter with and
+# without superinstructions to compare the timings.  If the interpreter
+# provides sys._opcode_profile(), the script also shows the fraction of
+# instructions that were executed as part of a superinstruction.
+
+import sys
+
+trials = [None] * 500
+steps_per_trial = 10
+
+class Point(object):
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+def local_arithmetic(trials=trials):
+    a = 1
+    b = 2
+    for t in trials:
+        c = a + b; d = c - a; c = d + b; d = c - b; c = a + d
+        c = a + b; d = c - a; c = d + b; d = c - b; c = a + d
+
+def attribute_read(trials=trials, p=Point(1, 2)):
+    for t in trials:
+        p.x; p.y; p.x; p.y; p.x
+        p.x; p.y; p.x; p.y; p.x
+
+def compare_branch(trials=trials):
+    a = 1
+    b = 2
+    n = 0
+    for t in trials:
+        if a < b: n = n
+        if a > b: n = n
+        if a < b: n = n
+        if a > b: n = n
+        if a < b: n = n
+        if a < b: n = n
+        if a > b: n = n
+        if a < b: n = n
+        if a > b: n = n
+        if a < b: n = n
+
+def swap(trials=trials):
+    a = 1
+    b = 2
+    for t in trials:
+        a, b = b, a; a, b = b, a; a, b = b, a; a, b = b, a; a, b = b, a
+        a, b = b, a; a, b = b, a; a, b = b, a; a, b = b, a; a, b = b, a
+
+def loop_overhead(trials=trials):
+    for t in trials:
+        pass
+
+SUPERINSTRUCTIONS = ('LOAD_FAST_LOAD_FAST', 'LOAD_FAST_LOAD_ATTR',
+                     'STORE_FAST_LOAD_FAST', 'COMPARE_AND_BRANCH')
+
+def fused_fraction(f):
+    import opcode
+    f()  # the first call quickens the code object
+    sys._opcode_profile(True)
+    f()
+    counts = sys._opcode_profile(False)['code'].get(f.__code__, {})
+    total = sum(counts.values())
+    fused = sum(counts.get(opcode.opmap[name], 0)
+                for name in SUPERINSTRUCTIONS if name in opcode.opmap)
+    return fused / total if total else 0.0
+
+
+if __name__=='__main__':
+
+    from timeit import Timer
+
+    profile = hasattr(sys, '_opcode_profile')
+    for f in [local_arithmetic, attribute_read, compare_branch, swap,
+              loop_overhead]:
+        timing = min(Timer(f).repeat(7, 1000))
+        timing *= 1000000 / (len(trials) * steps_per_trial)
+        if profile:
+            print('{:6.1f} ns\t{:5.1%} dispatches saved\t{}'.format(
+                timing, fused_fraction(f), f.__name__))
+        else:
+            print('{:6.1f} ns\t{}'.format(timing, f.__name__))
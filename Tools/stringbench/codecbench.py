@@ -0,0 +1,48 @@
+'Measure the throughput of the UTF-8 codec on texts of different scripts.'
+
+# Each text is built from a sample sentence, repeated to the given size in
+# characters.  The script decodes the UTF-8 encoded text and encodes it
+# again and reports the best throughput in MB of UTF-8 per second.  The
+# decoded strings have different kinds: ASCII, Latin-1 (UCS1), Cyrillic and
+# CJK (UCS2), emoji (UCS4).
+
+import sys
+import timeit
+
+SAMPLES = [
+    ('ascii', 'The quick brown fox jumps over the lazy dog. '),
+    ('latin-1', 'Le cœur déçu mais l\'âme plutôt naïve, Louÿs rêva de crapaüter. '
+                .replace('œ', 'oe')),
+    ('cyrillic', 'Съешь же ещё этих мягких французских булок, да выпей чаю. '),
+    ('cjk', '我能吞下玻璃而不伤身体。私はガラスを食べられます。それは私を傷つけません。'),
+    ('emoji', '😀 👍 🎉 🚀 🐍 ❤️ 😂 🙈 '),
+    ('mixed', 'id=42 name="Ünïcödé 名前" tags=[🐍, "Москва"] '),
+]
+SIZES = [100, 10000, 1000000]
+REPEAT = 5
+
+def text(sample, size):
+    return (sample * (size // len(sample) + 1))[:size]
+
+def throughput(stmt, data, nbytes):
+    timer = timeit.Timer(stmt, globals={'data': data})
+    number, _ = timer.autorange()
+    best = min(timer.repeat(REPEAT, number)) / number
+    return nbytes / best / 1e6
+
+
+if __name__ == '__main__':
+
+    print(sys.version)
+    print('                     decode (MB/s)         encode (MB/s)')
+    print('text       ' + ''.join('{:>10}'.format(size) for size in SIZES * 2))
+    for name, sample in SAMPLES:
+        decode = []
+        encode = []
+        for size in SIZES:
+            s = text(sample, size)
+            b = s.encode('utf-8')
+            decode.append(throughput("data.decode('utf-8')", b, len(b)))
+            encode.append(throughput("data.encode('utf-8')", s, len(b)))
+        print('{:<11}'.format(name) +
+              ''.join('{:10.0f}'.format(x) for x in decode + encode))
@@ -1081,6 +1081,78 @@ def count_aact(STR):
     for x in _RANGE_10:
         seq_count(needle)
 
+#### Search, count, replace and split long texts
+
+# The text is long enough that most of the time goes to finding the
+# candidates for a match.
+_long_text = human_text * 16 + "Python 3.9 is here\n"
+_long_text_bytes = bytes_from_str(_long_text)
+_long_text_unicode = unicode_from_str(_long_text)
+def _get_long_text(STR):
+    if STR is UNICODE:
+        return _long_text_unicode
+    if STR is BYTES:
+        return _long_text_bytes
+    raise AssertionError
+
+@bench('long_text.find("Python 3.9")', "late match, long text", 10)
+def find_test_late_match_long_text(STR):
+    s = _get_long_text(STR)
+    s_find = s.find
+    pat = STR("Python 3.9")
+    for x in _RANGE_10:
+        s_find(pat)
+
+@bench('long_text.find("Python 2.7")', "no match, long text", 10)
+def find_test_no_match_long_text(STR):
+    s = _get_long_text(STR)
+    s_find = s.find
+    pat = STR("Python 2.7")
+    for x in _RANGE_10:
+        s_find(pat)
+
+@bench('long_text.rfind("Python 2.7")', "no match, long text", 10)
+def rfind_test_no_match_long_text(STR):
+    s = _get_long_text(STR)
+    s_rfind = s.rfind
+    pat = STR("Python 2.7")
+    for x in _RANGE_10:
+        s_rfind(pat)
+
+@bench('long_text.count("language")', "count substrings, long text", 10)
+def count_test_long_text(STR):
+    s = _get_long_text(STR)
+    s_count = s.count
+    pat = STR("language")
+    for x in _RANGE_10:
+        s_count(pat)
+
+@bench('long_text.replace("language", "idiom")',
+       "replace substrings, long text", 10)
+def replace_test_long_text(STR):
+    s = _get_long_text(STR)
+    s_replace = s.replace
+    from_str = STR("language")
+    to_str = STR("idiom")
+    for x in _RANGE_10:
+        s_replace(from_str, to_str)
+
+@bench('long_text.split("Python")', "split on word, long text", 10)
+def split_test_long_text(STR):
+    s = _get_long_text(STR)
+    s_split = s.split
+    pat = STR("Python")
+    for x in _RANGE_10:
+        s_split(pat)
+
+@bench('long_text.partition("Python 3.9")', "late match, long text", 10)
+def partition_test_late_match_long_text(STR):
+    s = _get_long_text(STR)
+    s_partition = s.partition
+    pat = STR("Python 3.9")
+    for x in _RANGE_10:
+        s_partition(pat)
+
 ##### startswith and endswith
 
 @bench('"Andrew".startswith("A")', 'startswith single character', 1000)